@@ -0,0 +1,478 @@
+/**
+ * EpdSim.cpp - E-Paper 控制器模拟实现
+ *
+ * 地址计数器的回绕规则与 SSD1680 数据手册一致：到达窗口终点后回到起点并进位。
+ * BUSY 时长由主机加载的LUT计算：每组 (TPA+TPB)*(SRAB+1)+(TPC+TPD)*(SRCD+1) 帧，
+ * 再乘以 (RP+1) 次重复，帧率按50Hz近似；使用OTP波形时取典型值
+ */
+
+#include "EpdSim.h"
+#include "HalHost.h"
+#include "epdif.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LUT_GROUP_OFFSET  60
+#define LUT_GROUP_COUNT   12
+#define LUT_GROUP_BYTES   7
+
+// 0x22 显示更新序列的位
+#define UPDATE_LOAD_LUT     0x10
+#define UPDATE_MODE_2       0x08
+#define UPDATE_DISPLAY      0x04
+#define UPDATE_POR_DEFAULT  0xFF
+
+// ==================== 控制器状态 ====================
+static uint8_t ram[EPD_SIM_PLANE_COUNT][EPD_SIM_PLANE_BYTES];
+
+static uint8_t command = 0;
+static uint8_t paramIndex = 0;
+static int writePlane = -1;          // 当前 0x24/0x26 写入的平面，-1 表示不在写RAM
+
+static uint8_t entryMode;
+static uint8_t windowXStart, windowXEnd;     // 单位：字节（8像素）
+static uint16_t windowYStart, windowYEnd;
+static uint8_t counterX;
+static uint16_t counterY;
+
+static uint8_t lut[EPD_SIM_LUT_BYTES];
+static bool lutLoaded;
+static uint8_t updateSequence;
+static bool updateSequenceSet;
+
+static uint32_t busyUntilUs = 0;
+static bool asleep = false;
+static uint8_t resetLevel = HIGH;
+
+// ==================== 帧统计 ====================
+static EpdSimFrame history[EPD_SIM_FRAME_HISTORY];
+static EpdSimFrame pending;
+static EpdSimStats stats;
+
+// SWRESET 或硬件复位后寄存器回到上电值，RAM 内容保持不变
+static void resetRegisters() {
+  entryMode = 0x03;
+  windowXStart = 0;
+  windowXEnd = EPD_SIM_ROW_BYTES - 1;
+  windowYStart = 0;
+  windowYEnd = EPD_SIM_HEIGHT - 1;
+  counterX = 0;
+  counterY = 0;
+  writePlane = -1;
+  lutLoaded = false;
+  updateSequence = UPDATE_POR_DEFAULT;
+  updateSequenceSet = false;
+}
+
+static void flagMisuse(uint8_t flag) {
+  pending.misuse |= flag;
+  stats.misuse |= flag;
+  stats.misuseCount++;
+}
+
+static void startBusy(uint32_t us) {
+  busyUntilUs = halMicros() + us;
+  pending.busyUs += us;
+  stats.busyUs += us;
+}
+
+// ==================== 时序模型 ====================
+static uint32_t lutFrames() {
+  uint32_t frames = 0;
+  for (int group = 0; group < LUT_GROUP_COUNT; group++) {
+    const uint8_t* g = &lut[LUT_GROUP_OFFSET + group * LUT_GROUP_BYTES];
+    uint32_t groupFrames = (uint32_t)(g[0] + g[1]) * (g[2] + 1) + (uint32_t)(g[3] + g[4]) * (g[5] + 1);
+    frames += groupFrames * (g[6] + 1);
+  }
+  return frames;
+}
+
+uint32_t epdSimWaveformUs(bool partial) {
+  if (lutLoaded && !(updateSequence & UPDATE_LOAD_LUT)) {
+    return lutFrames() * EPD_SIM_LUT_FRAME_US;
+  }
+  return partial ? EPD_SIM_OTP_PARTIAL_US : EPD_SIM_OTP_FULL_US;
+}
+
+static void activate() {
+  if (!updateSequenceSet) {
+    flagMisuse(EPD_SIM_MISUSE_NO_UPDATE_SEQUENCE);
+  }
+  if (!(updateSequence & UPDATE_DISPLAY)) {
+    startBusy(EPD_SIM_POWER_SEQUENCE_US);
+    return;
+  }
+
+  // 显示刷新结束一帧：面板画面来自 0x24 RAM
+  bool partial = (updateSequence & UPDATE_MODE_2) != 0;
+  startBusy(epdSimWaveformUs(partial));
+  memcpy(ram[EPD_SIM_PANEL], ram[EPD_SIM_PLANE_BW], EPD_SIM_PLANE_BYTES);
+
+  pending.startUs = halMicros();
+  pending.updateSequence = updateSequence;
+  pending.partial = partial;
+  history[stats.frames % EPD_SIM_FRAME_HISTORY] = pending;
+  stats.frames++;
+  if (partial) {
+    stats.partialRefreshes++;
+  } else {
+    stats.fullRefreshes++;
+  }
+  memset(&pending, 0, sizeof(pending));
+}
+
+// ==================== 地址计数器 ====================
+static void advanceX(bool& carry) {
+  carry = false;
+  if (counterX == windowXEnd) {
+    counterX = windowXStart;
+    carry = true;
+  } else {
+    counterX += (entryMode & 0x01) ? 1 : -1;
+  }
+}
+
+static void advanceY(bool& carry) {
+  carry = false;
+  if (counterY == windowYEnd) {
+    counterY = windowYStart;
+    carry = true;
+  } else {
+    counterY += (entryMode & 0x02) ? 1 : -1;
+  }
+}
+
+// 数据输入模式 bit2=0：先沿X方向，X回绕后Y前进一行
+static void advanceCounter() {
+  bool carry;
+  if ((entryMode & 0x04) == 0) {
+    advanceX(carry);
+    if (carry) {
+      advanceY(carry);
+    }
+  } else {
+    advanceY(carry);
+    if (carry) {
+      advanceX(carry);
+    }
+  }
+}
+
+static void writeRam(uint8_t data) {
+  if (counterX < EPD_SIM_ROW_BYTES && counterY < EPD_SIM_HEIGHT) {
+    ram[writePlane][counterY * EPD_SIM_ROW_BYTES + counterX] = data;
+  } else {
+    flagMisuse(EPD_SIM_MISUSE_RAM_OUT_OF_RANGE);
+  }
+  pending.ramBytes++;
+  advanceCounter();
+}
+
+// ==================== 命令解码 ====================
+static void handleCommand(uint8_t cmd) {
+  if (command == 0x32 && paramIndex != EPD_SIM_LUT_BYTES) {
+    flagMisuse(EPD_SIM_MISUSE_LUT_LENGTH);
+  }
+  command = cmd;
+  paramIndex = 0;
+  writePlane = -1;
+  pending.commands++;
+
+  switch (cmd) {
+    case 0x12:
+      resetRegisters();
+      startBusy(EPD_SIM_SWRESET_US);
+      break;
+    case 0x20:
+      activate();
+      break;
+    case 0x24:
+      writePlane = EPD_SIM_PLANE_BW;
+      break;
+    case 0x26:
+      writePlane = EPD_SIM_PLANE_RED;
+      break;
+    case 0x32:
+      lutLoaded = false;
+      break;
+    default:
+      break;
+  }
+}
+
+static void handleData(uint8_t data) {
+  if (writePlane >= 0) {
+    writeRam(data);
+    return;
+  }
+
+  switch (command) {
+    case 0x10:
+      if (paramIndex == 0 && (data & 0x03) != 0) {
+        asleep = true;
+      }
+      break;
+    case 0x11:
+      if (paramIndex == 0) {
+        entryMode = data & 0x07;
+      }
+      break;
+    case 0x22:
+      if (paramIndex == 0) {
+        updateSequence = data;
+        updateSequenceSet = true;
+      }
+      break;
+    case 0x32:
+      if (paramIndex < EPD_SIM_LUT_BYTES) {
+        lut[paramIndex] = data;
+        lutLoaded = paramIndex == EPD_SIM_LUT_BYTES - 1;
+      }
+      break;
+    case 0x44:
+      if (paramIndex == 0) {
+        windowXStart = data & 0x3F;
+      } else if (paramIndex == 1) {
+        windowXEnd = data & 0x3F;
+      }
+      break;
+    case 0x45:
+      if (paramIndex == 0) {
+        windowYStart = (windowYStart & 0x100) | data;
+      } else if (paramIndex == 1) {
+        windowYStart = (windowYStart & 0xFF) | ((data & 0x01) << 8);
+      } else if (paramIndex == 2) {
+        windowYEnd = (windowYEnd & 0x100) | data;
+      } else if (paramIndex == 3) {
+        windowYEnd = (windowYEnd & 0xFF) | ((data & 0x01) << 8);
+      }
+      break;
+    case 0x4E:
+      if (paramIndex == 0) {
+        counterX = data & 0x3F;
+      }
+      break;
+    case 0x4F:
+      if (paramIndex == 0) {
+        counterY = (counterY & 0x100) | data;
+      } else if (paramIndex == 1) {
+        counterY = (counterY & 0xFF) | ((data & 0x01) << 8);
+      }
+      break;
+    default:
+      break;   // 其余命令（电压、边框、显示控制）的参数不影响RAM和时序
+  }
+  if (paramIndex < 0xFF) {
+    paramIndex++;
+  }
+}
+
+static void epdSimSpiSink(uint8_t data) {
+  // CS 为高时控制器不接收
+  if (halHostGetPin(CS_PIN) != LOW) {
+    return;
+  }
+  pending.spiBytes++;
+  stats.spiBytes++;
+
+  // 睡眠和刷新期间控制器不处理接口数据，字节丢失
+  if (asleep) {
+    flagMisuse(EPD_SIM_MISUSE_WRITE_WHILE_ASLEEP);
+    return;
+  }
+  if (epdSimBusy()) {
+    flagMisuse(EPD_SIM_MISUSE_WRITE_WHILE_BUSY);
+    return;
+  }
+
+  if (halHostGetPin(DC_PIN) == LOW) {
+    handleCommand(data);
+  } else {
+    handleData(data);
+  }
+}
+
+// ==================== BUSY 与 RST 引脚 ====================
+static int epdSimPinSource(uint8_t pin) {
+  if (pin == BUSY_PIN) {
+    return epdSimBusy() ? HIGH : LOW;
+  }
+  return -1;
+}
+
+// RST 低电平脉冲结束时硬件复位：退出深度睡眠，寄存器回到上电值
+static void epdSimPinWatcher(uint8_t pin, uint8_t level) {
+  if (pin != RST_PIN) {
+    return;
+  }
+  if (resetLevel == LOW && level == HIGH) {
+    asleep = false;
+    command = 0;
+    paramIndex = 0;
+    resetRegisters();
+  }
+  resetLevel = level;
+}
+
+// ==================== 连接与复位 ====================
+void epdSimReset() {
+  memset(ram, 0xFF, sizeof(ram));
+  memset(lut, 0, sizeof(lut));
+  memset(history, 0, sizeof(history));
+  memset(&pending, 0, sizeof(pending));
+  memset(&stats, 0, sizeof(stats));
+  command = 0;
+  paramIndex = 0;
+  busyUntilUs = halMicros();
+  asleep = false;
+  resetLevel = HIGH;
+  resetRegisters();
+}
+
+void epdSimAttach() {
+  epdSimReset();
+  halHostSetSpiSink(epdSimSpiSink);
+  halHostSetPinSource(epdSimPinSource);
+  halHostSetPinWatcher(epdSimPinWatcher);
+}
+
+// ==================== RAM 读取 ====================
+const uint8_t* epdSimPlane(uint8_t plane) {
+  return plane < EPD_SIM_PLANE_COUNT ? ram[plane] : NULL;
+}
+
+bool epdSimPixelBlack(uint8_t plane, int x, int y) {
+  if (plane >= EPD_SIM_PLANE_COUNT || x < 0 || x >= EPD_SIM_WIDTH || y < 0 || y >= EPD_SIM_HEIGHT) {
+    return false;
+  }
+  return (ram[plane][y * EPD_SIM_ROW_BYTES + x / 8] & (0x80 >> (x % 8))) == 0;
+}
+
+uint32_t epdSimRefreshCount() {
+  return stats.frames;
+}
+
+// ==================== 时序与统计 ====================
+bool epdSimBusy() {
+  return (int32_t)(halMicros() - busyUntilUs) < 0;
+}
+
+bool epdSimAsleep() {
+  return asleep;
+}
+
+const EpdSimStats& epdSimStats() {
+  return stats;
+}
+
+uint32_t epdSimFrameCount() {
+  return stats.frames < EPD_SIM_FRAME_HISTORY ? stats.frames : EPD_SIM_FRAME_HISTORY;
+}
+
+const EpdSimFrame* epdSimFrame(uint32_t index) {
+  if (index >= epdSimFrameCount()) {
+    return NULL;
+  }
+  return &history[(stats.frames - 1 - index) % EPD_SIM_FRAME_HISTORY];
+}
+
+void epdSimPrintReport() {
+  printf("\n=== E-Paper 模拟统计 ===\n");
+  printf("刷新: %u (完整 %u / 局部 %u)  SPI: %u 字节  BUSY: %u ms\n",
+         stats.frames, stats.fullRefreshes, stats.partialRefreshes,
+         stats.spiBytes, stats.busyUs / 1000);
+
+  uint32_t count = epdSimFrameCount();
+  if (count > 0) {
+    printf("%10s %6s %8s %6s %8s %8s %6s\n", "时刻ms", "类型", "SPI字节", "命令", "RAM字节", "BUSYms", "误用");
+  }
+  for (uint32_t i = count; i-- > 0;) {
+    const EpdSimFrame* frame = epdSimFrame(i);
+    printf("%10u %6s %8u %6u %8u %8u   0x%02X\n",
+           frame->startUs / 1000, frame->partial ? "局部" : "完整",
+           frame->spiBytes, frame->commands, frame->ramBytes,
+           frame->busyUs / 1000, frame->misuse);
+  }
+
+  if (stats.misuseCount > 0) {
+    printf("⚠ 协议误用 %u 次，标志 0x%02X\n", stats.misuseCount, stats.misuse);
+  } else {
+    printf("✓ 未发现协议误用\n");
+  }
+  printf("========================\n");
+}
+
+// ==================== 图像 ====================
+bool epdSimWritePbm(uint8_t plane, const char* path) {
+  if (plane >= EPD_SIM_PLANE_COUNT) {
+    return false;
+  }
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+
+  fprintf(file, "P4\n%d %d\n", EPD_SIM_WIDTH, EPD_SIM_HEIGHT);
+  uint8_t row[EPD_SIM_ROW_BYTES];
+  for (int y = 0; y < EPD_SIM_HEIGHT; y++) {
+    for (int i = 0; i < EPD_SIM_ROW_BYTES; i++) {
+      row[i] = ~ram[plane][y * EPD_SIM_ROW_BYTES + i];
+    }
+    fwrite(row, 1, sizeof(row), file);
+  }
+  return fclose(file) == 0;
+}
+
+// 跳过PBM头部的空白和 # 注释
+static int readPbmHeaderInt(FILE* file) {
+  int c = fgetc(file);
+  while (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#') {
+    if (c == '#') {
+      while (c != '\n' && c != EOF) {
+        c = fgetc(file);
+      }
+    }
+    c = fgetc(file);
+  }
+
+  int value = -1;
+  while (c >= '0' && c <= '9') {
+    value = (value < 0 ? 0 : value * 10) + (c - '0');
+    c = fgetc(file);
+  }
+  return value;   // 数字后的单个空白字符已被读掉
+}
+
+bool epdSimReadPbm(const char* path, uint8_t* plane) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+
+  bool ok = fgetc(file) == 'P' && fgetc(file) == '4' &&
+            readPbmHeaderInt(file) == EPD_SIM_WIDTH &&
+            readPbmHeaderInt(file) == EPD_SIM_HEIGHT &&
+            fread(plane, 1, EPD_SIM_PLANE_BYTES, file) == EPD_SIM_PLANE_BYTES;
+  fclose(file);
+
+  if (ok) {
+    for (int i = 0; i < EPD_SIM_PLANE_BYTES; i++) {
+      plane[i] = ~plane[i];
+    }
+  }
+  return ok;
+}
+
+long epdSimComparePbm(uint8_t plane, const char* path) {
+  static uint8_t expected[EPD_SIM_PLANE_BYTES];
+  if (plane >= EPD_SIM_PLANE_COUNT || !epdSimReadPbm(path, expected)) {
+    return -1;
+  }
+
+  long diff = 0;
+  for (int i = 0; i < EPD_SIM_PLANE_BYTES; i++) {
+    diff += __builtin_popcount((uint8_t)(expected[i] ^ ram[plane][i]));
+  }
+  return diff;
+}
@@ -0,0 +1,98 @@
+/**
+ * EpdSim.h - 主机端 E-Paper 控制器（SSD1680）模拟
+ *
+ * 挂在模拟SPI和GPIO上，按 DC 引脚区分命令/数据，解码 SSD1680 的窗口(0x44/0x45)、
+ * 地址计数器(0x4E/0x4F)、数据输入模式(0x11)、RAM 写入(0x24/0x26)、
+ * LUT(0x32) 和刷新激活(0x22/0x20)；两个 RAM 平面与控制器内部一致，
+ * 可导出为 PBM 图像或与参考图像逐像素比较
+ *
+ * 刷新期间 BUSY 引脚按波形时长保持高电平，每帧记录SPI字节数、BUSY时间和刷新类型，
+ * 驱动违反时序（BUSY期间发送、深度睡眠后未复位就发送等）时记录误用标志
+ */
+
+#ifndef EPD_SIM_H
+#define EPD_SIM_H
+
+#include <stdint.h>
+
+#define EPD_SIM_WIDTH        128
+#define EPD_SIM_HEIGHT       296
+#define EPD_SIM_ROW_BYTES    (EPD_SIM_WIDTH / 8)
+#define EPD_SIM_PLANE_BYTES  (EPD_SIM_ROW_BYTES * EPD_SIM_HEIGHT)
+
+// ==================== 时序模型 ====================
+#define EPD_SIM_LUT_BYTES           153      // 0x32 的波形表长度
+#define EPD_SIM_LUT_FRAME_US        20000    // 波形每帧时长，按50Hz帧率近似
+#define EPD_SIM_OTP_FULL_US         2000000  // 未加载主机LUT时的完整刷新时长
+#define EPD_SIM_OTP_PARTIAL_US      500000   // 未加载主机LUT时的局部刷新时长
+#define EPD_SIM_POWER_SEQUENCE_US   10000    // 不含显示的激活（只开关时钟/模拟电路）
+#define EPD_SIM_SWRESET_US          2000
+
+#define EPD_SIM_FRAME_HISTORY       16       // 保留最近的帧统计数
+
+// 图像平面：位为1表示白色，0表示黑色
+enum EpdSimPlane {
+  EPD_SIM_PLANE_BW = 0,    // 0x24 黑白RAM（新画面）
+  EPD_SIM_PLANE_RED,       // 0x26 RED/旧画面RAM（局部刷新时作为上一帧）
+  EPD_SIM_PANEL,           // 面板上的画面：最近一次显示刷新时的 0x24 RAM
+  EPD_SIM_PLANE_COUNT
+};
+
+// 协议误用标志（可组合）
+enum EpdSimMisuse {
+  EPD_SIM_MISUSE_WRITE_WHILE_BUSY    = 0x01,   // BUSY 期间发送命令或数据
+  EPD_SIM_MISUSE_WRITE_WHILE_ASLEEP  = 0x02,   // 深度睡眠后未硬件复位就发送
+  EPD_SIM_MISUSE_RAM_OUT_OF_RANGE    = 0x04,   // 地址计数器超出RAM时写入
+  EPD_SIM_MISUSE_LUT_LENGTH          = 0x08,   // 0x32 后的数据不是153字节
+  EPD_SIM_MISUSE_NO_UPDATE_SEQUENCE  = 0x10    // 复位后未设置 0x22 就激活 0x20
+};
+
+// 一帧：上一次显示刷新之后到本次 0x20 显示激活为止的全部传输
+struct EpdSimFrame {
+  uint32_t startUs;        // 本次激活时刻
+  uint32_t spiBytes;       // 含命令字节
+  uint32_t commands;
+  uint32_t ramBytes;       // 写入 0x24/0x26 的数据字节
+  uint32_t busyUs;         // 模拟的BUSY总时长（含复位和上电序列）
+  uint8_t updateSequence;  // 激活时的 0x22 参数
+  bool partial;            // 显示模式2（局部刷新）
+  uint8_t misuse;          // 本帧期间的误用标志
+};
+
+struct EpdSimStats {
+  uint32_t frames;
+  uint32_t fullRefreshes;
+  uint32_t partialRefreshes;
+  uint32_t spiBytes;
+  uint32_t busyUs;
+  uint32_t misuseCount;
+  uint8_t misuse;          // 所有误用标志的并集
+};
+
+// ==================== 连接与复位 ====================
+void epdSimAttach();                 // 复位并注册为SPI接收端和BUSY/RST引脚模型（halHostReset 会取消注册）
+void epdSimReset();                  // RAM 恢复为上电状态（全白），寄存器与统计清零
+
+// ==================== RAM 与面板 ====================
+const uint8_t* epdSimPlane(uint8_t plane);
+bool epdSimPixelBlack(uint8_t plane, int x, int y);
+uint32_t epdSimRefreshCount();       // 收到的显示激活数（含 0x22 显示位的 0x20）
+
+// ==================== 时序与统计 ====================
+bool epdSimBusy();
+bool epdSimAsleep();
+uint32_t epdSimWaveformUs(bool partial);     // 当前LUT下一次显示刷新的BUSY时长
+const EpdSimStats& epdSimStats();
+uint32_t epdSimFrameCount();                 // 可读取的历史帧数（最多 EPD_SIM_FRAME_HISTORY）
+const EpdSimFrame* epdSimFrame(uint32_t index);   // 0 为最近一帧
+void epdSimPrintReport();                    // 每帧统计与误用摘要写到stdout
+
+// ==================== 图像 ====================
+// PBM(P4) 中1表示黑色，与RAM位相反；写入/读取时自动转换
+bool epdSimWritePbm(uint8_t plane, const char* path);
+bool epdSimReadPbm(const char* path, uint8_t* plane);
+
+// 返回与参考图像不同的像素数，参考图像不存在或格式错误时返回-1
+long epdSimComparePbm(uint8_t plane, const char* path);
+
+#endif // EPD_SIM_H
@@ -0,0 +1,67 @@
+/**
+ * HalHost.h - 主机端硬件模拟控制接口
+ *
+ * HalLinux.cpp 实现 Hal.h 的同时保存全部模拟状态，
+ * 测试和主机程序通过这里的函数控制时钟、注入引脚电平与ADC读数、
+ * 截获SPI字节和串口输出
+ */
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <stdint.h>
+#include <string>
+#include "Hal.h"
+
+#define HAL_HOST_PIN_COUNT 32
+
+// ==================== 时钟 ====================
+enum HalClockMode {
+  HAL_CLOCK_REAL = 0,      // 跟随系统单调时钟，delay() 真实睡眠
+  HAL_CLOCK_VIRTUAL        // 只在 delay()/空闲/手动推进时前进，测试结果可重复
+};
+
+void halHostSetClockMode(uint8_t mode);
+void halHostAdvanceMicros(uint64_t us);
+void halHostAdvanceMillis(uint32_t ms);
+void halHostIdle();                    // yield() 与调度器空闲等待：前进或睡眠1毫秒
+
+// ==================== GPIO ====================
+// 模拟外部信号，电平变化时同步调用 halAttachInterrupt() 注册的中断
+void halHostSetPin(uint8_t pin, uint8_t level);
+uint8_t halHostGetPin(uint8_t pin);
+
+// 模拟外设用：读取源返回负数时使用引脚电平；观察者只在固件写引脚时调用
+typedef int (*HalPinSource)(uint8_t pin);
+typedef void (*HalPinWatcher)(uint8_t pin, uint8_t level);
+
+void halHostSetPinSource(HalPinSource source);
+void halHostSetPinWatcher(HalPinWatcher watcher);
+
+// ==================== ADC 与温度 ====================
+typedef int (*HalAnalogSource)(uint8_t pin);
+typedef float (*HalTemperatureSource)();
+
+void halHostSetAnalog(uint8_t pin, int value);
+void halHostSetAnalogSource(HalAnalogSource source);  // 设置后优先于固定读数，NULL取消
+void halHostSetTemperatureC(float celsius);
+void halHostSetTemperatureSource(HalTemperatureSource source);  // 同上，作用于 DS18B20 读数
+float halHostGetTemperatureC();
+
+// ==================== SPI ====================
+typedef void (*HalSpiSink)(uint8_t data);
+
+void halHostSetSpiSink(HalSpiSink sink);
+uint32_t halHostSpiByteCount();
+
+// ==================== 串口 ====================
+void halHostSerialInput(const char* text);
+void halHostSetSerialEcho(bool echo);          // 默认写到stdout；关闭后保存在缓冲区供测试检查
+void halHostSetSerialAttached(bool attached);
+const std::string& halHostSerialOutput();
+void halHostClearSerialOutput();
+
+// ==================== 复位 ====================
+void halHostReset();                   // 恢复模拟状态的默认值，切换到虚拟时钟并归零
+
+#endif // HAL_HOST_H
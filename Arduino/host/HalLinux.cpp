@@ -0,0 +1,281 @@
+/**
+ * HalLinux.cpp - 硬件抽象层的 Linux 实现
+ *
+ * 所有"硬件"都是进程内的状态：引脚电平数组、ADC读数、SPI字节计数、串口收发缓冲区
+ * 默认使用真实时钟，测试切换到虚拟时钟后时间只在 delay()/空闲/手动推进时前进
+ */
+
+#include "HalHost.h"
+
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <stdio.h>
+
+// 与 Arduino.h 中的定义一致
+#define PIN_INPUT_PULLUP 2
+#define PIN_CHANGE       2
+#define PIN_FALLING      3
+#define PIN_RISING       4
+
+#define SERIAL_TX_SPACE  256
+
+// ==================== 模拟状态 ====================
+static uint8_t clockMode = HAL_CLOCK_REAL;
+static uint64_t virtualMicros = 0;
+static std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+
+static uint8_t pinLevel[HAL_HOST_PIN_COUNT];
+static HalIsr pinIsr[HAL_HOST_PIN_COUNT];
+static uint8_t pinIsrMode[HAL_HOST_PIN_COUNT];
+static HalPinSource pinSource = NULL;
+static HalPinWatcher pinWatcher = NULL;
+
+static int analogValue[HAL_HOST_PIN_COUNT];
+static HalAnalogSource analogSource = NULL;
+static float temperatureC = 22.0;
+static HalTemperatureSource temperatureSource = NULL;
+
+static HalSpiSink spiSink = NULL;
+static uint32_t spiByteCount = 0;
+
+static std::deque<uint8_t> serialInput;
+static std::string serialOutput;
+static bool serialEcho = true;
+static bool serialAttached = true;
+
+static uint64_t nowMicros() {
+  if (clockMode == HAL_CLOCK_VIRTUAL) {
+    return virtualMicros;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - clockStart).count();
+}
+
+// ==================== 时钟 ====================
+uint32_t halMillis() {
+  return (uint32_t)(nowMicros() / 1000);
+}
+
+uint32_t halMicros() {
+  return (uint32_t)nowMicros();
+}
+
+void halDelay(uint32_t ms) {
+  if (clockMode == HAL_CLOCK_VIRTUAL) {
+    virtualMicros += (uint64_t)ms * 1000;
+  } else {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  }
+}
+
+void halHostSetClockMode(uint8_t mode) {
+  // 切换时保持时间连续
+  uint64_t now = nowMicros();
+  clockMode = mode;
+  virtualMicros = now;
+  clockStart = std::chrono::steady_clock::now() - std::chrono::microseconds(now);
+}
+
+void halHostAdvanceMicros(uint64_t us) {
+  if (clockMode == HAL_CLOCK_VIRTUAL) {
+    virtualMicros += us;
+  }
+}
+
+void halHostAdvanceMillis(uint32_t ms) {
+  halHostAdvanceMicros((uint64_t)ms * 1000);
+}
+
+void halHostIdle() {
+  halDelay(1);
+}
+
+// ==================== GPIO ====================
+void halPinMode(uint8_t pin, uint8_t mode) {
+  if (pin < HAL_HOST_PIN_COUNT && mode == PIN_INPUT_PULLUP) {
+    pinLevel[pin] = 1;
+  }
+}
+
+void halHostSetPin(uint8_t pin, uint8_t level) {
+  if (pin >= HAL_HOST_PIN_COUNT) {
+    return;
+  }
+  uint8_t previous = pinLevel[pin];
+  pinLevel[pin] = level ? 1 : 0;
+  if (pinIsr[pin] == NULL || previous == pinLevel[pin]) {
+    return;
+  }
+  uint8_t mode = pinIsrMode[pin];
+  if (mode == PIN_CHANGE ||
+      (mode == PIN_RISING && pinLevel[pin]) ||
+      (mode == PIN_FALLING && !pinLevel[pin])) {
+    pinIsr[pin]();
+  }
+}
+
+uint8_t halHostGetPin(uint8_t pin) {
+  return pin < HAL_HOST_PIN_COUNT ? pinLevel[pin] : 0;
+}
+
+void halDigitalWrite(uint8_t pin, uint8_t value) {
+  halHostSetPin(pin, value);
+  if (pinWatcher != NULL && pin < HAL_HOST_PIN_COUNT) {
+    pinWatcher(pin, pinLevel[pin]);
+  }
+}
+
+int halDigitalRead(uint8_t pin) {
+  if (pinSource != NULL) {
+    int level = pinSource(pin);
+    if (level >= 0) {
+      return level;
+    }
+  }
+  return halHostGetPin(pin);
+}
+
+void halHostSetPinSource(HalPinSource source) {
+  pinSource = source;
+}
+
+void halHostSetPinWatcher(HalPinWatcher watcher) {
+  pinWatcher = watcher;
+}
+
+void halAttachInterrupt(uint8_t pin, HalIsr isr, uint8_t mode) {
+  if (pin < HAL_HOST_PIN_COUNT) {
+    pinIsr[pin] = isr;
+    pinIsrMode[pin] = mode;
+  }
+}
+
+// ==================== ADC 与温度 ====================
+int halAnalogRead(uint8_t pin) {
+  if (analogSource != NULL) {
+    return analogSource(pin);
+  }
+  return pin < HAL_HOST_PIN_COUNT ? analogValue[pin] : 0;
+}
+
+void halHostSetAnalog(uint8_t pin, int value) {
+  if (pin < HAL_HOST_PIN_COUNT) {
+    analogValue[pin] = value;
+  }
+}
+
+void halHostSetAnalogSource(HalAnalogSource source) {
+  analogSource = source;
+}
+
+void halHostSetTemperatureC(float celsius) {
+  temperatureC = celsius;
+}
+
+void halHostSetTemperatureSource(HalTemperatureSource source) {
+  temperatureSource = source;
+}
+
+float halHostGetTemperatureC() {
+  if (temperatureSource != NULL) {
+    return temperatureSource();
+  }
+  return temperatureC;
+}
+
+// ==================== SPI ====================
+void halSpiBegin() {}
+
+void halSpiEnd() {}
+
+uint8_t halSpiTransfer(uint8_t data) {
+  spiByteCount++;
+  if (spiSink != NULL) {
+    spiSink(data);
+  }
+  return 0;
+}
+
+void halHostSetSpiSink(HalSpiSink sink) {
+  spiSink = sink;
+}
+
+uint32_t halHostSpiByteCount() {
+  return spiByteCount;
+}
+
+// ==================== 串口 ====================
+int halSerialAvailable() {
+  return (int)serialInput.size();
+}
+
+int halSerialRead() {
+  if (serialInput.empty()) {
+    return -1;
+  }
+  uint8_t c = serialInput.front();
+  serialInput.pop_front();
+  return c;
+}
+
+size_t halSerialWrite(const uint8_t* data, size_t length) {
+  if (serialEcho) {
+    fwrite(data, 1, length, stdout);
+  } else {
+    serialOutput.append((const char*)data, length);
+  }
+  return length;
+}
+
+int halSerialAvailableForWrite() {
+  return SERIAL_TX_SPACE;
+}
+
+bool halSerialHostAttached() {
+  return serialAttached;
+}
+
+void halHostSerialInput(const char* text) {
+  while (*text) {
+    serialInput.push_back((uint8_t)*text++);
+  }
+}
+
+void halHostSetSerialEcho(bool echo) {
+  serialEcho = echo;
+}
+
+void halHostSetSerialAttached(bool attached) {
+  serialAttached = attached;
+}
+
+const std::string& halHostSerialOutput() {
+  return serialOutput;
+}
+
+void halHostClearSerialOutput() {
+  serialOutput.clear();
+}
+
+// ==================== 复位 ====================
+void halHostReset() {
+  clockMode = HAL_CLOCK_VIRTUAL;
+  virtualMicros = 0;
+  for (int pin = 0; pin < HAL_HOST_PIN_COUNT; pin++) {
+    pinLevel[pin] = 0;
+    pinIsr[pin] = NULL;
+    pinIsrMode[pin] = 0;
+    analogValue[pin] = 0;
+  }
+  pinSource = NULL;
+  pinWatcher = NULL;
+  analogSource = NULL;
+  temperatureC = 22.0;
+  temperatureSource = NULL;
+  spiSink = NULL;
+  spiByteCount = 0;
+  serialInput.clear();
+  serialOutput.clear();
+  serialAttached = true;
+}
@@ -0,0 +1,48 @@
+/**
+ * Replay.h - 传感器信号回放：采集 → 分级 → 上行编码 的完整流程
+ *
+ * 在虚拟时钟上按采样间隔推进，每个样本调用固件的 readAllSensors()、
+ * packWaterQualityData() 和 encodeWaterQualityPayload()；
+ * 输入信号来自 SensorSim，可用于比较滤波参数和测量吞吐量
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WaterQualityLED.h"
+
+enum ReplayField {
+  REPLAY_TEMPERATURE = 0,
+  REPLAY_PH,
+  REPLAY_TURBIDITY,
+  REPLAY_CONDUCTIVITY,
+  REPLAY_TDS,
+  REPLAY_FIELD_COUNT
+};
+
+struct ReplayFieldStats {
+  float min;
+  float max;
+  double sum;
+  double sumSquares;
+};
+
+struct ReplayStats {
+  uint32_t samples;
+  uint32_t simMs;                               // 模拟经过的时间
+  uint64_t wallUs;                              // 实际耗时
+  uint32_t gradeCounts[QUALITY_GRADE_COUNT];
+  uint32_t gradeChanges;                        // 相邻样本分级不同的次数，越少说明越稳定
+  uint32_t payloadBytes;
+  uint32_t unsettled;                           // 稳定检测超时的样本数
+  uint32_t settleMsTotal;                       // 各样本采集耗时之和
+  ReplayFieldStats fields[REPLAY_FIELD_COUNT];
+};
+
+// 初始化传感器后采集 samples 个样本；csv 不为 NULL 时逐样本写出读数、分级和载荷
+void runReplay(uint32_t samples, uint32_t intervalMs, FILE* csv, ReplayStats& stats);
+void printReplayStats(const ReplayStats& stats);
+
+#endif // REPLAY_H
@@ -0,0 +1,344 @@
+/**
+ * SensorSim.cpp - 传感器信号模拟实现
+ *
+ * 每次固件读取ADC或温度时按当前模拟时刻计算信号：
+ * 轨迹插值或基线+漂移 → 断开判断 → 叠加噪声和尖峰 → 量化为10位ADC读数
+ * 断开的ADC输入按浮空处理，读数在全量程内随机；断开的 DS18B20 返回 DEVICE_DISCONNECTED_C
+ */
+
+#include "SensorSim.h"
+#include "HalHost.h"
+#include "WaterMonitor.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// ==================== 内置场景 ====================
+// 基线是清洁自来水：20℃、pH 7.2 (1.995V)、浊度约0.7 NTU（传感器4.15V经1/2分压）、
+// 电导率365 µS/cm (0.42V)
+#define CLEAN_TEMPERATURE   20.0
+#define CLEAN_PH_V          1.995
+#define CLEAN_TURBIDITY_V   2.075
+#define CLEAN_EC_V          0.42
+
+struct SensorScenario {
+  const char* name;
+  const char* description;
+  SensorWaveform waveforms[SIM_CH_COUNT];
+};
+
+static const SensorScenario SCENARIOS[] = {
+  {"steady", "清洁水，仅有ADC级噪声", {
+    {CLEAN_TEMPERATURE, 0, 0.05,  0, 0, 0, 0},
+    {CLEAN_PH_V,        0, 0.003, 0, 0, 0, 0},
+    {CLEAN_TURBIDITY_V, 0, 0.005, 0, 0, 0, 0},
+    {CLEAN_EC_V,        0, 0.004, 0, 0, 0, 0}}},
+  {"drift", "pH电极老化与浊度探头结垢，水温缓慢上升", {
+    {CLEAN_TEMPERATURE, 0.5,    0.05,  0, 0, 0, 0},
+    {CLEAN_PH_V,        -0.02,  0.003, 0, 0, 0, 0},
+    {CLEAN_TURBIDITY_V, -0.01,  0.005, 0, 0, 0, 0},
+    {CLEAN_EC_V,        0.005,  0.004, 0, 0, 0, 0}}},
+  {"noisy", "供电或接地不良，噪声是steady的5倍", {
+    {CLEAN_TEMPERATURE, 0, 0.25,  0, 0, 0, 0},
+    {CLEAN_PH_V,        0, 0.015, 0, 0, 0, 0},
+    {CLEAN_TURBIDITY_V, 0, 0.025, 0, 0, 0, 0},
+    {CLEAN_EC_V,        0, 0.02,  0, 0, 0, 0}}},
+  {"spikes", "气泡遮挡浊度光路，电导率电极偶发尖峰", {
+    {CLEAN_TEMPERATURE, 0, 0.05,  0,    0,    0, 0},
+    {CLEAN_PH_V,        0, 0.003, 0,    0,    0, 0},
+    {CLEAN_TURBIDITY_V, 0, 0.005, 0.05, -0.5, 0, 0},
+    {CLEAN_EC_V,        0, 0.004, 0.05, 0.4,  0, 0}}},
+  {"disconnect", "温度探头10-20分钟断开，pH探头30-40分钟断开", {
+    {CLEAN_TEMPERATURE, 0, 0.05,  0, 0, 600000,  1200000},
+    {CLEAN_PH_V,        0, 0.003, 0, 0, 1800000, 2400000},
+    {CLEAN_TURBIDITY_V, 0, 0.005, 0, 0, 0,       0},
+    {CLEAN_EC_V,        0, 0.004, 0, 0, 0,       0}}},
+};
+#define SCENARIO_COUNT (sizeof(SCENARIOS) / sizeof(SCENARIOS[0]))
+
+static const char* const CSV_COLUMNS[SIM_CH_COUNT] = {
+  "temperature_c", "ph_v", "turbidity_v", "conductivity_v"
+};
+
+// ==================== 模拟状态 ====================
+struct TraceRow {
+  uint32_t timeMs;
+  float values[SIM_CH_COUNT];   // NAN 表示断开
+};
+
+static SensorWaveform waveforms[SIM_CH_COUNT];
+static std::vector<TraceRow> trace;
+static bool traceHasChannel[SIM_CH_COUNT];
+static uint32_t startMs = 0;
+static uint32_t rngState = 1;
+
+// ==================== 伪随机数 ====================
+static uint32_t nextRandom() {
+  // xorshift32
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+static float randomUniform() {
+  return (nextRandom() >> 8) * (1.0f / 16777216.0f);
+}
+
+static float randomGaussian() {
+  // Box-Muller，u1 不取0
+  float u1 = (nextRandom() >> 8 | 1) * (1.0f / 16777216.0f);
+  float u2 = randomUniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+// ==================== 信号计算 ====================
+static uint32_t elapsedMs() {
+  return halMillis() - startMs;
+}
+
+static float traceValue(uint8_t channel, uint32_t t) {
+  if (t <= trace.front().timeMs) {
+    return trace.front().values[channel];
+  }
+  if (t >= trace.back().timeMs) {
+    return trace.back().values[channel];
+  }
+
+  size_t i = 1;
+  while (trace[i].timeMs < t) {
+    i++;
+  }
+  const TraceRow& a = trace[i - 1];
+  const TraceRow& b = trace[i];
+  // 任一端断开时不插值，保持前一行的状态
+  if (isnan(a.values[channel]) || isnan(b.values[channel]) || b.timeMs == a.timeMs) {
+    return a.values[channel];
+  }
+  float k = (float)(t - a.timeMs) / (float)(b.timeMs - a.timeMs);
+  return a.values[channel] + k * (b.values[channel] - a.values[channel]);
+}
+
+float sensorSimValue(uint8_t channel, bool& connected) {
+  connected = false;
+  if (channel >= SIM_CH_COUNT) {
+    return 0;
+  }
+
+  const SensorWaveform& w = waveforms[channel];
+  uint32_t t = elapsedMs();
+  if (w.disconnectEndMs > w.disconnectStartMs && t >= w.disconnectStartMs && t < w.disconnectEndMs) {
+    return 0;
+  }
+
+  float value;
+  if (!trace.empty() && traceHasChannel[channel]) {
+    value = traceValue(channel, t);
+    if (isnan(value)) {
+      return 0;
+    }
+  } else {
+    value = w.base + w.driftPerHour * (t / 3600000.0f);
+  }
+  connected = true;
+  return value;
+}
+
+// 加上噪声和尖峰后的读数
+static float sampleChannel(uint8_t channel, bool& connected) {
+  float value = sensorSimValue(channel, connected);
+  if (!connected) {
+    return value;
+  }
+  const SensorWaveform& w = waveforms[channel];
+  if (w.noise > 0) {
+    value += w.noise * randomGaussian();
+  }
+  if (w.spikeRate > 0 && randomUniform() < w.spikeRate) {
+    value += w.spikeAmplitude;
+  }
+  return value;
+}
+
+static int sensorSimAnalogSource(uint8_t pin) {
+  uint8_t channel;
+  switch (pin) {
+    case PH_SENSOR_PIN:    channel = SIM_CH_PH; break;
+    case TURBIDITY_PIN:    channel = SIM_CH_TURBIDITY; break;
+    case CONDUCTIVITY_PIN: channel = SIM_CH_CONDUCTIVITY; break;
+    default:
+      return 0;   // 未连接传感器的引脚
+  }
+
+  bool connected;
+  float volts = sampleChannel(channel, connected);
+  if (!connected) {
+    return (int)(randomUniform() * ADC_RESOLUTION);   // 浮空输入
+  }
+  int raw = (int)(volts / VREF * ADC_RESOLUTION + 0.5f);
+  return constrain(raw, 0, (int)ADC_RESOLUTION - 1);
+}
+
+static float sensorSimTemperatureSource() {
+  bool connected;
+  float celsius = sampleChannel(SIM_CH_TEMPERATURE, connected);
+  if (!connected) {
+    return DEVICE_DISCONNECTED_C;
+  }
+  // DS18B20 12位分辨率 0.0625℃
+  return roundf(celsius * 16.0f) / 16.0f;
+}
+
+// ==================== 连接 ====================
+void sensorSimAttach(uint32_t seed) {
+  rngState = seed != 0 ? seed : 1;
+  startMs = halMillis();
+  sensorSimClearTrace();
+  sensorSimLoadScenario("steady");
+  halHostSetAnalogSource(sensorSimAnalogSource);
+  halHostSetTemperatureSource(sensorSimTemperatureSource);
+}
+
+void sensorSimSetWaveform(uint8_t channel, const SensorWaveform& waveform) {
+  if (channel < SIM_CH_COUNT) {
+    waveforms[channel] = waveform;
+  }
+}
+
+const SensorWaveform& sensorSimGetWaveform(uint8_t channel) {
+  return waveforms[channel < SIM_CH_COUNT ? channel : 0];
+}
+
+// ==================== 场景 ====================
+bool sensorSimLoadScenario(const char* name) {
+  for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+    if (strcmp(SCENARIOS[i].name, name) == 0) {
+      memcpy(waveforms, SCENARIOS[i].waveforms, sizeof(waveforms));
+      return true;
+    }
+  }
+  return false;
+}
+
+void sensorSimPrintScenarios() {
+  for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+    printf("  %-12s %s\n", SCENARIOS[i].name, SCENARIOS[i].description);
+  }
+}
+
+// ==================== CSV 轨迹 ====================
+// 原地切分一行，返回字段数；空字段返回空字符串
+static int splitCsvLine(char* line, char** fields, int maxFields) {
+  int count = 0;
+  char* p = line;
+  while (count < maxFields) {
+    fields[count++] = p;
+    char* comma = strchr(p, ',');
+    if (comma == NULL) {
+      break;
+    }
+    *comma = '\0';
+    p = comma + 1;
+  }
+  for (int i = 0; i < count; i++) {
+    char* end = fields[i] + strlen(fields[i]);
+    while (end > fields[i] && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ')) {
+      *--end = '\0';
+    }
+    while (*fields[i] == ' ') {
+      fields[i]++;
+    }
+  }
+  return count;
+}
+
+bool sensorSimLoadCsv(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "✗ 无法打开轨迹文件 %s\n", path);
+    return false;
+  }
+
+  const int MAX_FIELDS = 16;
+  char line[256];
+  char* fields[MAX_FIELDS];
+  int timeColumn = -1;
+  int channelColumn[SIM_CH_COUNT] = {-1, -1, -1, -1};
+  std::vector<TraceRow> rows;
+  bool ok = true;
+  int lineNumber = 0;
+
+  while (ok && fgets(line, sizeof(line), file) != NULL) {
+    lineNumber++;
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    int count = splitCsvLine(line, fields, MAX_FIELDS);
+
+    // 列名行
+    if (timeColumn < 0) {
+      for (int i = 0; i < count; i++) {
+        if (strcmp(fields[i], "time_ms") == 0) {
+          timeColumn = i;
+        }
+        for (int ch = 0; ch < SIM_CH_COUNT; ch++) {
+          if (strcmp(fields[i], CSV_COLUMNS[ch]) == 0) {
+            channelColumn[ch] = i;
+          }
+        }
+      }
+      if (timeColumn < 0) {
+        fprintf(stderr, "✗ %s: 缺少 time_ms 列\n", path);
+        ok = false;
+      }
+      continue;
+    }
+
+    TraceRow row;
+    char* end;
+    row.timeMs = timeColumn < count ? strtoul(fields[timeColumn], &end, 10) : 0;
+    if (timeColumn >= count || *end != '\0' || (!rows.empty() && row.timeMs < rows.back().timeMs)) {
+      fprintf(stderr, "✗ %s:%d: 时间无效或未按升序排列\n", path, lineNumber);
+      ok = false;
+      break;
+    }
+    for (int ch = 0; ch < SIM_CH_COUNT; ch++) {
+      int column = channelColumn[ch];
+      row.values[ch] = NAN;
+      if (column >= 0 && column < count && fields[column][0] != '\0') {
+        row.values[ch] = strtof(fields[column], &end);
+        if (*end != '\0') {
+          fprintf(stderr, "✗ %s:%d: 无效数值 \"%s\"\n", path, lineNumber, fields[column]);
+          ok = false;
+        }
+      }
+    }
+    rows.push_back(row);
+  }
+  fclose(file);
+
+  if (ok && rows.empty()) {
+    fprintf(stderr, "✗ %s: 没有数据行\n", path);
+    ok = false;
+  }
+  if (!ok) {
+    return false;
+  }
+
+  trace.swap(rows);
+  for (int ch = 0; ch < SIM_CH_COUNT; ch++) {
+    traceHasChannel[ch] = channelColumn[ch] >= 0;
+  }
+  return true;
+}
+
+void sensorSimClearTrace() {
+  trace.clear();
+  memset(traceHasChannel, 0, sizeof(traceHasChannel));
+}
+
+uint32_t sensorSimTraceDurationMs() {
+  return trace.empty() ? 0 : trace.back().timeMs;
+}
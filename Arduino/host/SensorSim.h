@@ -0,0 +1,53 @@
+/**
+ * SensorSim.h - 主机端传感器信号模拟
+ *
+ * 接管模拟ADC（pH、浊度、电导率通道）和 DS18B20 温度读数，
+ * 信号来自脚本化波形（基线、漂移、噪声、尖峰、探头断开）或录制的CSV轨迹；
+ * 随机量由固定种子的伪随机数产生，同一种子和时钟下读数完全可重复
+ *
+ * ADC 通道的数值是引脚上的电压(V)，换算成物理量是固件的工作；温度单位为℃
+ */
+
+#ifndef SENSOR_SIM_H
+#define SENSOR_SIM_H
+
+#include <stdint.h>
+
+enum SensorSimChannel {
+  SIM_CH_TEMPERATURE = 0,
+  SIM_CH_PH,
+  SIM_CH_TURBIDITY,
+  SIM_CH_CONDUCTIVITY,
+  SIM_CH_COUNT
+};
+
+struct SensorWaveform {
+  float base;                  // 起始值（轨迹模式下由轨迹代替）
+  float driftPerHour;          // 线性漂移
+  float noise;                 // 高斯噪声标准差
+  float spikeRate;             // 每次读取出现尖峰的概率 0~1
+  float spikeAmplitude;        // 尖峰幅度，可为负
+  uint32_t disconnectStartMs;  // 探头断开区间 [start, end)，相对模拟开始时刻
+  uint32_t disconnectEndMs;    // 0 表示不断开
+};
+
+// ==================== 连接 ====================
+void sensorSimAttach(uint32_t seed);     // 注册ADC和温度源，所有通道恢复为"steady"场景
+void sensorSimSetWaveform(uint8_t channel, const SensorWaveform& waveform);
+const SensorWaveform& sensorSimGetWaveform(uint8_t channel);
+
+// ==================== 场景与轨迹 ====================
+bool sensorSimLoadScenario(const char* name);
+void sensorSimPrintScenarios();
+
+// CSV 首行为列名：time_ms 以及 temperature_c / ph_v / turbidity_v / conductivity_v 中的任意列，
+// 空单元格表示该时刻探头断开；轨迹代替基线和漂移，噪声、尖峰和断开区间仍然叠加
+bool sensorSimLoadCsv(const char* path);
+void sensorSimClearTrace();
+uint32_t sensorSimTraceDurationMs();     // 最后一行的时间，没有轨迹时为0
+
+// ==================== 读数 ====================
+// 当前时刻不含噪声的信号值；探头断开时 connected 为 false
+float sensorSimValue(uint8_t channel, bool& connected);
+
+#endif // SENSOR_SIM_H
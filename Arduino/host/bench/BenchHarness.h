@@ -0,0 +1,71 @@
+/**
+ * BenchHarness.h - 主机端微基准框架（Google Benchmark 风格）
+ *
+ * BENCHMARK(name) 定义一个基准，函数体用 while (state.keepRunning()) 包住被测代码：
+ *
+ *   BENCHMARK(paint_clear) {
+ *     while (state.keepRunning()) {
+ *       paint.Clear(UNCOLORED);
+ *     }
+ *   }
+ *
+ * 框架自动确定迭代次数，报告 ns/op 以及每次操作经 SPI 发往屏幕的字节数和命令数
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdint.h>
+
+// 计时与SPI计数的快照，只在第一次和最后一次 keepRunning() 时采样，
+// 循环之前的准备代码不计入结果
+struct BenchSample {
+  uint64_t ns;
+  uint64_t spiBytes;
+  uint64_t commands;
+};
+
+BenchSample benchSample();
+
+class BenchState {
+public:
+  explicit BenchState(uint64_t iterations) : remaining_(iterations), started_(false) {}
+
+  bool keepRunning() {
+    if (!started_) {
+      started_ = true;
+      start = benchSample();
+    }
+    if (remaining_ == 0) {
+      end = benchSample();
+      return false;
+    }
+    remaining_--;
+    return true;
+  }
+
+  BenchSample start;
+  BenchSample end;
+
+private:
+  uint64_t remaining_;
+  bool started_;
+};
+
+typedef void (*BenchFunction)(BenchState& state);
+
+struct BenchRegistrar {
+  BenchRegistrar(const char* name, BenchFunction run);
+};
+
+// 阻止编译器把只写不读的结果优化掉
+inline void benchDoNotOptimize(const void* value) {
+  asm volatile("" : : "g"(value) : "memory");
+}
+
+#define BENCHMARK(name) \
+  static void bench_##name(BenchState& state); \
+  static BenchRegistrar benchRegistrar_##name(#name, bench_##name); \
+  static void bench_##name(BenchState& state)
+
+#endif // BENCH_HARNESS_H
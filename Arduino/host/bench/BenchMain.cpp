@@ -0,0 +1,247 @@
+/**
+ * BenchMain.cpp - 基准程序入口、结果输出与基线比较
+ *
+ * 用法: water_bench [--filter 名称片段] [--min-time 毫秒]
+ *                   [--check 基线文件] [--tolerance 百分比] [--write-baseline 基线文件]
+ *
+ * 每个基准重复测量 BENCH_REPETITIONS 次取最快值，计时用线程CPU时间，减小系统噪声的影响；
+ * --check 时 ns/op 超出基线 tolerance%（重测后仍超出）或 SPI字节/命令数比基线多即判为回归，
+ * 退出码为回归数
+ */
+
+#include "BenchHarness.h"
+#include "HalHost.h"
+#include "epdif.h"
+
+#include <map>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_BENCHMARKS     64
+#define BENCH_REPETITIONS  5
+#define DEFAULT_MIN_TIME_MS 100
+#define DEFAULT_TOLERANCE  50.0
+#define BENCH_CHECK_RETRIES 2    // 超出基线时重新测量的次数，排除偶发的系统抖动
+
+struct BenchCase {
+  const char* name;
+  BenchFunction run;
+};
+
+struct BenchResult {
+  double nsPerOp;
+  double spiBytesPerOp;
+  double commandsPerOp;
+  uint64_t iterations;
+};
+
+static BenchCase benchCases[MAX_BENCHMARKS];
+static int benchCount = 0;
+static uint64_t commandCount = 0;
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction run) {
+  if (benchCount < MAX_BENCHMARKS) {
+    benchCases[benchCount].name = name;
+    benchCases[benchCount].run = run;
+    benchCount++;
+  }
+}
+
+// ==================== 采样 ====================
+// 伪 EpdIf：DC 引脚为低时发送的字节是命令，为高时是数据
+static void countSpiByte(uint8_t) {
+  if (halHostGetPin(DC_PIN) == LOW) {
+    commandCount++;
+  }
+}
+
+BenchSample benchSample() {
+  BenchSample sample;
+  // 线程CPU时间，不计入被其他进程抢占的时间
+  struct timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  sample.ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+  sample.spiBytes = halHostSpiByteCount();
+  sample.commands = commandCount;
+  return sample;
+}
+
+static BenchResult runIterations(const BenchCase& bench, uint64_t iterations) {
+  BenchState state(iterations);
+  bench.run(state);
+  halHostClearSerialOutput();
+
+  BenchResult result;
+  result.iterations = iterations;
+  result.nsPerOp = (double)(state.end.ns - state.start.ns) / iterations;
+  result.spiBytesPerOp = (double)(state.end.spiBytes - state.start.spiBytes) / iterations;
+  result.commandsPerOp = (double)(state.end.commands - state.start.commands) / iterations;
+  return result;
+}
+
+static BenchResult measure(const BenchCase& bench, double minTimeMs) {
+  // 迭代次数按10倍增长，直到单次测量足够长，再按比例放大到目标时间
+  uint64_t iterations = 1;
+  BenchResult result = runIterations(bench, iterations);
+  while (result.nsPerOp * iterations < minTimeMs * 1e5 && iterations < 1000000000ULL) {
+    iterations *= 10;
+    result = runIterations(bench, iterations);
+  }
+  double target = minTimeMs * 1e6 / (result.nsPerOp > 0 ? result.nsPerOp : 1);
+  iterations = target < 1 ? 1 : (uint64_t)target;
+
+  BenchResult best = runIterations(bench, iterations);
+  for (int i = 1; i < BENCH_REPETITIONS; i++) {
+    BenchResult repeat = runIterations(bench, iterations);
+    if (repeat.nsPerOp < best.nsPerOp) {
+      best = repeat;
+    }
+  }
+  return best;
+}
+
+// ==================== 基线文件 ====================
+static bool readBaseline(const char* path, std::map<std::string, BenchResult>& baseline) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    char name[128];
+    BenchResult entry = {0, 0, 0, 0};
+    if (line[0] == '#' ||
+        sscanf(line, "%127s %lf %lf %lf", name, &entry.nsPerOp, &entry.spiBytesPerOp, &entry.commandsPerOp) != 4) {
+      continue;
+    }
+    baseline[name] = entry;
+  }
+  fclose(file);
+  return true;
+}
+
+static bool writeBaseline(const char* path, const std::map<std::string, BenchResult>& results) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "# 渲染基准基线，由 water_bench --write-baseline 生成\n");
+  fprintf(file, "# 名称 ns/op SPI字节/op 命令/op\n");
+  for (std::map<std::string, BenchResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+    fprintf(file, "%s %.1f %.1f %.1f\n", it->first.c_str(),
+            it->second.nsPerOp, it->second.spiBytesPerOp, it->second.commandsPerOp);
+  }
+  fclose(file);
+  return true;
+}
+
+// 返回是否回归
+static bool compareWithBaseline(const char* name, const BenchResult& result,
+                                const BenchResult& base, double tolerance) {
+  bool regressed = false;
+  double change = base.nsPerOp > 0 ? (result.nsPerOp - base.nsPerOp) * 100.0 / base.nsPerOp : 0;
+
+  if (change > tolerance) {
+    printf("✗ %s: %.1f ns/op，比基线 %.1f 慢 %.0f%%\n", name, result.nsPerOp, base.nsPerOp, change);
+    regressed = true;
+  } else if (change < -tolerance) {
+    printf("⚠ %s: 比基线快 %.0f%%，可以更新基线\n", name, -change);
+  }
+
+  // 发往屏幕的字节和命令数是确定的，任何增加都算回归
+  if (result.spiBytesPerOp > base.spiBytesPerOp + 0.5) {
+    printf("✗ %s: SPI字节 %.0f/op，基线 %.0f\n", name, result.spiBytesPerOp, base.spiBytesPerOp);
+    regressed = true;
+  }
+  if (result.commandsPerOp > base.commandsPerOp + 0.5) {
+    printf("✗ %s: 命令 %.0f/op，基线 %.0f\n", name, result.commandsPerOp, base.commandsPerOp);
+    regressed = true;
+  }
+  return regressed;
+}
+
+// ==================== 入口 ====================
+int main(int argc, char** argv) {
+  const char* filter = NULL;
+  const char* checkPath = NULL;
+  const char* writePath = NULL;
+  double minTimeMs = DEFAULT_MIN_TIME_MS;
+  double tolerance = DEFAULT_TOLERANCE;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      minTimeMs = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+      checkPath = argv[++i];
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+      writePath = argv[++i];
+    } else {
+      fprintf(stderr, "用法: %s [--filter S] [--min-time MS] [--check FILE] [--tolerance PCT] [--write-baseline FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::map<std::string, BenchResult> baseline;
+  if (checkPath != NULL && !readBaseline(checkPath, baseline)) {
+    fprintf(stderr, "无法读取基线文件 %s\n", checkPath);
+    return 2;
+  }
+
+  // 虚拟时钟：屏幕的 BUSY 等待和 delay() 不真实睡眠，只测CPU时间
+  halHostReset();
+  halHostSetSerialEcho(false);
+  halHostSetSpiSink(countSpiByte);
+
+  printf("%-32s %12s %14s %12s %12s\n", "Benchmark", "ns/op", "SPI bytes/op", "commands/op", "iterations");
+  std::map<std::string, BenchResult> results;
+  for (int i = 0; i < benchCount; i++) {
+    if (filter != NULL && strstr(benchCases[i].name, filter) == NULL) {
+      continue;
+    }
+    BenchResult result = measure(benchCases[i], minTimeMs);
+
+    std::map<std::string, BenchResult>::const_iterator base = baseline.find(benchCases[i].name);
+    for (int retry = 0; retry < BENCH_CHECK_RETRIES && base != baseline.end() &&
+         result.nsPerOp > base->second.nsPerOp * (1 + tolerance / 100); retry++) {
+      BenchResult again = measure(benchCases[i], minTimeMs);
+      if (again.nsPerOp < result.nsPerOp) {
+        result = again;
+      }
+    }
+    results[benchCases[i].name] = result;
+    printf("%-32s %12.1f %14.1f %12.1f %12llu\n", benchCases[i].name, result.nsPerOp,
+           result.spiBytesPerOp, result.commandsPerOp, (unsigned long long)result.iterations);
+  }
+
+  if (writePath != NULL) {
+    if (!writeBaseline(writePath, results)) {
+      fprintf(stderr, "无法写入基线文件 %s\n", writePath);
+      return 2;
+    }
+    printf("\n✓ 基线已写入 %s\n", writePath);
+  }
+
+  int regressions = 0;
+  if (checkPath != NULL) {
+    printf("\n与基线比较（允许 %.0f%%）:\n", tolerance);
+    for (std::map<std::string, BenchResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+      std::map<std::string, BenchResult>::const_iterator base = baseline.find(it->first);
+      if (base == baseline.end()) {
+        printf("⚠ %s: 基线中没有记录\n", it->first.c_str());
+        continue;
+      }
+      if (compareWithBaseline(it->first.c_str(), it->second, base->second, tolerance)) {
+        regressions++;
+      }
+    }
+    printf(regressions == 0 ? "✓ 没有性能回归\n" : "✗ %d 项性能回归\n", regressions);
+  }
+  return regressions;
+}
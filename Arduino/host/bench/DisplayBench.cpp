@@ -0,0 +1,30 @@
+/**
+ * DisplayBench.cpp - 完整屏幕更新（displaySensorData）基准
+ *
+ * 包含画布绘制、SetFrameMemory 写入和 DisplayFrame 刷新命令；
+ * BUSY 引脚在主机上始终空闲，结果只反映CPU和SPI传输量
+ */
+
+#include "BenchHarness.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+static Measurement prepareDisplay() {
+  initializeEPaper();
+  Measurement m = {};
+  m.temperature = 21.4;
+  m.pH = 7.12;
+  m.turbidity = 0.6;
+  m.tds = 182.5;
+  m.conductivity = 365.0;
+  m.validMask = MEAS_ALL_FIELDS;
+  gradeMeasurement(m);
+  return m;
+}
+
+BENCHMARK(display_sensor_data) {
+  Measurement m = prepareDisplay();
+  while (state.keepRunning()) {
+    displaySensorData(m);
+  }
+}
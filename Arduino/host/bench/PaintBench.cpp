@@ -0,0 +1,63 @@
+/**
+ * PaintBench.cpp - Paint 绘图原语基准
+ *
+ * 画布与 Display.cpp 相同：128 像素宽、1024 字节缓冲区
+ */
+
+#include "BenchHarness.h"
+#include "WaterMonitor.h"
+
+static unsigned char benchImage[1024];
+
+static Paint makePaint(int height) {
+  Paint paint(benchImage, 128, height);
+  paint.SetRotate(ROTATE_0);
+  return paint;
+}
+
+BENCHMARK(paint_clear) {
+  Paint paint = makePaint(64);
+  while (state.keepRunning()) {
+    paint.Clear(UNCOLORED);
+    benchDoNotOptimize(benchImage);
+  }
+}
+
+static void drawString(BenchState& state, sFONT* font) {
+  Paint paint = makePaint(32);
+  paint.Clear(UNCOLORED);
+  while (state.keepRunning()) {
+    paint.DrawStringAt(2, 2, "pH: 7.25", font, COLORED);
+    benchDoNotOptimize(benchImage);
+  }
+}
+
+BENCHMARK(paint_draw_string_font8)  { drawString(state, &Font8); }
+BENCHMARK(paint_draw_string_font12) { drawString(state, &Font12); }
+BENCHMARK(paint_draw_string_font16) { drawString(state, &Font16); }
+BENCHMARK(paint_draw_string_font20) { drawString(state, &Font20); }
+BENCHMARK(paint_draw_string_font24) { drawString(state, &Font24); }
+
+BENCHMARK(paint_draw_line) {
+  Paint paint = makePaint(64);
+  while (state.keepRunning()) {
+    paint.DrawLine(0, 0, 127, 63, COLORED);
+    benchDoNotOptimize(benchImage);
+  }
+}
+
+BENCHMARK(paint_draw_filled_rectangle) {
+  Paint paint = makePaint(64);
+  while (state.keepRunning()) {
+    paint.DrawFilledRectangle(4, 4, 123, 59, COLORED);
+    benchDoNotOptimize(benchImage);
+  }
+}
+
+BENCHMARK(paint_draw_circle) {
+  Paint paint = makePaint(64);
+  while (state.keepRunning()) {
+    paint.DrawCircle(64, 32, 30, COLORED);
+    benchDoNotOptimize(benchImage);
+  }
+}
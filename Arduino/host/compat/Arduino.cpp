@@ -0,0 +1,140 @@
+/**
+ * Arduino.cpp - 主机构建用的 Arduino API 兼容层实现
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <ArduinoLowPower.h>
+#include <ctype.h>
+#include "HalHost.h"
+
+// ==================== 全局对象 ====================
+Serial_ Serial;
+SPIClass SPI;
+ArduinoLowPowerClass LowPower;
+
+// ==================== 核心函数 ====================
+void yield() {
+  halHostIdle();
+}
+
+long random(long howBig) {
+  return howBig > 0 ? rand() % howBig : 0;
+}
+
+long random(long howSmall, long howBig) {
+  return howBig > howSmall ? howSmall + random(howBig - howSmall) : howSmall;
+}
+
+void randomSeed(unsigned long seed) {
+  srand((unsigned int)seed);
+}
+
+// ==================== String ====================
+static std::string formatUnsigned(unsigned long long value, unsigned char base) {
+  if (base < 2 || base > 16) {
+    base = 10;
+  }
+  char buffer[66];
+  char* p = buffer + sizeof(buffer) - 1;
+  *p = '\0';
+  do {
+    *--p = "0123456789ABCDEF"[value % base];
+    value /= base;
+  } while (value > 0);
+  return std::string(p);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+  if (value < 0 && base == DEC) {
+    return "-" + formatUnsigned((unsigned long long)(-value), base);
+  }
+  return formatUnsigned((unsigned long long)value, base);
+}
+
+static std::string formatFloat(double value, int digits) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return std::string(buffer);
+}
+
+String::String(int value, unsigned char base) : value_(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : value_(formatUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : value_(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : value_(formatUnsigned(value, base)) {}
+String::String(double value, unsigned char decimals) : value_(formatFloat(value, decimals)) {}
+
+int String::indexOf(const char* text) const {
+  size_t pos = value_.find(text);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+  return from < value_.size() ? String(value_.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (to > value_.size()) {
+    to = value_.size();
+  }
+  return from < to ? String(value_.substr(from, to - from)) : String();
+}
+
+void String::toCharArray(char* buffer, unsigned int size) const {
+  if (size == 0) {
+    return;
+  }
+  strncpy(buffer, value_.c_str(), size - 1);
+  buffer[size - 1] = '\0';
+}
+
+void String::toLowerCase() {
+  for (size_t i = 0; i < value_.size(); i++) {
+    value_[i] = (char)tolower((unsigned char)value_[i]);
+  }
+}
+
+void String::toUpperCase() {
+  for (size_t i = 0; i < value_.size(); i++) {
+    value_[i] = (char)toupper((unsigned char)value_[i]);
+  }
+}
+
+void String::trim() {
+  size_t begin = value_.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    value_.clear();
+    return;
+  }
+  size_t end = value_.find_last_not_of(" \t\r\n");
+  value_ = value_.substr(begin, end - begin + 1);
+}
+
+// ==================== Print ====================
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(long value, int base) {
+  return write(formatSigned(value, base).c_str());
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return write(formatUnsigned(value, base).c_str());
+}
+
+size_t Print::print(long long value, int base) {
+  return write(formatSigned(value, base).c_str());
+}
+
+size_t Print::print(unsigned long long value, int base) {
+  return write(formatUnsigned(value, base).c_str());
+}
+
+size_t Print::print(double value, int digits) {
+  return write(formatFloat(value, digits).c_str());
+}
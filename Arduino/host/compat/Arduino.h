@@ -0,0 +1,179 @@
+/**
+ * Arduino.h - 主机构建用的 Arduino API 兼容层
+ *
+ * 只实现固件实际用到的部分：引脚/时钟函数转发到 Hal.h，
+ * Serial 的格式化输出经 halSerialWrite() 写出，String 只用于调试包装和 MKRWAN 接口
+ * 不追求与 Arduino 核心库逐字节一致，数值格式与 Print 类保持相同
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "Hal.h"
+#include "avr/pgmspace.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ==================== 常量 ====================
+#define HIGH          1
+#define LOW           0
+
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+
+#define CHANGE        2
+#define FALLING       3
+#define RISING        4
+
+#define DEC           10
+#define HEX           16
+#define OCT           8
+#define BIN           2
+
+// MKR WAN 1310 的模拟引脚编号
+#define A0            15
+#define A1            16
+#define A2            17
+#define A3            18
+#define A4            19
+#define A5            20
+#define A6            21
+#define LED_BUILTIN   6
+
+#define F(string_literal) (string_literal)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define digitalPinToInterrupt(pin) (pin)
+
+// ==================== 核心函数 ====================
+inline unsigned long millis() { return halMillis(); }
+inline unsigned long micros() { return halMicros(); }
+inline void delay(unsigned long ms) { halDelay(ms); }
+inline void delayMicroseconds(unsigned int) {}
+
+inline void pinMode(uint8_t pin, uint8_t mode) { halPinMode(pin, mode); }
+inline void digitalWrite(uint8_t pin, uint8_t value) { halDigitalWrite(pin, value); }
+inline int digitalRead(uint8_t pin) { return halDigitalRead(pin); }
+inline int analogRead(uint8_t pin) { return halAnalogRead(pin); }
+inline void analogReadResolution(int) {}
+inline void attachInterrupt(uint8_t pin, HalIsr isr, int mode) { halAttachInterrupt(pin, isr, mode); }
+
+// 主机端没有真正的中断并发，模拟的中断在 halHostSetPin() 中同步调用
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+void yield();
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// ==================== String ====================
+class String {
+public:
+  String(const char* text = "") : value_(text ? text : "") {}
+  String(const std::string& text) : value_(text) {}
+  explicit String(char c) : value_(1, c) {}
+  explicit String(int value, unsigned char base = DEC);
+  explicit String(unsigned int value, unsigned char base = DEC);
+  explicit String(long value, unsigned char base = DEC);
+  explicit String(unsigned long value, unsigned char base = DEC);
+  explicit String(double value, unsigned char decimals = 2);
+
+  const char* c_str() const { return value_.c_str(); }
+  unsigned int length() const { return value_.size(); }
+  char operator[](unsigned int index) const { return index < value_.size() ? value_[index] : 0; }
+
+  int indexOf(const char* text) const;
+  int indexOf(const String& text) const { return indexOf(text.c_str()); }
+  bool startsWith(const char* prefix) const { return value_.compare(0, strlen(prefix), prefix) == 0; }
+  String substring(unsigned int from) const;
+  String substring(unsigned int from, unsigned int to) const;
+  long toInt() const { return atol(value_.c_str()); }
+  void toCharArray(char* buffer, unsigned int size) const;
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+  bool reserve(unsigned int size) { value_.reserve(size); return true; }
+
+  bool operator==(const String& other) const { return value_ == other.value_; }
+  bool operator==(const char* other) const { return value_ == other; }
+  bool operator!=(const String& other) const { return value_ != other.value_; }
+  bool operator!=(const char* other) const { return value_ != other; }
+  String& operator+=(const String& other) { value_ += other.value_; return *this; }
+  String& operator+=(const char* other) { value_ += other; return *this; }
+  String& operator+=(char c) { value_ += c; return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.value_ + b.value_); }
+  friend String operator+(const String& a, const char* b) { return String(a.value_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.value_); }
+
+private:
+  std::string value_;
+};
+
+// ==================== Print / Stream ====================
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(long long value, int base = DEC);
+  size_t print(unsigned long long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <typename T>
+  size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() { return -1; }
+  void setTimeout(unsigned long) {}
+};
+
+// 对应 SAMD 核心的 USB CDC 串口
+class Serial_ : public Stream {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  operator bool() { return halSerialHostAttached(); }
+  bool dtr() { return halSerialHostAttached(); }
+
+  int available() override { return halSerialAvailable(); }
+  int read() override { return halSerialRead(); }
+  size_t write(uint8_t c) override { return halSerialWrite(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override { return halSerialWrite(buffer, size); }
+  int availableForWrite() override { return halSerialAvailableForWrite(); }
+  using Print::write;
+};
+
+extern Serial_ Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,25 @@
+/**
+ * ArduinoLowPower.h - 主机构建用的低功耗兼容层
+ *
+ * 定时睡眠让时钟前进相应时间；无限期睡眠立即返回，相当于一次没有按钮边沿的唤醒
+ */
+
+#ifndef HOST_ARDUINO_LOW_POWER_H
+#define HOST_ARDUINO_LOW_POWER_H
+
+#include <Arduino.h>
+
+class ArduinoLowPowerClass {
+public:
+  void idle() {}
+  void idle(uint32_t ms) { halDelay(ms); }
+  void sleep() {}
+  void sleep(uint32_t ms) { halDelay(ms); }
+  void deepSleep() {}
+  void deepSleep(uint32_t ms) { halDelay(ms); }
+  void attachInterruptWakeup(uint32_t pin, HalIsr isr, uint32_t mode) { halAttachInterrupt(pin, isr, mode); }
+};
+
+extern ArduinoLowPowerClass LowPower;
+
+#endif // HOST_ARDUINO_LOW_POWER_H
@@ -0,0 +1,29 @@
+/**
+ * DallasTemperature.h - 主机构建用的 DS18B20 模拟
+ *
+ * 温度值由 halHostSetTemperatureC() 或温度源设置，DEVICE_DISCONNECTED_C 表示未接传感器
+ */
+
+#ifndef HOST_DALLAS_TEMPERATURE_H
+#define HOST_DALLAS_TEMPERATURE_H
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include "HalHost.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+class DallasTemperature {
+public:
+  explicit DallasTemperature(OneWire*) {}
+
+  void begin() {}
+  uint8_t getDeviceCount() { return halHostGetTemperatureC() == DEVICE_DISCONNECTED_C ? 0 : 1; }
+  void setResolution(uint8_t) {}
+  void setWaitForConversion(bool) {}
+  bool isConversionComplete() { return true; }
+  void requestTemperatures() {}
+  float getTempCByIndex(uint8_t) { return halHostGetTemperatureC(); }
+};
+
+#endif // HOST_DALLAS_TEMPERATURE_H
@@ -0,0 +1,26 @@
+/**
+ * FlashStorage.h - 主机构建用的 FlashStorage 兼容层
+ *
+ * 数据只保存在进程内存中，进程退出即丢失；未写入时读出全零，与擦除后的Flash行为一致
+ */
+
+#ifndef HOST_FLASH_STORAGE_H
+#define HOST_FLASH_STORAGE_H
+
+#include <Arduino.h>
+
+template <class T>
+class FlashStorageClass {
+public:
+  FlashStorageClass() { memset(&value_, 0, sizeof(T)); }
+
+  T read() { return value_; }
+  void write(T data) { value_ = data; }
+
+private:
+  T value_;
+};
+
+#define FlashStorage(name, T) FlashStorageClass<T> name
+
+#endif // HOST_FLASH_STORAGE_H
@@ -0,0 +1,107 @@
+/**
+ * MKRWAN.h - 主机构建用的 LoRaModem 模拟
+ *
+ * 实现固件用到的 MKRWAN 接口子集：入网总是成功（可配置），
+ * 上行帧记录在 uplinks 中供测试检查，下行数据用 queueDownlink() 注入
+ * 帧计数、端口、数据速率等状态与真实模块的行为一致
+ */
+
+#ifndef HOST_MKRWAN_H
+#define HOST_MKRWAN_H
+
+#include <Arduino.h>
+#include <vector>
+
+enum _lora_band { AS923 = 0, AU915, CN470, CN779, EU433, EU868, KR920, IN865, US915 };
+
+struct HostUplink {
+  uint8_t port;
+  bool confirmed;
+  uint32_t fcnt;
+  std::vector<uint8_t> payload;
+};
+
+class LoRaModem : public Stream {
+public:
+  // ==================== 模块与入网 ====================
+  int begin(_lora_band) { return 1; }
+  String version() { return String("host-sim"); }
+  String deviceEUI() { return String("0000000000000000"); }
+
+  int joinOTAA(const char*, const char*, const char* = NULL, uint32_t = 60000) { joinCount++; return joinResult; }
+  int joinOTAA(String, String, String = "", uint32_t = 60000) { joinCount++; return joinResult; }
+  int joinABP(String, String, String) { return joinResult; }
+
+  String getDevAddr() { return String("26011234"); }
+  String getNwkSKey() { return String("00112233445566778899AABBCCDDEEFF"); }
+  String getAppSKey() { return String("FFEEDDCCBBAA99887766554433221100"); }
+
+  // ==================== 参数 ====================
+  bool dataRate(uint8_t dr) { dataRate_ = dr; return dr <= 5; }
+  int getDataRate() { return dataRate_; }
+  bool setADR(bool enable) { adr_ = enable; return true; }
+  int getADR() { return adr_ ? 1 : 0; }
+  bool setPort(uint8_t port) { port_ = port; return true; }
+  int getFCU() { return (int)fcntUp_; }
+  int getFCD() { return (int)fcntDown_; }
+  bool setFCU(uint16_t fcnt) { fcntUp_ = fcnt; return true; }
+  bool setFCD(uint16_t fcnt) { fcntDown_ = fcnt; return true; }
+  bool sleep(bool on = true) { sleeping = on; return true; }
+
+  // ==================== 上行 ====================
+  int beginPacket() { txBuffer_.clear(); return 1; }
+  size_t write(uint8_t c) override { txBuffer_.push_back(c); return 1; }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    txBuffer_.insert(txBuffer_.end(), buffer, buffer + size);
+    return size;
+  }
+  using Print::write;
+
+  // 成功时返回发送的字节数，失败返回 sendResult（负数错误码）
+  int endPacket(bool confirmed = false) {
+    if (sendResult <= 0) {
+      return sendResult;
+    }
+    HostUplink uplink = {port_, confirmed, fcntUp_, txBuffer_};
+    uplinks.push_back(uplink);
+    fcntUp_++;
+    return (int)txBuffer_.size();
+  }
+
+  // ==================== 下行 ====================
+  void queueDownlink(const uint8_t* data, size_t length) {
+    rxBuffer_.insert(rxBuffer_.end(), data, data + length);
+    fcntDown_++;
+  }
+  int available() override { return (int)(rxBuffer_.size() - rxIndex_); }
+  int read() override {
+    if (rxIndex_ >= rxBuffer_.size()) {
+      return -1;
+    }
+    int c = rxBuffer_[rxIndex_++];
+    if (rxIndex_ == rxBuffer_.size()) {
+      rxBuffer_.clear();
+      rxIndex_ = 0;
+    }
+    return c;
+  }
+
+  // ==================== 模拟控制 ====================
+  int joinResult = 1;
+  int joinCount = 0;          // OTAA入网尝试次数
+  int sendResult = 1;
+  bool sleeping = false;
+  std::vector<HostUplink> uplinks;
+
+private:
+  uint8_t dataRate_ = 0;
+  bool adr_ = false;
+  uint8_t port_ = 2;
+  uint32_t fcntUp_ = 0;
+  uint32_t fcntDown_ = 0;
+  std::vector<uint8_t> txBuffer_;
+  std::vector<uint8_t> rxBuffer_;
+  size_t rxIndex_ = 0;
+};
+
+#endif // HOST_MKRWAN_H
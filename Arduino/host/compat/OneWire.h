@@ -0,0 +1,18 @@
+/**
+ * OneWire.h - 主机构建用的 OneWire 兼容层（DS18B20 由 DallasTemperature.h 模拟）
+ */
+
+#ifndef HOST_ONEWIRE_H
+#define HOST_ONEWIRE_H
+
+#include <Arduino.h>
+
+class OneWire {
+public:
+  explicit OneWire(uint8_t pin) : pin_(pin) {}
+
+private:
+  uint8_t pin_;
+};
+
+#endif // HOST_ONEWIRE_H
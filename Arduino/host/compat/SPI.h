@@ -0,0 +1,30 @@
+/**
+ * SPI.h - 主机构建用的 SPI 兼容层
+ *
+ * 固件经 Hal.h 访问SPI，这里只保证 #include <SPI.h> 能编译，并转发到同一组函数
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+struct SPISettings {
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+public:
+  void begin() { halSpiBegin(); }
+  void end() { halSpiEnd(); }
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) { return halSpiTransfer(data); }
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
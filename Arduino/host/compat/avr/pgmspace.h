@@ -0,0 +1,16 @@
+/**
+ * avr/pgmspace.h - 主机构建用的 PROGMEM 兼容定义
+ *
+ * 与 SAMD 核心相同：常量本来就在可直接寻址的存储器中，读取即普通解引用
+ */
+
+#ifndef HOST_PGMSPACE_H
+#define HOST_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+#endif // HOST_PGMSPACE_H
@@ -0,0 +1,89 @@
+/**
+ * main.cpp - 固件的主机程序入口
+ *
+ * 运行 setup()，然后循环调用 loop()；标准输入的每一行作为串口命令送入固件
+ *
+ * 用法: water_host [--virtual] [--run-ms N] [--command "test"]... [--screen FILE] [--epd-report]
+ *   --virtual     使用虚拟时钟（空闲等待不真实睡眠，适合 perf/valgrind）
+ *   --run-ms N    固件时间经过 N 毫秒后退出
+ *   --command     启动后依次执行的串口命令，可重复
+ *   --screen      退出时把 E-Paper 面板画面写成 PBM 图像
+ *   --epd-report  退出时输出 E-Paper 每帧的SPI字节、BUSY时间和协议误用
+ *
+ * 使用 --screen 或 --epd-report 时接入控制器模拟，刷新期间 BUSY 按波形时长保持
+ */
+
+#include <Arduino.h>
+#include <poll.h>
+#include <unistd.h>
+#include "HalHost.h"
+#include "EpdSim.h"
+
+void setup();
+void loop();
+
+// 非阻塞读取标准输入，转发到模拟串口
+static bool pollStdin() {
+  struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+  if (poll(&fd, 1, 0) <= 0 || !(fd.revents & (POLLIN | POLLHUP))) {
+    return true;
+  }
+
+  char buffer[256];
+  ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
+  if (n <= 0) {
+    return false;  // 输入结束
+  }
+  buffer[n] = '\0';
+  halHostSerialInput(buffer);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  unsigned long runMs = 0;
+  bool stdinOpen = true;
+  const char* screenPath = NULL;
+  bool epdReport = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--virtual") == 0) {
+      halHostSetClockMode(HAL_CLOCK_VIRTUAL);
+    } else if (strcmp(argv[i], "--run-ms") == 0 && i + 1 < argc) {
+      runMs = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--command") == 0 && i + 1 < argc) {
+      halHostSerialInput(argv[++i]);
+      halHostSerialInput("\n");
+    } else if (strcmp(argv[i], "--screen") == 0 && i + 1 < argc) {
+      screenPath = argv[++i];
+    } else if (strcmp(argv[i], "--epd-report") == 0) {
+      epdReport = true;
+    } else {
+      fprintf(stderr, "用法: %s [--virtual] [--run-ms N] [--command CMD]... [--screen FILE] [--epd-report]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (screenPath != NULL || epdReport) {
+    epdSimAttach();
+  }
+
+  setup();
+  unsigned long start = millis();
+
+  while (runMs == 0 || millis() - start < runMs) {
+    if (stdinOpen) {
+      stdinOpen = pollStdin();
+    }
+    loop();
+  }
+  if (epdReport) {
+    epdSimPrintReport();
+  }
+  fflush(stdout);
+
+  if (screenPath != NULL && !epdSimWritePbm(EPD_SIM_PANEL, screenPath)) {
+    fprintf(stderr, "无法写入 %s\n", screenPath);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * ReplayMain.cpp - 传感器信号回放程序
+ *
+ * 用法: water_replay [--scenario NAME | --csv FILE] [--samples N] [--interval-ms N]
+ *                    [--seed N] [--out FILE] [--list]
+ *   --scenario     内置波形场景（默认 steady），--list 列出全部场景
+ *   --csv          回放录制的轨迹；未指定 --samples 时覆盖整段轨迹
+ *   --samples      样本数（默认 1440，即间隔1分钟的一天）
+ *   --interval-ms  采样间隔，模拟时间（默认 60000）
+ *   --seed         噪声与尖峰的随机种子（默认 1），相同参数的结果完全一致
+ *   --out          逐样本的读数、分级和上行载荷写到CSV
+ */
+
+#include <Arduino.h>
+#include "HalHost.h"
+#include "SensorSim.h"
+#include "Replay.h"
+
+static void printUsage(const char* program) {
+  fprintf(stderr, "用法: %s [--scenario NAME | --csv FILE] [--samples N] [--interval-ms N] "
+                  "[--seed N] [--out FILE] [--list]\n", program);
+}
+
+int main(int argc, char** argv) {
+  const char* scenario = "steady";
+  const char* csvPath = NULL;
+  const char* outPath = NULL;
+  uint32_t samples = 0;
+  uint32_t intervalMs = 60000;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      scenario = argv[++i];
+    } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+      csvPath = argv[++i];
+    } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+      samples = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+      intervalMs = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "--list") == 0) {
+      sensorSimPrintScenarios();
+      return 0;
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+  if (intervalMs == 0) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  halHostReset();
+  halHostSetSerialEcho(false);
+  sensorSimAttach(seed);
+
+  if (csvPath != NULL) {
+    if (!sensorSimLoadCsv(csvPath)) {
+      return 1;
+    }
+    if (samples == 0) {
+      samples = sensorSimTraceDurationMs() / intervalMs + 1;
+    }
+  } else if (!sensorSimLoadScenario(scenario)) {
+    fprintf(stderr, "✗ 未知场景: %s\n", scenario);
+    sensorSimPrintScenarios();
+    return 2;
+  }
+  if (samples == 0) {
+    samples = 1440;
+  }
+
+  FILE* out = NULL;
+  if (outPath != NULL) {
+    out = fopen(outPath, "w");
+    if (out == NULL) {
+      fprintf(stderr, "✗ 无法写入 %s\n", outPath);
+      return 1;
+    }
+  }
+
+  ReplayStats stats;
+  runReplay(samples, intervalMs, out, stats);
+  if (out != NULL) {
+    fclose(out);
+  }
+
+  printf("输入: %s\n", csvPath != NULL ? csvPath : scenario);
+  printReplayStats(stats);
+  return 0;
+}
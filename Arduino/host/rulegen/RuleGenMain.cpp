@@ -0,0 +1,153 @@
+/**
+ * RuleGenMain.cpp - 由固件规则表生成仪表盘的水质阈值模块
+ *
+ * 用法: water_rulegen [--out FILE | --check FILE]
+ *   无参数     输出到标准输出
+ *   --out      写入文件（仓库中的 utils/waterQualityRules.generated.js）
+ *   --check    与现有文件比较，不一致时返回 1；ctest 用它保证固件和仪表盘的阈值相同
+ *
+ * 规则（全部监管配置）来自 Arduino/water/WaterQualityRules.h，生成的
+ * gradeParameter / gradeWaterQuality 与固件的 gradeParameter() / assessWaterQuality() 逻辑一致
+ */
+
+#include "WaterQualityRules.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+static const char* const GRADE_NAMES[QUALITY_GRADE_COUNT] = {
+  "UNKNOWN", "EXCELLENT", "MARGINAL", "UNSAFE"
+};
+
+static void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void appendf(std::string& out, const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  out += buffer;
+}
+
+static std::string generateJs() {
+  std::string js;
+  js += "// utils/waterQualityRules.generated.js - 水质分级规则（自动生成，请勿手动修改）\n";
+  js += "//\n";
+  js += "// 来源: Arduino/water/WaterQualityRules.h\n";
+  js += "// 重新生成: build-host/water_rulegen --out utils/waterQualityRules.generated.js\n\n";
+
+  js += "export const GRADES = [";
+  for (int grade = 0; grade < QUALITY_GRADE_COUNT; grade++) {
+    appendf(js, "%s'%s'", grade ? ", " : "", GRADE_NAMES[grade]);
+  }
+  js += "]\n\n";
+
+  appendf(js, "export const DEFAULT_PROFILE = %d\n\n", DEFAULT_WATER_QUALITY_PROFILE);
+
+  js += "// 监管配置，下标即上行数据中的配置 id\n";
+  js += "// 闭区间 [min, max]；severity 是该参数最多能把总体等级拉低到的等级\n";
+  js += "export const WATER_QUALITY_PROFILES = [\n";
+  for (int p = 0; p < PROFILE_COUNT; p++) {
+    const WaterQualityProfile& profile = WATER_QUALITY_PROFILES[p];
+    appendf(js, "  {\n    id: %d,\n    name: '%s',\n    rules: {\n", p, profile.name);
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      const WaterQualityRule& rule = profile.rules[i];
+      appendf(js, "      %s: { unit: '%s', excellentMin: %g, excellentMax: %g, "
+                  "acceptableMin: %g, acceptableMax: %g, severity: '%s' }%s\n",
+              WATER_PARAMETER_INFO[i].key, WATER_PARAMETER_INFO[i].unit,
+              rule.bands.excellentMin, rule.bands.excellentMax,
+              rule.bands.acceptableMin, rule.bands.acceptableMax, GRADE_NAMES[rule.severity],
+              i + 1 < PARAM_COUNT ? "," : "");
+    }
+    appendf(js, "    }\n  }%s\n", p + 1 < PROFILE_COUNT ? "," : "");
+  }
+  js += "]\n\n";
+
+  js += "export const WATER_QUALITY_RULES = WATER_QUALITY_PROFILES[DEFAULT_PROFILE].rules\n\n";
+
+  js += "// 单参数分级；非数值按超出可接受范围处理（与固件对 NaN 的处理相同）\n";
+  js += "export const gradeParameter = (param, value, profile = DEFAULT_PROFILE) => {\n";
+  js += "  const rule = WATER_QUALITY_PROFILES[profile]?.rules[param]\n";
+  js += "  if (!rule) return 'UNKNOWN'\n";
+  js += "  const valid = typeof value === 'number' && !Number.isNaN(value)\n";
+  js += "  const excellent = valid && value >= rule.excellentMin && value <= rule.excellentMax\n";
+  js += "  const acceptable = valid && value >= rule.acceptableMin && value <= rule.acceptableMax\n";
+  js += "  const grade = 1 + (excellent ? 0 : 1) + (acceptable ? 0 : 1)\n";
+  js += "  return GRADES[Math.min(grade, GRADES.indexOf(rule.severity))]\n";
+  js += "}\n\n";
+
+  js += "// 总体等级取各参数中最差的一个，values 以规则名为键；未知配置返回 UNKNOWN\n";
+  js += "export const gradeWaterQuality = (values, profile = DEFAULT_PROFILE) => {\n";
+  js += "  if (!WATER_QUALITY_PROFILES[profile]) return 'UNKNOWN'\n";
+  js += "  let worst = 1\n";
+  js += "  for (const param of Object.keys(WATER_QUALITY_PROFILES[profile].rules)) {\n";
+  js += "    worst = Math.max(worst, GRADES.indexOf(gradeParameter(param, values[param], profile)))\n";
+  js += "  }\n";
+  js += "  return GRADES[worst]\n";
+  js += "}\n";
+  return js;
+}
+
+static bool readFile(const char* path, std::string& content) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  char buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content.append(buffer, length);
+  }
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* outPath = NULL;
+  const char* checkPath = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+      checkPath = argv[++i];
+    } else {
+      fprintf(stderr, "用法: %s [--out FILE | --check FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::string js = generateJs();
+
+  if (checkPath != NULL) {
+    std::string existing;
+    if (!readFile(checkPath, existing)) {
+      fprintf(stderr, "✗ 无法读取 %s\n", checkPath);
+      return 1;
+    }
+    if (existing != js) {
+      fprintf(stderr, "✗ %s 与 WaterQualityRules.h 不一致，请用 --out 重新生成\n", checkPath);
+      return 1;
+    }
+    printf("✓ %s 与规则表一致\n", checkPath);
+    return 0;
+  }
+
+  if (outPath != NULL) {
+    FILE* file = fopen(outPath, "wb");
+    if (file == NULL) {
+      fprintf(stderr, "✗ 无法写入 %s\n", outPath);
+      return 1;
+    }
+    fwrite(js.data(), 1, js.size(), file);
+    fclose(file);
+    printf("✓ 已生成 %s\n", outPath);
+    return 0;
+  }
+
+  fwrite(js.data(), 1, js.size(), stdout);
+  return 0;
+}
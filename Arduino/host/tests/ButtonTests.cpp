@@ -0,0 +1,88 @@
+/**
+ * ButtonTests.cpp - 按钮中断、防抖与手势识别（虚拟时钟）
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+#include "WaterMonitor.h"
+
+static int sensorRuns = 0;
+static int displayRuns = 0;
+static int loraRuns = 0;
+
+static void countSensors() { sensorRuns++; }
+static void countDisplay() { displayRuns++; }
+static void countLoRa() { loraRuns++; }
+
+// 冷却期已过、系统就绪，检测流程的任务只计数
+static void setUpButton() {
+  halHostAdvanceMillis(BUTTON_COOLDOWN * 2);
+  lastButtonPress = 0;
+  initializeButton();
+  setSystemReady(true);
+
+  sensorRuns = displayRuns = loraRuns = 0;
+  addTask(TASK_SENSORS, "sensors", countSensors, TASK_EVENT_ONLY);
+  addTask(TASK_DISPLAY, "display", countDisplay, TASK_EVENT_ONLY);
+  addTask(TASK_LORA, "lora", countLoRa, TASK_EVENT_ONLY);
+}
+
+// 按按钮任务的轮询周期推进时间
+static void pollButton(uint32_t ms) {
+  for (uint32_t elapsed = 0; elapsed < ms; elapsed += BUTTON_POLL_INTERVAL) {
+    halHostAdvanceMillis(BUTTON_POLL_INTERVAL);
+    handleButtonInput();
+  }
+  while (runScheduler()) {
+  }
+}
+
+static void click(uint32_t holdMs) {
+  halHostSetPin(BUTTON_PIN, LOW);
+  pollButton(holdMs);
+  halHostSetPin(BUTTON_PIN, HIGH);
+}
+
+TEST(short_press_starts_one_test) {
+  setUpButton();
+  click(100);
+  pollButton(BUTTON_DOUBLE_PRESS_GAP + 100);
+
+  CHECK_EQ(sensorRuns, 1);
+  CHECK(isCooldownPeriod());
+}
+
+TEST(contact_bounce_is_one_press) {
+  setUpButton();
+  for (int i = 0; i < 4; i++) {
+    halHostSetPin(BUTTON_PIN, LOW);
+    halHostAdvanceMillis(2);
+    halHostSetPin(BUTTON_PIN, HIGH);
+    halHostAdvanceMillis(2);
+  }
+  click(100);
+  pollButton(BUTTON_DOUBLE_PRESS_GAP + 100);
+
+  CHECK_EQ(sensorRuns, 1);
+}
+
+TEST(long_press_requests_full_refresh) {
+  setUpButton();
+  click(BUTTON_LONG_PRESS_MS + 100);
+  pollButton(BUTTON_DOUBLE_PRESS_GAP + 100);
+
+  CHECK_EQ(displayRuns, 1);
+  CHECK_EQ(sensorRuns, 0);
+}
+
+TEST(double_press_flushes_backlog) {
+  setUpButton();
+  click(80);
+  pollButton(100);
+  click(80);
+  pollButton(BUTTON_DOUBLE_PRESS_GAP + 100);
+
+  CHECK_EQ(loraRuns, 1);
+  CHECK_EQ(sensorRuns, 0);
+  backlogFlushRequested = false;
+}
@@ -0,0 +1,89 @@
+/**
+ * CommandTests.cpp - 串口命令行读取、切分与分发
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+#include "SerialCommands.h"
+
+#include <limits.h>
+#include <stdio.h>
+
+static int calls = 0;
+static CommandArgs lastArgs;
+static char lastValue[SERIAL_LINE_MAX];
+
+static void cmdRecord(const CommandArgs& args) {
+  calls++;
+  lastArgs = args;
+  lastValue[0] = '\0';
+  if (args.count > 0) {
+    strncpy(lastValue, args.values[0], sizeof(lastValue) - 1);
+  }
+}
+
+static const SerialCommand TEST_COMMANDS[] = {
+  SERIAL_COMMAND("record", cmdRecord, "测试命令"),
+};
+
+static void pollAll() {
+  for (int i = 0; i < 8; i++) {
+    pollSerialCommands(TEST_COMMANDS, 1);
+  }
+}
+
+TEST(command_hash_is_compile_time_fnv1a) {
+  static_assert(commandHash("") == 2166136261UL, "FNV-1a offset basis");
+  CHECK(commandHash("test") != commandHash("tset"));
+}
+
+TEST(command_line_is_lowercased_and_split) {
+  calls = 0;
+  halHostSerialInput("  RECORD   On  second\r\n");
+  pollAll();
+
+  CHECK_EQ(calls, 1);
+  CHECK_EQ(lastArgs.count, 2);
+  CHECK(strcmp(lastValue, "on") == 0);
+}
+
+TEST(partial_line_waits_for_newline) {
+  calls = 0;
+  halHostSerialInput("rec");
+  pollAll();
+  CHECK_EQ(calls, 0);
+
+  halHostSerialInput("ord\n");
+  pollAll();
+  CHECK_EQ(calls, 1);
+}
+
+TEST(unknown_command_is_reported) {
+  calls = 0;
+  halHostSerialInput("nosuchcommand\n");
+  pollAll();
+  CHECK_EQ(calls, 0);
+  CHECK(!halHostSerialOutput().empty());
+}
+
+TEST(on_off_argument_parsing) {
+  CommandArgs args = {2, {"on", "maybe"}};
+  bool value = false;
+  CHECK(parseOnOffArg(args, 0, value));
+  CHECK(value);
+  CHECK(!parseOnOffArg(args, 1, value));
+  CHECK(!parseOnOffArg(args, 2, value));
+}
+
+TEST(unsigned_argument_parsing_up_to_ulong_max) {
+  char maxText[24];
+  snprintf(maxText, sizeof(maxText), "%lu", ULONG_MAX);
+  CommandArgs args = {4, {"4294967295", maxText, "18446744073709551616", "12x"}};
+  unsigned long value = 0;
+  CHECK(parseUnsignedArg(args, 0, value));
+  CHECK_EQ(value, 4294967295UL);
+  CHECK(parseUnsignedArg(args, 1, value));
+  CHECK(value == ULONG_MAX);
+  CHECK(!parseUnsignedArg(args, 2, value));   // 超过 ULONG_MAX
+  CHECK(!parseUnsignedArg(args, 3, value));
+}
@@ -0,0 +1,116 @@
+/**
+ * DisplayGoldenTests.cpp - 显示布局与参考图像逐像素比较
+ *
+ * 参考图像在 tests/golden/ 下，是控制器 0x24 RAM 的 PBM 导出；
+ * 渲染或驱动优化后画面必须完全一致。确认画面变化是有意的之后，
+ * 用 WATER_UPDATE_GOLDEN=1 water_tests golden 重新生成参考图像
+ */
+
+#include "TestHarness.h"
+#include "EpdSim.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+#include <stdlib.h>
+#include <string>
+
+// 与参考图像比较；不一致时把实际画面写到当前目录的 <name>.actual.pbm
+static void checkGolden(const char* name) {
+  std::string golden = std::string(WATER_GOLDEN_DIR) + "/" + name + ".pbm";
+
+  const char* update = getenv("WATER_UPDATE_GOLDEN");
+  if (update != NULL && strcmp(update, "1") == 0) {
+    CHECK(epdSimWritePbm(EPD_SIM_PLANE_BW, golden.c_str()));
+    printf("  已更新 %s\n", golden.c_str());
+    return;
+  }
+
+  long diff = epdSimComparePbm(EPD_SIM_PLANE_BW, golden.c_str());
+  if (diff != 0) {
+    std::string actual = std::string(name) + ".actual.pbm";
+    epdSimWritePbm(EPD_SIM_PLANE_BW, actual.c_str());
+    if (diff < 0) {
+      printf("  缺少参考图像 %s\n", golden.c_str());
+    } else {
+      printf("  %ld 个像素不同，实际画面: %s\n", diff, actual.c_str());
+    }
+  }
+  CHECK_EQ(diff, 0);
+}
+
+static Measurement makeMeasurement(float temperature, float pH, float turbidity, float tds, float ec) {
+  Measurement m = {};
+  m.temperature = temperature;
+  m.pH = pH;
+  m.turbidity = turbidity;
+  m.tds = tds;
+  m.conductivity = ec;
+  m.validMask = MEAS_ALL_FIELDS;
+  gradeMeasurement(m);
+  return m;
+}
+
+static void startDisplay() {
+  resetParameterThresholds();
+  epdSimAttach();
+  initializeEPaper();
+}
+
+TEST(epd_sim_init_clears_both_planes) {
+  startDisplay();
+  int blackBytes = 0;
+  for (int i = 0; i < EPD_SIM_PLANE_BYTES; i++) {
+    if (epdSimPlane(EPD_SIM_PLANE_BW)[i] != 0xFF || epdSimPlane(EPD_SIM_PLANE_RED)[i] != 0xFF) {
+      blackBytes++;
+    }
+  }
+  CHECK_EQ(blackBytes, 0);
+  CHECK_EQ(epdSimRefreshCount(), 1u);
+}
+
+TEST(epd_sim_frame_memory_lands_at_window) {
+  startDisplay();
+  // 标题栏是 y=15 开始的24行黑底
+  CHECK(!epdSimPixelBlack(EPD_SIM_PLANE_BW, 0, 14));
+  showStartupScreen();
+  CHECK(epdSimPixelBlack(EPD_SIM_PLANE_BW, 0, 15));
+  CHECK(epdSimPixelBlack(EPD_SIM_PLANE_BW, 127, 38));
+  CHECK(!epdSimPixelBlack(EPD_SIM_PLANE_BW, 0, 39));
+  CHECK(!epdSimPixelBlack(EPD_SIM_PLANE_BW, 0, 14));
+}
+
+TEST(golden_startup_screen) {
+  startDisplay();
+  showStartupScreen();
+  checkGolden("startup");
+}
+
+TEST(golden_sensor_data_excellent) {
+  startDisplay();
+  Measurement m = makeMeasurement(21.4, 7.12, 0.6, 182.5, 365.0);
+  CHECK_EQ(m.assessment.overall, QUALITY_EXCELLENT);
+  displaySensorData(m);
+  checkGolden("sensor_excellent");
+}
+
+TEST(golden_sensor_data_marginal) {
+  startDisplay();
+  Measurement m = makeMeasurement(18.9, 6.31, 2.4, 182.5, 365.0);
+  CHECK_EQ(m.assessment.overall, QUALITY_MARGINAL);
+  displaySensorData(m);
+  checkGolden("sensor_marginal");
+}
+
+TEST(golden_sensor_data_unsafe) {
+  startDisplay();
+  Measurement m = makeMeasurement(25.2, 5.48, 6.3, 612.0, 1224.0);
+  CHECK_EQ(m.assessment.overall, QUALITY_UNSAFE);
+  displaySensorData(m);
+  checkGolden("sensor_unsafe");
+}
+
+TEST(golden_error_screen) {
+  startDisplay();
+  displayError("Sensor timeout");
+  checkGolden("error");
+}
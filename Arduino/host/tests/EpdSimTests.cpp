@@ -0,0 +1,117 @@
+/**
+ * EpdSimTests.cpp - E-Paper 控制器模拟的时序、帧统计与误用检测
+ */
+
+#include "TestHarness.h"
+#include "EpdSim.h"
+#include "HalHost.h"
+#include "WaterMonitor.h"
+
+// WS_20_30 波形：(28*2)+(40*2)+(29*2) = 194 帧
+#define FULL_WAVEFORM_US     (194UL * EPD_SIM_LUT_FRAME_US)
+// _WF_PARTIAL_2IN9 波形：10*3 + 1 + 1 = 32 帧
+#define PARTIAL_WAVEFORM_US  (32UL * EPD_SIM_LUT_FRAME_US)
+
+static void startDisplay() {
+  epdSimAttach();
+  initializeEPaper();
+}
+
+TEST(epd_sim_full_refresh_holds_busy_for_waveform) {
+  startDisplay();
+  CHECK_EQ(epdSimWaveformUs(false), FULL_WAVEFORM_US);
+
+  uint32_t start = micros();
+  epd.SendCommand(0x22);
+  epd.SendData(0xC7);
+  epd.SendCommand(0x20);
+  CHECK(epdSimBusy());
+  CHECK_EQ(digitalRead(BUSY_PIN), HIGH);
+
+  halHostAdvanceMicros(FULL_WAVEFORM_US - 1);
+  CHECK_EQ(digitalRead(BUSY_PIN), HIGH);
+  halHostAdvanceMicros(1);
+  CHECK_EQ(digitalRead(BUSY_PIN), LOW);
+  CHECK_EQ(micros() - start, FULL_WAVEFORM_US);
+}
+
+TEST(epd_sim_display_frame_waits_out_busy) {
+  startDisplay();
+  uint32_t start = micros();
+  displaySensorData(getLatestMeasurement());
+  CHECK(!epdSimBusy());
+  CHECK(micros() - start >= FULL_WAVEFORM_US);
+  CHECK_EQ(epdSimStats().misuseCount, 0u);
+}
+
+TEST(epd_sim_frame_stats_cover_one_update) {
+  startDisplay();
+  displaySensorData(getLatestMeasurement());
+  uint32_t spiBefore = halHostSpiByteCount();
+  displaySensorData(getLatestMeasurement());
+
+  CHECK_EQ(epdSimStats().frames, 3u);
+  const EpdSimFrame* frame = epdSimFrame(0);
+  CHECK(frame != NULL);
+  CHECK(!frame->partial);
+  CHECK_EQ(frame->updateSequence, 0xC7);
+  CHECK_EQ(frame->busyUs, FULL_WAVEFORM_US);
+  CHECK_EQ(frame->misuse, 0);
+  CHECK_EQ(frame->spiBytes, halHostSpiByteCount() - spiBefore);
+  // 清屏写两个平面 + 标题24行 + 5行数据*20 + 状态32行 + 底部50行
+  CHECK_EQ(frame->ramBytes, 2u * EPD_SIM_PLANE_BYTES + (24 + 5 * 20 + 32 + 50) * EPD_SIM_ROW_BYTES);
+}
+
+TEST(epd_sim_partial_refresh_uses_partial_waveform) {
+  startDisplay();
+  paint.SetRotate(ROTATE_0);
+  paint.SetWidth(128);
+  paint.SetHeight(20);
+  paint.Clear(COLORED);
+  epd.SetFrameMemory_Partial(paint.GetImage(), 0, 100, paint.GetWidth(), paint.GetHeight());
+  epd.DisplayFrame_Partial();
+
+  const EpdSimFrame* frame = epdSimFrame(0);
+  CHECK(frame != NULL);
+  CHECK(frame->partial);
+  CHECK_EQ(epdSimStats().partialRefreshes, 1u);
+  CHECK_EQ(epdSimWaveformUs(true), PARTIAL_WAVEFORM_US);
+  // 局部刷新前的 0xC0 上电序列也计入BUSY时间
+  CHECK_EQ(frame->busyUs, EPD_SIM_POWER_SEQUENCE_US + PARTIAL_WAVEFORM_US);
+  CHECK(epdSimPixelBlack(EPD_SIM_PANEL, 0, 100));
+  CHECK_EQ(epdSimStats().misuseCount, 0u);
+}
+
+TEST(epd_sim_flags_write_while_busy) {
+  startDisplay();
+  epd.SendCommand(0x22);
+  epd.SendData(0xC7);
+  epd.SendCommand(0x20);
+  epd.SendCommand(0x24);   // 没有等待 BUSY
+  CHECK(epdSimStats().misuse & EPD_SIM_MISUSE_WRITE_WHILE_BUSY);
+}
+
+TEST(epd_sim_flags_write_while_asleep_until_reset) {
+  startDisplay();
+  sleepDisplay();
+  CHECK(epdSimAsleep());
+  epd.SendCommand(0x24);
+  CHECK(epdSimStats().misuse & EPD_SIM_MISUSE_WRITE_WHILE_ASLEEP);
+
+  // wakeDisplay 的硬件复位退出深度睡眠
+  uint32_t misuseCount = epdSimStats().misuseCount;
+  displaySensorData(getLatestMeasurement());
+  CHECK(!epdSimAsleep());
+  CHECK_EQ(epdSimStats().misuseCount, misuseCount);
+}
+
+TEST(epd_sim_flags_short_lut_and_missing_update_sequence) {
+  epdSimAttach();
+  epd.SendCommand(0x32);
+  epd.SendData(0x00);
+  epd.SendCommand(0x20);
+  CHECK(epdSimStats().misuse & EPD_SIM_MISUSE_LUT_LENGTH);
+  CHECK(epdSimStats().misuse & EPD_SIM_MISUSE_NO_UPDATE_SEQUENCE);
+  // 未加载完整LUT时使用OTP波形时长
+  CHECK_EQ(epdSimWaveformUs(false), (uint32_t)EPD_SIM_OTP_FULL_US);
+}
@@ -0,0 +1,185 @@
+/**
+ * LoRaTests.cpp - 上行编码与模拟调制解调器收发
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+static const WaterQualityPacket SAMPLE_PACKET = {2567, 745, 153, 3000, 1500, PROFILE_BOTTLED, 0};
+
+TEST(legacy_payload_is_ten_big_endian_fields_and_profile) {
+  setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+  uint8_t buffer[LORA_MAX_PAYLOAD_SIZE];
+  int length = encodeWaterQualityPayload(SAMPLE_PACKET, 0, buffer, sizeof(buffer));
+
+  const uint8_t expected[11] = {0x0A, 0x07, 0x02, 0xE9, 0x00, 0x99, 0x0B, 0xB8, 0x05, 0xDC, PROFILE_BOTTLED};
+  CHECK_EQ(length, 11);
+  CHECK(memcmp(buffer, expected, sizeof(expected)) == 0);
+}
+
+TEST(unsettled_flag_shares_profile_byte) {
+  setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+  WaterQualityPacket packet = SAMPLE_PACKET;
+  packet.flags = PACKET_FLAG_UNSETTLED;
+  uint8_t buffer[LORA_MAX_PAYLOAD_SIZE];
+  CHECK_EQ(encodeWaterQualityPayload(packet, 0, buffer, sizeof(buffer)), 11);
+  CHECK_EQ(buffer[10], PROFILE_BOTTLED | PACKET_FLAG_UNSETTLED);
+}
+
+TEST(redundant_payload_starts_with_version_header) {
+  setPayloadFormat(PAYLOAD_FORMAT_REDUNDANT);
+  uint8_t buffer[LORA_MAX_PAYLOAD_SIZE];
+  int length = encodeWaterQualityPayload(SAMPLE_PACKET, 0, buffer, sizeof(buffer));
+
+  CHECK(length >= 12);
+  CHECK_EQ(buffer[0] >> 4, REDUNDANT_PAYLOAD_VERSION);
+  CHECK_EQ(buffer[1], PROFILE_BOTTLED);
+  CHECK_EQ(buffer[2], 0x0A);
+  CHECK_EQ(buffer[3], 0x07);
+  setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+}
+
+TEST(send_packet_reaches_modem_on_legacy_port) {
+  setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+  loraConnected = true;
+  loraModem.sendResult = 1;
+  loraModem.uplinks.clear();
+
+  CHECK(sendDataPacket(SAMPLE_PACKET, false));
+  CHECK_EQ(loraModem.uplinks.size(), 1u);
+  CHECK_EQ(loraModem.uplinks[0].port, LORA_PORT_LEGACY);
+  CHECK_EQ(loraModem.uplinks[0].payload.size(), 11u);
+  CHECK(!loraModem.uplinks[0].confirmed);
+}
+
+TEST(send_failure_is_reported) {
+  loraConnected = true;
+  loraModem.sendResult = -1;
+  loraModem.uplinks.clear();
+
+  CHECK(!sendDataPacket(SAMPLE_PACKET, false));
+  CHECK(loraModem.uplinks.empty());
+  loraModem.sendResult = 1;
+}
+
+TEST(failed_confirmed_uplinks_rejoin_on_next_uplink) {
+  setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+  loraInitialized = true;
+  loraConnected = true;
+  loraModem.joinResult = 1;
+  loraModem.sendResult = -1;
+  for (int i = 0; i < LORA_SESSION_MAX_FAILED_CONFIRMED; i++) {
+    sendDataPacket(SAMPLE_PACKET, true);
+  }
+  CHECK(loraConnected);           // 上行路径不会因此停止
+  CHECK(loraRejoinPending);
+  CHECK(!hasStoredLoRaSession());
+
+  // 下一次定时上行先重新OTAA入网再发送
+  int joins = loraModem.joinCount;
+  loraModem.sendResult = 1;
+  loraModem.uplinks.clear();
+  CHECK(sendWaterQualityData(readAllSensors()));
+  CHECK_EQ(loraModem.joinCount, joins + 1);
+  CHECK(!loraRejoinPending);
+  CHECK_EQ(loraModem.uplinks.size(), 1u);
+  flushLoRaBacklog(LORA_BACKLOG_SIZE);
+}
+
+TEST(offline_device_rejoins_in_background_with_backoff) {
+  loraInitialized = true;
+  loraModem.joinResult = 0;
+  invalidateLoRaSession();
+  int joins = loraModem.joinCount;
+  CHECK(!reconnectLoRa());
+  CHECK(!loraConnected);
+
+  // 首次间隔未到不重试，到期后重试；失败后间隔翻倍
+  CHECK(!maintainLoRaConnection());
+  CHECK_EQ(loraModem.joinCount, joins + 1);
+  halHostAdvanceMillis(2 * LORA_REJOIN_MIN_BACKOFF_MS);
+  CHECK(!maintainLoRaConnection());
+  CHECK_EQ(loraModem.joinCount, joins + 2);
+  halHostAdvanceMillis(2 * LORA_REJOIN_MIN_BACKOFF_MS);
+  CHECK(!maintainLoRaConnection());
+  CHECK_EQ(loraModem.joinCount, joins + 2);
+
+  loraModem.joinResult = 1;
+  halHostAdvanceMillis(2 * LORA_REJOIN_MIN_BACKOFF_MS);
+  CHECK(maintainLoRaConnection());
+  CHECK_EQ(loraModem.joinCount, joins + 3);
+  CHECK(loraConnected);
+}
+
+TEST(downlink_sets_uplink_interval) {
+  // 类型 + 长度 + uint32 秒（大端）
+  const uint8_t downlink[] = {DL_SET_UPLINK_INTERVAL, 4, 0x00, 0x00, 0x01, 0x2C};
+  CHECK_EQ(processDownlink(downlink, sizeof(downlink)), 1);
+  CHECK_EQ(loraSendInterval, 300000UL);
+}
+
+TEST(downlink_sets_conductivity_band_above_int16_centi_range) {
+  // 电导率按 x1 编码：优秀 100-600，可接受 50-1500 μS/cm
+  const uint8_t downlink[] = {DL_SET_THRESHOLDS, 9, PARAM_EC,
+                              0x00, 0x64, 0x02, 0x58, 0x00, 0x32, 0x05, 0xDC};
+  CHECK_EQ(processDownlink(downlink, sizeof(downlink)), 1);
+  const ParameterThresholds& bands = activeWaterQualityRules[PARAM_EC].bands;
+  CHECK_NEAR(bands.excellentMin, 100.0, 1e-3);
+  CHECK_NEAR(bands.excellentMax, 600.0, 1e-3);
+  CHECK_NEAR(bands.acceptableMin, 50.0, 1e-3);
+  CHECK_NEAR(bands.acceptableMax, 1500.0, 1e-3);
+
+  // pH 仍按 x100：优秀 6.80-7.60
+  const uint8_t ph[] = {DL_SET_THRESHOLDS, 9, PARAM_PH,
+                        0x02, 0xA8, 0x02, 0xF8, 0x02, 0x8A, 0x03, 0x52};
+  CHECK_EQ(processDownlink(ph, sizeof(ph)), 1);
+  CHECK_NEAR(activeWaterQualityRules[PARAM_PH].bands.excellentMin, 6.8, 1e-3);
+  CHECK_NEAR(activeWaterQualityRules[PARAM_PH].bands.acceptableMax, 8.5, 1e-3);
+  resetParameterThresholds();
+}
+
+TEST(downlink_with_bad_length_is_rejected_whole) {
+  unsigned long before = loraSendInterval;
+  const uint8_t downlink[] = {DL_SET_UPLINK_INTERVAL, 4, 0x00, 0x00, 0x02, 0x58, DL_SET_AUTOSEND, 2, 1, 0};
+  CHECK_EQ(processDownlink(downlink, sizeof(downlink)), 0);
+  CHECK_EQ(loraSendInterval, before);
+}
+
+TEST(packet_carries_active_profile) {
+  setWaterQualityProfile(PROFILE_RECREATIONAL, false);
+  CHECK_EQ(packWaterQualityData(readAllSensors()).profile, PROFILE_RECREATIONAL);
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, false);
+  CHECK_EQ(packWaterQualityData(readAllSensors()).profile, PROFILE_DRINKING);
+}
+
+TEST(downlink_configures_periodic_sampling) {
+  // 开启，间隔 1800 秒
+  const uint8_t enable[] = {DL_SET_SAMPLING, 5, 1, 0x00, 0x00, 0x07, 0x08};
+  CHECK_EQ(processDownlink(enable, sizeof(enable)), 1);
+  CHECK(periodicSamplingEnabled);
+  CHECK_EQ(samplingIntervalMs, 1800000UL);
+
+  // 间隔超出范围时整条命令不生效
+  const uint8_t tooShort[] = {DL_SET_SAMPLING, 5, 0, 0x00, 0x00, 0x00, 0x0A};
+  CHECK_EQ(processDownlink(tooShort, sizeof(tooShort)), 0);
+  CHECK(periodicSamplingEnabled);
+
+  const uint8_t disable[] = {DL_SET_SAMPLING, 5, 0, 0x00, 0x00, 0x0E, 0x10};
+  CHECK_EQ(processDownlink(disable, sizeof(disable)), 1);
+  CHECK(!periodicSamplingEnabled);
+  CHECK_EQ(samplingIntervalMs, 3600000UL);
+}
+
+TEST(downlink_selects_profile) {
+  const uint8_t select[] = {DL_SET_PROFILE, 1, PROFILE_IN_HOUSE};
+  CHECK_EQ(processDownlink(select, sizeof(select)), 1);
+  CHECK_EQ(getWaterQualityProfile(), PROFILE_IN_HOUSE);
+
+  const uint8_t invalid[] = {DL_SET_PROFILE, 1, PROFILE_COUNT};
+  CHECK_EQ(processDownlink(invalid, sizeof(invalid)), 0);
+  CHECK_EQ(getWaterQualityProfile(), PROFILE_IN_HOUSE);
+
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, true);
+}
@@ -0,0 +1,117 @@
+/**
+ * QualityTests.cpp - 水质分级与阈值管理
+ */
+
+#include "TestHarness.h"
+#include "WaterQualityLED.h"
+
+TEST(quality_excellent_when_all_parameters_excellent) {
+  resetParameterThresholds();
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.5, 200, 300), QUALITY_EXCELLENT);
+}
+
+TEST(quality_marginal_when_one_parameter_only_acceptable) {
+  resetParameterThresholds();
+  CHECK_EQ(evaluateWaterQuality(6.2, 0.5, 200, 300), QUALITY_MARGINAL);
+  CHECK_EQ(evaluateWaterQuality(7.2, 2.0, 200, 300), QUALITY_MARGINAL);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.5, 450, 300), QUALITY_MARGINAL);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.5, 200, 700), QUALITY_MARGINAL);
+}
+
+TEST(quality_unsafe_when_any_parameter_out_of_range) {
+  resetParameterThresholds();
+  CHECK_EQ(evaluateWaterQuality(5.5, 0.5, 200, 300), QUALITY_UNSAFE);
+  CHECK_EQ(evaluateWaterQuality(7.2, 4.5, 200, 300), QUALITY_UNSAFE);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.5, 40, 300), QUALITY_UNSAFE);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.5, 200, 900), QUALITY_UNSAFE);
+}
+
+TEST(quality_boundaries_are_inclusive) {
+  resetParameterThresholds();
+  CHECK_EQ(evaluateWaterQuality(WATER_QUALITY_RULES[PARAM_PH].bands.excellentMin, 0.5, 200, 300), QUALITY_EXCELLENT);
+  CHECK_EQ(evaluateWaterQuality(WATER_QUALITY_RULES[PARAM_PH].bands.acceptableMax, 0.5, 200, 300), QUALITY_MARGINAL);
+  CHECK_EQ(evaluateWaterQuality(7.2, WATER_QUALITY_RULES[PARAM_TURBIDITY].bands.acceptableMax, 200, 300), QUALITY_MARGINAL);
+}
+
+TEST(thresholds_reject_inverted_ranges) {
+  resetParameterThresholds();
+  ParameterThresholds inverted = {8.0, 6.5, 6.0, 9.0};
+  CHECK(!setParameterThresholds(PARAM_PH, inverted));
+  CHECK(!setParameterThresholds(PARAM_COUNT, inverted));
+
+  ParameterThresholds strict = {7.0, 7.5, 6.8, 7.8};
+  CHECK(setParameterThresholds(PARAM_PH, strict));
+  CHECK_EQ(evaluateWaterQuality(6.9, 0.5, 200, 300), QUALITY_MARGINAL);
+
+  resetParameterThresholds();
+  CHECK_EQ(evaluateWaterQuality(6.9, 0.5, 200, 300), QUALITY_EXCELLENT);
+}
+
+TEST(quality_names_cover_every_grade) {
+  CHECK(strcmp(getWaterQualityName(QUALITY_EXCELLENT), "EXCELLENT") == 0);
+  CHECK(strcmp(getWaterQualityName(QUALITY_UNSAFE), "UNSAFE") == 0);
+  CHECK(strcmp(getWaterQualityName(99), "UNKNOWN") == 0);
+}
+
+TEST(assessment_reports_every_parameter_in_one_pass) {
+  resetParameterThresholds();
+  const float values[PARAM_COUNT] = {7.2, 2.0, 40, 300};
+  WaterQualityAssessment assessment;
+  assessWaterQuality(values, assessment);
+  CHECK_EQ(assessment.grades[PARAM_PH], QUALITY_EXCELLENT);
+  CHECK_EQ(assessment.grades[PARAM_TURBIDITY], QUALITY_MARGINAL);
+  CHECK_EQ(assessment.grades[PARAM_TDS], QUALITY_UNSAFE);
+  CHECK_EQ(assessment.grades[PARAM_EC], QUALITY_EXCELLENT);
+  CHECK_EQ(assessment.overall, QUALITY_UNSAFE);
+  CHECK_EQ(getParameterGrade(PARAM_TURBIDITY, 2.0), QUALITY_MARGINAL);
+  CHECK_EQ(getParameterGrade(PARAM_COUNT, 2.0), QUALITY_UNKNOWN);
+}
+
+TEST(rule_severity_caps_parameter_grade) {
+  const ParameterThresholds& ph = WATER_QUALITY_RULES[PARAM_PH].bands;
+  CHECK_EQ(gradeParameter(ph, QUALITY_UNSAFE, 5.0), QUALITY_UNSAFE);
+  CHECK_EQ(gradeParameter(ph, QUALITY_MARGINAL, 5.0), QUALITY_MARGINAL);
+  CHECK_EQ(gradeParameter(ph, QUALITY_MARGINAL, 7.0), QUALITY_EXCELLENT);
+  CHECK_EQ(gradeParameter(ph, QUALITY_UNSAFE, NAN), QUALITY_UNSAFE);
+}
+
+TEST(profile_switch_changes_grading) {
+  setWaterQualityProfile(PROFILE_DRINKING, false);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.8, 200, 300), QUALITY_EXCELLENT);
+  setWaterQualityProfile(PROFILE_BOTTLED, false);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.8, 200, 300), QUALITY_MARGINAL);
+  setWaterQualityProfile(PROFILE_IN_HOUSE, false);
+  CHECK_EQ(evaluateWaterQuality(7.2, 0.8, 200, 300), QUALITY_MARGINAL);
+
+  // 娱乐用水：矿物质超标最多黄灯
+  setWaterQualityProfile(PROFILE_RECREATIONAL, false);
+  CHECK_EQ(evaluateWaterQuality(7.5, 0.5, 2500, 3500), QUALITY_MARGINAL);
+  CHECK_EQ(evaluateWaterQuality(6.0, 0.5, 200, 300), QUALITY_UNSAFE);
+
+  CHECK(!setWaterQualityProfile(PROFILE_COUNT, false));
+  CHECK_EQ(getWaterQualityProfile(), PROFILE_RECREATIONAL);
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, false);
+}
+
+TEST(profile_switch_drops_threshold_overrides) {
+  setWaterQualityProfile(PROFILE_DRINKING, false);
+  ParameterThresholds strict = {7.0, 7.5, 6.8, 7.8};
+  CHECK(setParameterThresholds(PARAM_PH, strict));
+  CHECK_EQ(evaluateWaterQuality(6.9, 0.5, 200, 300), QUALITY_MARGINAL);
+
+  setWaterQualityProfile(PROFILE_DRINKING, false);
+  CHECK_EQ(evaluateWaterQuality(6.9, 0.5, 200, 300), QUALITY_EXCELLENT);
+}
+
+TEST(profile_selection_survives_reload) {
+  CHECK(setWaterQualityProfile(PROFILE_BOTTLED, true));
+  setWaterQualityProfile(PROFILE_DRINKING, false);   // 只改RAM，模拟掉电前未保存的状态
+  loadWaterQualityProfile();
+  CHECK_EQ(getWaterQualityProfile(), PROFILE_BOTTLED);
+
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, true);
+  loadWaterQualityProfile();
+  CHECK_EQ(getWaterQualityProfile(), PROFILE_DRINKING);
+  CHECK_EQ(findWaterQualityProfile("recreational"), PROFILE_RECREATIONAL);
+  CHECK_EQ(findWaterQualityProfile("spa"), -1);
+}
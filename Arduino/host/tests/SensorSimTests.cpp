@@ -0,0 +1,199 @@
+/**
+ * SensorSimTests.cpp - 传感器信号模拟与回放流程
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+#include "SensorSim.h"
+#include "Replay.h"
+#include "WaterMonitor.h"
+
+#include <stdlib.h>
+
+static SensorWaveform flatWaveform(float base) {
+  SensorWaveform waveform = {base, 0, 0, 0, 0, 0, 0};
+  return waveform;
+}
+
+static void useDefaultCalibration() {
+  resetSensorCalibration();
+  resetParameterThresholds();
+}
+
+TEST(sensor_sim_feeds_adc_and_temperature) {
+  useDefaultCalibration();
+  sensorSimAttach(1);
+  sensorSimSetWaveform(SIM_CH_PH, flatWaveform(PH7_VOLTAGE));
+  sensorSimSetWaveform(SIM_CH_TEMPERATURE, flatWaveform(18.5));
+
+  initializeSensors();
+  float pH = 0;
+  float temperature = 25.0;
+  CHECK(readPH(pH));
+  CHECK(readTemperature(temperature));
+  CHECK_NEAR(pH, 7.0, 0.05);
+  CHECK_NEAR(temperature, 18.5, 0.01);
+}
+
+TEST(sensor_sim_drift_follows_virtual_clock) {
+  sensorSimAttach(1);
+  SensorWaveform drifting = {1.0, 0.2, 0, 0, 0, 0, 0};
+  sensorSimSetWaveform(SIM_CH_CONDUCTIVITY, drifting);
+
+  bool connected;
+  halHostAdvanceMillis(1800000);
+  CHECK_NEAR(sensorSimValue(SIM_CH_CONDUCTIVITY, connected), 1.1, 1e-4);
+  CHECK(connected);
+}
+
+TEST(sensor_sim_disconnect_keeps_last_temperature) {
+  sensorSimAttach(1);
+  // 一次采集至少要填满稳定窗口（约2秒），断开时段覆盖第二次采集结束时的温度读取
+  SensorWaveform dropout = {21.0, 0, 0, 0, 0, 3000, 10000};
+  sensorSimSetWaveform(SIM_CH_TEMPERATURE, dropout);
+  initializeSensors();
+  CHECK(temperatureSensorFound);
+
+  const Measurement& before = readAllSensors();
+  CHECK_NEAR(before.temperature, 21.0, 0.01);
+  CHECK(isMeasurementFieldValid(before, MEAS_TEMPERATURE));
+
+  halHostAdvanceMillis(1500);
+  const Measurement& after = readAllSensors();
+  CHECK_NEAR(after.temperature, 21.0, 0.01);   // 断开时保留上次数值
+  CHECK(!isMeasurementFieldValid(after, MEAS_TEMPERATURE));
+}
+
+TEST(acquisition_ends_early_in_stable_water) {
+  useDefaultCalibration();
+  sensorSimAttach(1);
+  initializeSensors();
+
+  const Measurement& m = readAllSensors();
+  CHECK(isMeasurementSettled(m));
+  CHECK(m.settleMs < 3000);
+}
+
+TEST(acquisition_times_out_while_probe_drifts) {
+  useDefaultCalibration();
+  sensorSimAttach(1);
+  SensorWaveform drifting = {PH7_VOLTAGE, 100.0, 0, 0, 0, 0, 0};   // 约28 mV/s
+  sensorSimSetWaveform(SIM_CH_PH, drifting);
+  initializeSensors();
+
+  const Measurement& m = readAllSensors();
+  CHECK(!isMeasurementSettled(m));
+  CHECK((m.settledMask & MEAS_PH) == 0);
+  CHECK(m.settledMask & MEAS_TURBIDITY);
+  CHECK(m.settleMs >= SETTLE_TIMEOUT_MS);
+  CHECK_EQ(packWaterQualityData(m).flags, PACKET_FLAG_UNSETTLED);
+}
+
+TEST(blocking_read_does_not_restart_running_acquisition) {
+  useDefaultCalibration();
+  sensorSimAttach(1);
+  initializeSensors();
+
+  uint32_t last = readAllSensors().sequence;
+  startAcquisition();
+  pollAcquisition();
+  CHECK_EQ(readAllSensors().sequence, last);   // 拒绝执行，返回上一次结果
+  CHECK(isAcquisitionActive());
+
+  while (!pollAcquisition()) {
+    halHostAdvanceMillis(SETTLE_INTERVAL_MS);
+  }
+  CHECK_EQ(finishAcquisition().sequence, last + 1);
+}
+
+TEST(sensor_sim_same_seed_same_readings) {
+  int first[32];
+  sensorSimAttach(42);
+  sensorSimLoadScenario("noisy");
+  for (int i = 0; i < 32; i++) {
+    first[i] = analogRead(PH_SENSOR_PIN);
+  }
+
+  sensorSimAttach(42);
+  sensorSimLoadScenario("noisy");
+  int mismatches = 0;
+  bool varies = false;
+  for (int i = 0; i < 32; i++) {
+    int value = analogRead(PH_SENSOR_PIN);
+    mismatches += value != first[i];
+    varies |= value != first[0];
+  }
+  CHECK_EQ(mismatches, 0);
+  CHECK(varies);
+}
+
+TEST(sensor_sim_csv_trace_interpolates_and_marks_gaps) {
+  const char* path = "sensor_sim_trace.csv";
+  FILE* file = fopen(path, "w");
+  CHECK(file != NULL);
+  if (file == NULL) {
+    return;
+  }
+  fprintf(file, "# 测试轨迹\ntime_ms,ph_v,temperature_c\n0,1.0,20\n1000,2.0,\n2000,3.0,22\n");
+  fclose(file);
+
+  sensorSimAttach(1);
+  CHECK(sensorSimLoadCsv(path));
+  CHECK_EQ(sensorSimTraceDurationMs(), 2000u);
+
+  bool connected;
+  halHostAdvanceMillis(250);
+  CHECK_NEAR(sensorSimValue(SIM_CH_PH, connected), 1.25, 1e-4);
+  CHECK_NEAR(sensorSimValue(SIM_CH_TEMPERATURE, connected), 20.0, 1e-4);   // 下一行断开，不插值
+
+  halHostAdvanceMillis(1000);
+  sensorSimValue(SIM_CH_TEMPERATURE, connected);
+  CHECK(!connected);
+
+  // 轨迹没有的列仍使用场景波形
+  CHECK_NEAR(sensorSimValue(SIM_CH_CONDUCTIVITY, connected), sensorSimGetWaveform(SIM_CH_CONDUCTIVITY).base, 1e-4);
+  remove(path);
+}
+
+TEST(sensor_sim_rejects_malformed_csv) {
+  const char* path = "sensor_sim_bad.csv";
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    CHECK(file != NULL);
+    return;
+  }
+  fprintf(file, "time_ms,ph_v\n1000,1.0\n500,abc\n");
+  fclose(file);
+
+  sensorSimAttach(1);
+  CHECK(!sensorSimLoadCsv(path));
+  CHECK_EQ(sensorSimTraceDurationMs(), 0u);
+  remove(path);
+}
+
+TEST(replay_steady_water_classifies_excellent) {
+  useDefaultCalibration();
+  sensorSimAttach(7);
+  ReplayStats stats;
+  runReplay(120, 60000, NULL, stats);
+
+  CHECK_EQ(stats.samples, 120u);
+  CHECK(stats.simMs >= 119u * 60000);
+  CHECK_EQ(stats.payloadBytes, 120u * 11);
+  CHECK_EQ(stats.gradeCounts[QUALITY_EXCELLENT], 120u);
+  CHECK_EQ(stats.gradeChanges, 0u);
+  CHECK_NEAR(stats.fields[REPLAY_PH].sum / stats.samples, 7.2, 0.05);
+  CHECK_NEAR(stats.fields[REPLAY_TURBIDITY].sum / stats.samples, 0.7, 0.2);
+}
+
+TEST(replay_drift_degrades_classification) {
+  useDefaultCalibration();
+  sensorSimAttach(7);
+  sensorSimLoadScenario("drift");
+  ReplayStats stats;
+  runReplay(24 * 12, 300000, NULL, stats);   // 一天，5分钟间隔
+
+  CHECK(stats.gradeCounts[QUALITY_EXCELLENT] > 0);
+  CHECK(stats.gradeCounts[QUALITY_MARGINAL] + stats.gradeCounts[QUALITY_UNSAFE] > 0);
+  CHECK(stats.fields[REPLAY_PH].min < 6.5);
+}
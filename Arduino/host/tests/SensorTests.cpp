@@ -0,0 +1,222 @@
+/**
+ * SensorTests.cpp - ADC读数到物理量的换算
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+// 电压对应的 ADC 读数（10位，VREF = 3.3V）
+static int adcForVoltage(float volts) {
+  return (int)(volts / VREF * ADC_RESOLUTION + 0.5);
+}
+
+static void useDefaultCalibration() {
+  resetSensorCalibration();
+}
+
+TEST(ph_at_calibration_points) {
+  useDefaultCalibration();
+
+  float pH;
+  halHostSetAnalog(PH_SENSOR_PIN, adcForVoltage(PH7_VOLTAGE));
+  CHECK(readPH(pH));
+  CHECK_NEAR(pH, 7.0, 0.05);
+
+  halHostSetAnalog(PH_SENSOR_PIN, adcForVoltage(PH4_VOLTAGE));
+  CHECK(readPH(pH));
+  CHECK_NEAR(pH, 4.0, 0.05);
+}
+
+TEST(ph_is_clamped_to_scale) {
+  useDefaultCalibration();
+  float pH;
+  halHostSetAnalog(PH_SENSOR_PIN, 0);
+  CHECK(!readPH(pH));   // 探头断开
+  CHECK(pH >= 0.0);
+
+  halHostSetAnalog(PH_SENSOR_PIN, 1023);
+  CHECK(!readPH(pH));   // 输入饱和
+  CHECK(pH <= 14.0);
+}
+
+TEST(conductivity_and_tds_from_adc) {
+  useDefaultCalibration();
+  float conductivity;
+  halHostSetAnalog(CONDUCTIVITY_PIN, 356);
+  CHECK(readConductivity(conductivity));
+  float tds = calculateTDSFromConductivity(conductivity, 25.0);
+
+  float volts = 356 * VREF / 1023.0;
+  CHECK_NEAR(conductivity, volts / SENSOR_MAX_V * MAX_CONDUCTIVITY, 0.5);
+  CHECK_NEAR(tds, conductivity * 0.5, 0.5);
+
+  halHostSetAnalog(CONDUCTIVITY_PIN, 1023);
+  CHECK(!readConductivity(conductivity));
+}
+
+TEST(temperature_from_simulated_ds18b20) {
+  halHostSetTemperatureC(18.5);
+  initializeSensors();
+  float temperature = 25.0;
+  CHECK(readTemperature(temperature));
+  CHECK_NEAR(temperature, 18.5, 0.01);
+}
+
+TEST(measurement_is_graded_once_and_snapshots_stay_put) {
+  useDefaultCalibration();
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, false);
+  halHostSetTemperatureC(25.0);
+  initializeSensors();
+  halHostSetAnalog(PH_SENSOR_PIN, adcForVoltage(PH7_VOLTAGE));
+  halHostSetAnalog(TURBIDITY_PIN, adcForVoltage(2.1));
+  halHostSetAnalog(CONDUCTIVITY_PIN, adcForVoltage(0.345));   // 约300 μS/cm
+
+  Measurement snapshot = readAllSensors();
+  CHECK_EQ(snapshot.validMask, MEAS_ALL_FIELDS);
+  CHECK_EQ(snapshot.profile, PROFILE_DRINKING);
+  CHECK_EQ(snapshot.assessment.overall, QUALITY_EXCELLENT);
+
+  // 新的采集只替换最近结果，已取走的副本不受影响
+  halHostSetAnalog(PH_SENSOR_PIN, adcForVoltage(PH4_VOLTAGE));
+  const Measurement& latest = readAllSensors();
+  CHECK_EQ(latest.sequence, snapshot.sequence + 1);
+  CHECK_EQ(latest.assessment.grades[PARAM_PH], QUALITY_UNSAFE);
+  CHECK_EQ(getWaterQualityGrade(), QUALITY_UNSAFE);
+  CHECK_EQ(snapshot.assessment.grades[PARAM_PH], QUALITY_EXCELLENT);
+  CHECK_NEAR(snapshot.pH, 7.0, 0.05);
+}
+
+TEST(missing_probe_is_not_graded) {
+  useDefaultCalibration();
+  setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, false);
+  initializeSensors();
+  halHostSetAnalog(PH_SENSOR_PIN, 0);                          // pH探头断开，占位值为 pH 0
+  halHostSetAnalog(TURBIDITY_PIN, adcForVoltage(2.1));
+  halHostSetAnalog(CONDUCTIVITY_PIN, adcForVoltage(0.345));
+
+  const Measurement& m = readAllSensors();
+  CHECK(!isMeasurementFieldValid(m, MEAS_PH));
+  CHECK_EQ(m.assessment.grades[PARAM_PH], QUALITY_UNKNOWN);
+  CHECK_EQ(m.assessment.overall, QUALITY_EXCELLENT);
+
+  // 所有探头都无效时总体等级未知
+  halHostSetAnalog(TURBIDITY_PIN, 0);
+  halHostSetAnalog(CONDUCTIVITY_PIN, ADC_RESOLUTION - 1);
+  CHECK_EQ(readAllSensors().assessment.overall, QUALITY_UNKNOWN);
+  CHECK_EQ(getWaterQualityGrade(), QUALITY_UNKNOWN);
+}
+
+TEST(turbidity_follows_calibration_table) {
+  useDefaultCalibration();
+  CHECK_NEAR(turbidityFromSensorMillivolts(4300), 0.0, 0.01);     // 高于清水电压
+  CHECK_NEAR(turbidityFromSensorMillivolts(4200), 0.0, 0.01);
+  CHECK_NEAR(turbidityFromSensorMillivolts(3500), 10.0, 0.2);
+  CHECK_NEAR(turbidityFromSensorMillivolts(2500), 100.0, 1.0);
+  CHECK_NEAR(turbidityFromSensorMillivolts(1500), 500.0, 5.0);
+  CHECK_NEAR(turbidityFromSensorMillivolts(1000), 1000.0, 0.1);
+  CHECK_NEAR(turbidityFromSensorMillivolts(200), 1000.0, 0.1);    // 低于量程
+  CHECK(turbidityFromSensorMillivolts(3000) > turbidityFromSensorMillivolts(3100));
+}
+
+TEST(turbidity_from_divided_adc_voltage) {
+  useDefaultCalibration();
+  // 传感器3.5V经1/2分压为1.75V
+  float turbidity;
+  halHostSetAnalog(TURBIDITY_PIN, adcForVoltage(1.75));
+  CHECK(readTurbidity(turbidity));
+  CHECK_NEAR(turbidity, 10.0, 0.3);
+
+  halHostSetAnalog(TURBIDITY_PIN, adcForVoltage(2.1));
+  CHECK(readTurbidity(turbidity));
+  CHECK_NEAR(turbidity, 0.0, 0.1);
+
+  halHostSetAnalog(TURBIDITY_PIN, 0);   // 断线
+  CHECK(!readTurbidity(turbidity));
+}
+
+TEST(turbidity_clear_water_calibration) {
+  useDefaultCalibration();
+  CHECK(!setCalibrationValue(CAL_TURBIDITY_CLEAR_V, 0.8));   // 低于最高浊度电压
+  CHECK(!setCalibrationValue(CAL_TURBIDITY_MAX_V, 0.0));
+
+  // 探头在清水中只有4.0V时，把4.0V标定为0 NTU
+  CHECK(setCalibrationValue(CAL_TURBIDITY_CLEAR_V, 4.0));
+  CHECK_NEAR(turbidityFromSensorMillivolts(4000), 0.0, 0.01);
+  CHECK_NEAR(turbidityFromSensorMillivolts(1000), 1000.0, 0.1);
+  useDefaultCalibration();
+}
+
+TEST(oversampling_averages_in_fixed_point) {
+  halHostSetAnalog(PH_SENSOR_PIN, 512);
+  CHECK_EQ(readAdcOversampled(PH_SENSOR_PIN, 16, 0), 512u * ADC_FIXED_ONE);
+  CHECK_EQ(adcFixedToMillivolts(512u * ADC_FIXED_ONE), 1650u);
+  CHECK_NEAR(adcFixedToVolts(512u * ADC_FIXED_ONE), 1.65, 1e-4);
+
+  uint32_t start = millis();
+  readAdcOversampled(PH_SENSOR_PIN, 8, 2);
+  CHECK_EQ(millis() - start, 14u);
+}
+
+TEST(runtime_oversample_counts_are_clamped_and_used) {
+  CHECK_EQ(findSensorProbe("turbidity"), 1);
+  CHECK_EQ(findSensorProbe("orp"), -1);
+  CHECK_EQ(setOversampleCount(-1, 1000), ADC_MAX_SAMPLES);
+  CHECK_EQ(getOversampleCount(findSensorProbe("ph")), ADC_MAX_SAMPLES);
+  CHECK_EQ(setOversampleCount(findSensorProbe("conductivity"), 0), 1);
+  CHECK_EQ(getOversampleCount(findSensorProbe("conductivity")), 1);
+
+  // 浊度每次间隔2ms，耗时随次数变化
+  float turbidity;
+  setOversampleCount(findSensorProbe("turbidity"), 4);
+  uint32_t start = millis();
+  readTurbidity(turbidity);
+  CHECK_EQ(millis() - start, 6u);
+
+  resetOversampleCounts();
+  CHECK_EQ(getOversampleCount(findSensorProbe("turbidity")), TURBIDITY_SAMPLES);
+}
+
+TEST(calibration_table_interpolates_and_clamps) {
+  static const CalibrationPoint table[] = {{0, 0}, {100, 1000}, {200, 1500}};
+  CHECK_EQ(interpolateCalibration(table, 3, -5), 0);
+  CHECK_EQ(interpolateCalibration(table, 3, 50), 500);
+  CHECK_EQ(interpolateCalibration(table, 3, 150), 1250);
+  CHECK_EQ(interpolateCalibration(table, 3, 300), 1500);
+}
+
+TEST(settle_detector_needs_full_flat_window) {
+  SettleDetector detector;
+  settleReset(detector, 100, 100);
+  for (int i = 0; i < SETTLE_WINDOW - 1; i++) {
+    settleAdd(detector, 50000 + (i % 2) * 20);
+    CHECK(!settleIsStable(detector));
+  }
+  settleAdd(detector, 50020);
+  CHECK(settleIsStable(detector));
+  CHECK_EQ(settleMean(detector), 50010);
+}
+
+TEST(settle_detector_rejects_drift_and_noise) {
+  SettleDetector detector;
+  settleReset(detector, 100, 100);
+  for (int i = 0; i < SETTLE_WINDOW; i++) {
+    settleAdd(detector, 50000 + i * 20);          // 首尾变化140
+  }
+  CHECK(!settleIsStable(detector));
+
+  settleReset(detector, 100, 100);
+  for (int i = 0; i < SETTLE_WINDOW; i++) {
+    settleAdd(detector, 50000 + (i % 2) * 300);   // 标准差150
+  }
+  CHECK(!settleIsStable(detector));
+
+  // 窗口滑过漂移段后重新稳定
+  settleReset(detector, 100, 100);
+  for (int i = 0; i < 20; i++) {
+    settleAdd(detector, i < 12 ? 40000 + i * 500 : 46000);
+  }
+  CHECK(settleIsStable(detector));
+  CHECK_EQ(settleMean(detector), 46000);
+}
@@ -0,0 +1,38 @@
+/**
+ * TestHarness.h - 主机测试用的最小测试框架
+ *
+ * TEST(name) 定义并自动注册一个测试；CHECK 系列宏失败时记录位置并继续，
+ * 测试程序的退出码为失败的测试数
+ */
+
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef void (*TestFunction)();
+
+struct TestRegistrar {
+  TestRegistrar(const char* name, TestFunction run);
+};
+
+void testFailure(const char* file, int line, const char* expression);
+
+#define TEST(name) \
+  static void test_##name(); \
+  static TestRegistrar testRegistrar_##name(#name, test_##name); \
+  static void test_##name()
+
+#define CHECK(condition) \
+  do { if (!(condition)) testFailure(__FILE__, __LINE__, #condition); } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { if (!((actual) == (expected))) testFailure(__FILE__, __LINE__, #actual " == " #expected); } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+  do { if (fabs((double)(actual) - (double)(expected)) > (tolerance)) \
+    testFailure(__FILE__, __LINE__, #actual " ~= " #expected); } while (0)
+
+#endif // TEST_HARNESS_H
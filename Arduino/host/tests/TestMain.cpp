@@ -0,0 +1,61 @@
+/**
+ * TestMain.cpp - 主机测试入口
+ *
+ * 每个测试前复位硬件模拟（虚拟时钟归零、串口输出写入缓冲区）
+ * 用法: water_tests [测试名片段]
+ */
+
+#include "TestHarness.h"
+#include "HalHost.h"
+
+#define MAX_TESTS 128
+
+struct TestCase {
+  const char* name;
+  TestFunction run;
+};
+
+static TestCase testCases[MAX_TESTS];
+static int testCount = 0;
+static int currentFailures = 0;
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction run) {
+  if (testCount < MAX_TESTS) {
+    testCases[testCount].name = name;
+    testCases[testCount].run = run;
+    testCount++;
+  }
+}
+
+void testFailure(const char* file, int line, const char* expression) {
+  printf("  %s:%d: 失败: %s\n", file, line, expression);
+  currentFailures++;
+}
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : NULL;
+  int run = 0;
+  int failed = 0;
+
+  for (int i = 0; i < testCount; i++) {
+    if (filter != NULL && strstr(testCases[i].name, filter) == NULL) {
+      continue;
+    }
+
+    halHostReset();
+    halHostSetSerialEcho(false);
+    currentFailures = 0;
+
+    testCases[i].run();
+    run++;
+    if (currentFailures > 0) {
+      failed++;
+      printf("✗ %s\n", testCases[i].name);
+    } else {
+      printf("✓ %s\n", testCases[i].name);
+    }
+  }
+
+  printf("\n%d 个测试, %d 个失败\n", run, failed);
+  return failed;
+}
@@ -0,0 +1,9 @@
+/**
+ * water_ino.cpp - 把 water.ino 作为普通C++源文件编译
+ *
+ * Arduino IDE 会在 .ino 前面插入 #include <Arduino.h> 和函数原型，
+ * water.ino 自己已经声明了需要的原型，这里只需包含它
+ */
+
+#include <Arduino.h>
+#include "water.ino"
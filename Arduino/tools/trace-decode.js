@@ -0,0 +1,124 @@
+#!/usr/bin/env node
+/**
+ * trace-decode.js - decode the binary trace stream from the water monitor
+ *
+ * Capture the serial port after sending `trace on`, e.g.
+ *   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > trace.bin
+ * then:
+ *   node Arduino/tools/trace-decode.js trace.bin [--text]
+ *
+ * Frames are 0xA5 0x5A + 12-byte little-endian record + XOR checksum
+ * (see Arduino/water/Trace.h). Bytes outside frames are ordinary console
+ * text; --text prints those lines interleaved with the timeline.
+ */
+
+const fs = require('fs');
+
+const SYNC_0 = 0xa5;
+const SYNC_1 = 0x5a;
+const FRAME_SIZE = 15;
+
+// Keep in sync with TraceEventId in Arduino/water/Trace.h
+const EVENTS = {
+  1: { name: 'BOOT' },
+  2: { name: 'DROPPED', format: (a0) => `${a0} events lost` },
+  3: { name: 'BUTTON_EDGE', format: (a0, a1) => `${a0 ? 'pressed' : 'released'} @${a1}ms` },
+  4: { name: 'BUTTON_GESTURE', format: (a0) => ['?', 'short', 'long', 'double'][a0] || `type ${a0}` },
+  5: { name: 'TEST_TRIGGER' },
+  6: { name: 'SENSORS_DONE', format: (a0, a1) => `class ${['?', 'GREEN', 'YELLOW', 'RED'][a0] || a0}, ${us(a1)}` },
+  7: { name: 'DISPLAY_DONE', format: (a0, a1) => us(a1) },
+  8: { name: 'LORA_TX_START', format: (a0, a1) => `port ${a0 >> 8}, ${a0 & 0xff} bytes, fcnt ${a1 | 0}` },
+  9: { name: 'LORA_TX_END', format: (a0, a1) => `${a0 ? 'confirmed' : 'unconfirmed'}, result ${a1 | 0}` },
+  10: { name: 'DOWNLINK', format: (a0, a1) => `${a0} bytes, ${a1} commands applied` },
+  11: { name: 'BACKLOG', format: (a0) => `${a0} queued` },
+  12: { name: 'SLEEP_ENTER', format: (a0, a1) => (a1 ? `RTC alarm in ${a1}ms` : 'button wake only') },
+  13: { name: 'WAKE', format: (a0) => (a0 ? 'button' : 'RTC') },
+  14: { name: 'SAMPLE_START', format: (a0, a1) => `interval ${a1}s` },
+};
+
+function us(value) {
+  return value >= 10000 ? `${(value / 1000).toFixed(1)}ms` : `${value}us`;
+}
+
+function decode(buffer, onRecord, onText) {
+  let text = [];
+  let i = 0;
+
+  const flushText = () => {
+    if (text.length > 0) {
+      onText(Buffer.from(text).toString('utf8'));
+      text = [];
+    }
+  };
+
+  while (i < buffer.length) {
+    if (buffer[i] === SYNC_0 && buffer[i + 1] === SYNC_1 && i + FRAME_SIZE <= buffer.length) {
+      let check = 0;
+      for (let j = i + 2; j < i + FRAME_SIZE - 1; j++) {
+        check ^= buffer[j];
+      }
+      if (check === buffer[i + FRAME_SIZE - 1]) {
+        flushText();
+        onRecord({
+          timeUs: buffer.readUInt32LE(i + 2),
+          event: buffer.readUInt16LE(i + 6),
+          arg0: buffer.readUInt16LE(i + 8),
+          arg1: buffer.readUInt32LE(i + 10),
+        });
+        i += FRAME_SIZE;
+        continue;
+      }
+    }
+
+    // Not a valid frame: treat as console text
+    if (buffer[i] === 0x0a) {
+      flushText();
+    } else if (buffer[i] !== 0x0d) {
+      text.push(buffer[i]);
+    }
+    i++;
+  }
+  flushText();
+}
+
+function main() {
+  const args = process.argv.slice(2);
+  const showText = args.includes('--text');
+  const file = args.find((arg) => !arg.startsWith('--'));
+  const buffer = fs.readFileSync(file || 0);
+
+  let firstUs = null;
+  let lastUs = null;
+  let elapsedUs = 0;
+  let count = 0;
+
+  decode(
+    buffer,
+    (record) => {
+      // micros() wraps every ~71 minutes; accumulate deltas so the timeline stays monotonic
+      if (firstUs === null) {
+        firstUs = record.timeUs;
+        lastUs = record.timeUs;
+      }
+      elapsedUs += (record.timeUs - lastUs) >>> 0;
+      lastUs = record.timeUs;
+      count++;
+
+      const info = EVENTS[record.event] || { name: `EVENT_${record.event}` };
+      const detail = info.format
+        ? info.format(record.arg0, record.arg1)
+        : (record.arg0 || record.arg1 ? `arg0=${record.arg0} arg1=${record.arg1}` : '');
+      const time = (elapsedUs / 1000).toFixed(3).padStart(12);
+      console.log(`${time} ms  ${info.name.padEnd(15)} ${detail}`);
+    },
+    (line) => {
+      if (showText && line.trim()) {
+        console.log(`${''.padStart(15)}| ${line}`);
+      }
+    }
+  );
+
+  console.error(`${count} trace records decoded`);
+}
+
+main();
@@ -2,77 +2,276 @@
  * ButtonControl.cpp - 按钮控制模块
  * 
  * 处理按钮输入、防抖和冷却时间控制
+ * 按钮由外部中断记录带时间戳的边沿，按钮任务负责防抖并识别
+ * 单击（检测）、长按（完整刷新屏幕）和双击（补发缓存数据）
  */
 
+#define LOG_MODULE LOG_MOD_BUTTON
+
 #include "WaterMonitor.h"
 
 // ==================== 全局变量定义 ====================
-bool lastButtonState = HIGH;
-bool currentButtonState = HIGH;
-bool buttonPressed = false;
+bool currentButtonState = HIGH;     // 防抖后的稳定电平
+bool buttonPressed = false;         // 按钮当前处于按下状态
 unsigned long lastButtonPress = 0;
 bool systemReady = false;
+volatile unsigned long lastButtonEdgeMs = 0;
+
+// ==================== 边沿队列（中断写入，按钮任务读取） ====================
+struct ButtonEdge {
+  unsigned long timeMs;
+  uint8_t level;
+};
+
+static volatile ButtonEdge edgeQueue[BUTTON_EDGE_QUEUE_SIZE];
+static volatile uint8_t edgeHead = 0;
+static volatile uint8_t edgeTail = 0;
+static volatile uint16_t edgesDropped = 0;
+
+// ==================== 手势事件队列 ====================
+static ButtonEvent eventQueue[BUTTON_EVENT_QUEUE_SIZE];
+static uint8_t eventHead = 0;
+static uint8_t eventCount = 0;
+
+// ==================== 防抖与手势状态 ====================
+static bool candidatePending = false;    // 有尚未稳定的电平变化
+static uint8_t candidateLevel = HIGH;
+static unsigned long candidateTime = 0;
+
+static unsigned long pressStartMs = 0;
+static unsigned long releaseMs = 0;
+static uint8_t clickCount = 0;           // 等待判断单击/双击的点击次数
+static bool longPressFired = false;
+static bool suppressPress = false;       // 唤醒按压已处理，忽略本次手势
+static bool testDeferred = false;        // 冷却期内的单击，冷却结束后执行
+
+// ==================== 按钮中断 ====================
+void onButtonEdge() {
+  uint8_t next = (edgeTail + 1) % BUTTON_EDGE_QUEUE_SIZE;
+  if (next == edgeHead) {
+    edgesDropped++;
+    return;
+  }
+
+  unsigned long now = millis();
+  edgeQueue[edgeTail].timeMs = now;
+  edgeQueue[edgeTail].level = halDigitalRead(BUTTON_PIN);
+  edgeTail = next;
+  lastButtonEdgeMs = now;
+
+  signalTask(TASK_BUTTON);
+}
+
+static bool popEdge(ButtonEdge& edge) {
+  noInterrupts();
+  if (edgeHead == edgeTail) {
+    interrupts();
+    return false;
+  }
+  edge.timeMs = edgeQueue[edgeHead].timeMs;
+  edge.level = edgeQueue[edgeHead].level;
+  edgeHead = (edgeHead + 1) % BUTTON_EDGE_QUEUE_SIZE;
+  interrupts();
+  return true;
+}
+
+bool hasPendingButtonEdges() {
+  return edgeHead != edgeTail;
+}
 
 // ==================== 按钮初始化 ====================
 void initializeButton() {
-  Serial.println("正在初始化按钮控制...");
+  LOG_PRINTLN(LOG_INF, "正在初始化按钮控制...");
   
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  halPinMode(BUTTON_PIN, INPUT_PULLUP);
   
   // 初始化按钮状态
-  lastButtonState = digitalRead(BUTTON_PIN);
-  currentButtonState = lastButtonState;
+  currentButtonState = halDigitalRead(BUTTON_PIN);
+  candidateLevel = currentButtonState;
   buttonPressed = false;
   lastButtonPress = 0;
   
-  Serial.println("✓ 按钮控制初始化完成");
+  // 双边沿中断：按下和松开都记录时间戳，不再需要轮询
+  halAttachInterrupt(BUTTON_PIN, onButtonEdge, CHANGE);
+  
+  LOG_PRINTLN(LOG_INF, "✓ 按钮控制初始化完成");
+}
+
+// ==================== 手势事件 ====================
+static void pushButtonEvent(uint8_t type, unsigned long timeMs) {
+  if (eventCount == BUTTON_EVENT_QUEUE_SIZE) {
+    return;
+  }
+  uint8_t tail = (eventHead + eventCount) % BUTTON_EVENT_QUEUE_SIZE;
+  eventQueue[tail].type = type;
+  eventQueue[tail].timeMs = timeMs;
+  eventCount++;
+  TRACE(TRACE_BUTTON_GESTURE, type, timeMs);
+}
+
+bool getButtonEvent(ButtonEvent& event) {
+  if (eventCount == 0) {
+    return false;
+  }
+  event = eventQueue[eventHead];
+  eventHead = (eventHead + 1) % BUTTON_EVENT_QUEUE_SIZE;
+  eventCount--;
+  return true;
+}
+
+// 稳定电平变化：按下开始计时，松开时判断单击/双击
+static void onDebouncedTransition(bool pressed, unsigned long timeMs) {
+  TRACE(TRACE_BUTTON_EDGE, pressed ? 1 : 0, timeMs);
+  if (pressed) {
+    buttonPressed = true;
+    pressStartMs = timeMs;
+    longPressFired = false;
+    notePowerActivity();
+    LOG_PRINTLN(LOG_DBG, "按钮按下...");
+    return;
+  }
+
+  if (!buttonPressed) {
+    return;
+  }
+  buttonPressed = false;
+
+  if (suppressPress) {
+    suppressPress = false;
+    return;
+  }
+  if (longPressFired) {
+    return;
+  }
+
+  clickCount++;
+  releaseMs = timeMs;
+  if (clickCount >= 2) {
+    clickCount = 0;
+    pushButtonEvent(BUTTON_EVENT_DOUBLE, timeMs);
+  }
+}
+
+// 电平在防抖时间内没有再变化才算稳定
+static void debounceEdges(unsigned long now) {
+  ButtonEdge edge;
+  while (popEdge(edge)) {
+    if (candidatePending && edge.timeMs - candidateTime >= BUTTON_DEBOUNCE_MS &&
+        candidateLevel != currentButtonState) {
+      currentButtonState = candidateLevel;
+      onDebouncedTransition(currentButtonState == LOW, candidateTime);
+    }
+    candidateLevel = edge.level;
+    candidateTime = edge.timeMs;
+    candidatePending = true;
+  }
+
+  if (candidatePending && now - candidateTime >= BUTTON_DEBOUNCE_MS) {
+    candidatePending = false;
+    if (candidateLevel != currentButtonState) {
+      currentButtonState = candidateLevel;
+      onDebouncedTransition(currentButtonState == LOW, candidateTime);
+    }
+  }
+}
+
+static void updateGestureTimers(unsigned long now) {
+  // 长按在达到时间时立即触发，无需等待松开
+  if (buttonPressed && !longPressFired && !suppressPress &&
+      now - pressStartMs >= BUTTON_LONG_PRESS_MS) {
+    longPressFired = true;
+    if (clickCount > 0) {
+      pushButtonEvent(BUTTON_EVENT_SHORT, releaseMs);
+      clickCount = 0;
+    }
+    pushButtonEvent(BUTTON_EVENT_LONG, now);
+  }
+
+  // 单击后超过双击间隔没有第二次按下
+  if (!buttonPressed && clickCount == 1 && now - releaseMs >= BUTTON_DOUBLE_PRESS_GAP) {
+    clickCount = 0;
+    pushButtonEvent(BUTTON_EVENT_SHORT, releaseMs);
+  }
+}
+
+// ==================== 手势处理 ====================
+static void startButtonTest() {
+  LOG_PRINTLN(LOG_INF, "\n=== 按钮单击 - 开始水质检测 ===");
+  performWaterQualityTest();
+  lastButtonPress = millis();
+  
+  LOG_PRINT(LOG_INF, "下次可以按钮的时间: ");
+  LOG_PRINT(LOG_INF, BUTTON_COOLDOWN / 1000);
+  LOG_PRINTLN(LOG_INF, " 秒后");
+  LOG_PRINTLN(LOG_INF, "=========================");
+}
+
+static void handleButtonEvent(const ButtonEvent& event) {
+  switch (event.type) {
+    case BUTTON_EVENT_SHORT:
+      if (!isCooldownPeriod()) {
+        startButtonTest();
+      } else {
+        // 冷却期内的按压不丢弃，冷却结束后自动执行
+        handleCooldownMessage();
+        testDeferred = true;
+      }
+      break;
+
+    case BUTTON_EVENT_LONG:
+      LOG_PRINTLN(LOG_INF, "按钮长按 - 完整刷新屏幕");
+      requestFullRefresh();
+      signalTask(TASK_DISPLAY);
+      break;
+
+    case BUTTON_EVENT_DOUBLE:
+      LOG_PRINT(LOG_INF, "按钮双击 - 补发缓存数据: ");
+      LOG_PRINTLN(LOG_INF, getLoRaBacklogCount());
+      backlogFlushRequested = true;
+      signalTask(TASK_LORA);
+      break;
+  }
 }
 
 // ==================== 按钮处理主函数 ====================
 void handleButtonInput() {
-  // 只有在系统准备就绪后才处理按钮
+  unsigned long now = millis();
+  
+  debounceEdges(now);
+  
+  // 只有在系统准备就绪后才处理手势
   if (!systemReady) {
+    eventCount = 0;
+    clickCount = 0;
+    setTaskPeriod(TASK_BUTTON, TASK_EVENT_ONLY);
     return;
   }
   
-  // 读取当前按钮状态
-  currentButtonState = digitalRead(BUTTON_PIN);
+  updateGestureTimers(now);
   
-  // 检测按钮按下（下降沿 - 按钮被按下）
-  if (lastButtonState == HIGH && currentButtonState == LOW) {
-    buttonPressed = true;  // 标记按钮被按下
-    Serial.println("按钮按下...");
+  ButtonEvent event;
+  while (getButtonEvent(event)) {
+    handleButtonEvent(event);
   }
   
-  // 检测按钮松开（上升沿 - 按钮被松开）- 这是完整的按钮操作
-  if (lastButtonState == LOW && currentButtonState == HIGH && buttonPressed) {
-    Serial.println("按钮松开 - 检测到完整按钮操作！");
-    
-    if (!isCooldownPeriod()) {
-      // 按钮操作成功处理
-      Serial.println("\n=== 完整按钮操作触发 - 开始水质检测 ===");
-      
-      // 执行水质检测
-      performWaterQualityTest();
-      
-      // 更新按钮状态
-      lastButtonPress = millis();
-      buttonPressed = false;
-      
-      Serial.print("下次可以按钮的时间: ");
-      Serial.print(BUTTON_COOLDOWN / 1000);
-      Serial.println(" 秒后");
-      Serial.println("=========================");
-      
-    } else {
-      // 在冷却时间内
-      handleCooldownMessage();
-      buttonPressed = false;  // 重置按钮状态
-    }
+  if (testDeferred && !isCooldownPeriod()) {
+    testDeferred = false;
+    startButtonTest();
   }
   
-  // 更新按钮状态
-  lastButtonState = currentButtonState;
+  // 手势判断或防抖未结束时短周期运行，否则只由中断唤醒
+  if (candidatePending || buttonPressed || clickCount > 0) {
+    setTaskPeriod(TASK_BUTTON, BUTTON_POLL_INTERVAL);
+  } else if (testDeferred) {
+    setTaskPeriod(TASK_BUTTON, getRemainingCooldown());
+  } else {
+    setTaskPeriod(TASK_BUTTON, TASK_EVENT_ONLY);
+  }
+}
+
+// 按钮唤醒时按下动作已由唤醒流程处理，忽略这次按压产生的手势
+void acknowledgeWakePress() {
+  suppressPress = true;
 }
 
 // ==================== 按钮状态检查函数 ====================
@@ -90,9 +289,9 @@ void handleCooldownMessage() {
   unsigned long currentTime = millis();
   unsigned long remainingCooldown = BUTTON_COOLDOWN - (currentTime - lastButtonPress);
   
-  Serial.print("按钮冷却中，请等待 ");
-  Serial.print(remainingCooldown / 1000);
-  Serial.println(" 秒");
+  LOG_PRINT(LOG_INF, "按钮冷却中，请等待 ");
+  LOG_PRINT(LOG_INF, remainingCooldown / 1000);
+  LOG_PRINTLN(LOG_INF, " 秒");
   
   // 显示冷却信息到屏幕
   char cooldownMsg[30];
@@ -104,12 +303,12 @@ void handleCooldownMessage() {
 void setSystemReady(bool ready) {
   systemReady = ready;
   if (ready) {
-    Serial.println("✓ 系统已准备就绪，按钮控制已激活");
-    Serial.print("按钮冷却时间: ");
-    Serial.print(BUTTON_COOLDOWN / 1000);
-    Serial.println(" 秒");
+    LOG_PRINTLN(LOG_INF, "✓ 系统已准备就绪，按钮控制已激活");
+    LOG_PRINT(LOG_INF, "按钮冷却时间: ");
+    LOG_PRINT(LOG_INF, BUTTON_COOLDOWN / 1000);
+    LOG_PRINTLN(LOG_INF, " 秒");
   } else {
-    Serial.println("⚠ 系统未就绪，按钮控制已禁用");
+    LOG_PRINTLN(LOG_WRN, "⚠ 系统未就绪，按钮控制已禁用");
   }
 }
 
@@ -127,17 +326,33 @@ unsigned long getRemainingCooldown() {
   return BUTTON_COOLDOWN - (currentTime - lastButtonPress);
 }
 
-String getButtonStatus() {
+static const char* const BUTTON_STATE_NAMES[BUTTON_STATE_COUNT] = {
+  "System Not Ready", "Cooldown", "Ready"
+};
+
+uint8_t getButtonState() {
   if (!systemReady) {
-    return "System Not Ready";
+    return BUTTON_STATE_NOT_READY;
   }
-  
   if (isCooldownPeriod()) {
-    unsigned long remaining = getRemainingCooldown();
-    return "Cooldown " + String(remaining / 1000) + "s";
+    return BUTTON_STATE_COOLDOWN;
   }
-  
-  return "Ready";
+  return BUTTON_STATE_READY;
+}
+
+const char* getButtonStateName(uint8_t state) {
+  if (state >= BUTTON_STATE_COUNT) {
+    return BUTTON_STATE_NAMES[BUTTON_STATE_NOT_READY];
+  }
+  return BUTTON_STATE_NAMES[state];
+}
+
+String getButtonStatus() {
+  uint8_t state = getButtonState();
+  if (state == BUTTON_STATE_COOLDOWN) {
+    return "Cooldown " + String(getRemainingCooldown() / 1000) + "s";
+  }
+  return getButtonStateName(state);
 }
 
 // ==================== 调试信息函数 ====================
@@ -149,6 +364,10 @@ void printButtonDebugInfo() {
   Serial.println(currentButtonState == HIGH ? "高" : "低");
   Serial.print("按钮按下标志: ");
   Serial.println(buttonPressed ? "是" : "否");
+  Serial.print("丢弃的边沿: ");
+  Serial.println(edgesDropped);
+  Serial.print("冷却后待执行检测: ");
+  Serial.println(testDeferred ? "是" : "否");
   Serial.print("上次按钮时间: ");
   Serial.print(lastButtonPress);
   Serial.println(" ms");
@@ -5,52 +5,76 @@
  * 修正残影问题，改进状态显示
  */
 
+#define LOG_MODULE LOG_MOD_DISPLAY
+
 #include "WaterMonitor.h"
 #include "WaterQualityLED.h"  // 添加这一行来使用水质评估函数
 // ==================== 全局变量定义 ====================
 unsigned char image[1024];
 Paint paint(image, 0, 0);
 Epd epd;
+static bool displaySleeping = false;   // E-Paper处于深度睡眠，刷新前需重新初始化
+static bool fullRefreshRequested = false;
 
 // ==================== E-Paper初始化 ====================
 void initializeEPaper() {
-  Serial.println("正在初始化E-Paper显示屏...");
+  LOG_PRINTLN(LOG_INF, "正在初始化E-Paper显示屏...");
   
   // 使用稳定的普通初始化模式
   if (epd.Init() != 0) {
-    Serial.println("✗ E-Paper初始化失败!");
+    LOG_PRINTLN(LOG_ERR, "✗ E-Paper初始化失败!");
     return;
   }
   
-  Serial.println("✓ E-Paper初始化成功");
+  LOG_PRINTLN(LOG_INF, "✓ E-Paper初始化成功");
   
   // 完全清空显示
-  Serial.println("完全清空E-Paper显示...");
+  LOG_PRINTLN(LOG_INF, "完全清空E-Paper显示...");
   epd.ClearFrameMemory(0xFF);  // 清空帧缓冲
-  epd.DisplayFrame();
-  delay(2000);
+  epd.DisplayFrame();  // DisplayFrame内部等待BUSY结束，无需额外延时
   
   // 再次清空确保没有残影
   epd.ClearFrameMemory(0xFF);
   
-  Serial.println("E-Paper初始化完成");
+  LOG_PRINTLN(LOG_INF, "E-Paper初始化完成");
+}
+
+// ==================== 休眠与唤醒 ====================
+void sleepDisplay() {
+  if (displaySleeping) {
+    return;
+  }
+  // 深度睡眠后画面保持，但控制器需要复位才能再次刷新
+  epd.Sleep();
+  displaySleeping = true;
+}
+
+void wakeDisplay() {
+  if (!displaySleeping) {
+    return;
+  }
+  if (epd.Init() != 0) {
+    LOG_PRINTLN(LOG_ERR, "✗ E-Paper唤醒失败!");
+    return;
+  }
+  displaySleeping = false;
 }
 
 // ==================== 完全清屏函数 ====================
 void clearEntireScreen() {
-  Serial.println("执行完全清屏...");
+  LOG_PRINTLN(LOG_DBG, "执行完全清屏...");
+  wakeDisplay();
   
   // 只使用驱动提供的清屏功能，避免大画布导致卡死
   epd.ClearFrameMemory(0xFF);
-  epd.DisplayFrame();
-  delay(2000);  // 给E-ink足够时间完成刷新
+  epd.DisplayFrame();  // 内部等待刷新完成
   
-  Serial.println("清屏完成");
+  LOG_PRINTLN(LOG_DBG, "清屏完成");
 }
 
 // ==================== 启动界面显示 ====================
 void showStartupScreen() {
-  Serial.println("显示启动界面...");
+  LOG_PRINTLN(LOG_DBG, "显示启动界面...");
   
   // 先完全清屏
   clearEntireScreen();
@@ -114,44 +138,39 @@ void showStartupScreen() {
   epd.SetFrameMemory(paint.GetImage(), 0, 246, paint.GetWidth(), paint.GetHeight());
   
   // 刷新显示
-  Serial.println("刷新启动界面到屏幕...");
+  LOG_PRINTLN(LOG_DBG, "刷新启动界面到屏幕...");
   epd.DisplayFrame();
-  delay(3000);
   
-  Serial.println("启动界面显示完成，系统准备就绪");
+  LOG_PRINTLN(LOG_DBG, "启动界面显示完成，系统准备就绪");
 }
 
 
-// ==================== 获取简化的水质状态 ====================
-String getSimplifiedWaterStatus() {
-  String fullStatus = getWaterQualityStatus();
-  
-  // 从完整状态中提取关键词
-  if (fullStatus.indexOf("UNSAFE") != -1) {
-    return "UNSAFE";
-  } else if (fullStatus.indexOf("EXCELLENT") != -1) {
-    return "EXCELLENT";
-  } else if (fullStatus.indexOf("MARGINAL") != -1) {
-    return "MARGINAL";
-  } else {
-    return "UNKNOWN";
-  }
+// ==================== 水质数据显示 ====================
+void requestFullRefresh() {
+  fullRefreshRequested = true;
 }
 
-// ==================== 水质数据显示 ====================
-void updateWaterQualityDisplay() {
-  Serial.println("开始更新E-Paper显示水质数据...");
+void updateWaterQualityDisplay(const Measurement& m) {
+  PERF_SCOPE(PERF_DISPLAY_TOTAL);
+  LOG_PRINTLN(LOG_DBG, "开始更新E-Paper显示水质数据...");
+  
+  // 长按请求的完整刷新：先整屏清除残影
+  if (fullRefreshRequested) {
+    fullRefreshRequested = false;
+    clearEntireScreen();
+  }
   
-  displaySensorData();
+  displaySensorData(m);
   
-  Serial.println("水质数据显示更新完成");
+  LOG_PRINTLN(LOG_DBG, "水质数据显示更新完成");
 }
 
-void displaySensorData() {
-  Serial.println("更新传感器数据显示...");
+void displaySensorData(const Measurement& m) {
+  LOG_PRINTLN(LOG_DBG, "更新传感器数据显示...");
+  wakeDisplay();
   
   // === 关键：使用简化清屏避免卡死 ===
-  Serial.println("清除屏幕内容...");
+  LOG_PRINTLN(LOG_DBG, "清除屏幕内容...");
   epd.ClearFrameMemory(0xFF);
   // 注意：不立即DisplayFrame，等所有内容准备好后一次性刷新
   
@@ -176,23 +195,23 @@ void displaySensorData() {
   // 温度显示
   paint.Clear(UNCOLORED);
   char tempStr[25];
-  sprintf(tempStr, " Temp: %.1f C", waterTemperature);
+  sprintf(tempStr, " Temp: %.1f C", m.temperature);
   paint.DrawStringAt(2, 2, tempStr, &Font12, COLORED);
   epd.SetFrameMemory(paint.GetImage(), 0, currentY, paint.GetWidth(), paint.GetHeight());
   currentY += LINE_SPACING;
   
   // pH显示 - 根据是否excellent决定显示样式
-  if (isExcellentpH(pHValue)) {
+  if (m.assessment.grades[PARAM_PH] == QUALITY_EXCELLENT) {
     // excellent - 白底黑字
     paint.Clear(UNCOLORED);
     char phStr[25];
-    sprintf(phStr, "   pH: %.2f", pHValue);
+    sprintf(phStr, "   pH: %.2f", m.pH);
     paint.DrawStringAt(2, 2, phStr, &Font12, COLORED);
   } else {
     // 不是excellent - 黑底白字，垂直居中
     paint.Clear(COLORED);  // 黑色背景
     char phStr[25];
-    sprintf(phStr, "   pH: %.2f", pHValue);
+    sprintf(phStr, "   pH: %.2f", m.pH);
     // 垂直居中计算：(画布高度20 - 字体高度12) / 2 = 4
     paint.DrawStringAt(2, 4, phStr, &Font12, UNCOLORED);
   }
@@ -200,17 +219,17 @@ void displaySensorData() {
   currentY += LINE_SPACING;
 
   // 浊度显示 - 根据是否excellent决定显示样式
-  if (isExcellentTurbidity(turbidityNTU)) {
+  if (m.assessment.grades[PARAM_TURBIDITY] == QUALITY_EXCELLENT) {
     // excellent - 白底黑字
     paint.Clear(UNCOLORED);
     char turbStr[25];
-    sprintf(turbStr, " Turb: %.1f NTU", turbidityNTU);
+    sprintf(turbStr, " Turb: %.1f NTU", m.turbidity);
     paint.DrawStringAt(2, 2, turbStr, &Font12, COLORED);
   } else {
     // 不是excellent - 黑底白字，垂直居中
     paint.Clear(COLORED);  // 黑色背景
     char turbStr[25];
-    sprintf(turbStr, " Turb: %.1f NTU", turbidityNTU);
+    sprintf(turbStr, " Turb: %.1f NTU", m.turbidity);
     // 垂直居中计算：(画布高度20 - 字体高度12) / 2 = 4
     paint.DrawStringAt(2, 4, turbStr, &Font12, UNCOLORED);
   }
@@ -218,17 +237,17 @@ void displaySensorData() {
   currentY += LINE_SPACING;
 
   // TDS显示 - 根据是否excellent决定显示样式
-  if (isExcellentTDS(tdsValue)) {
+  if (m.assessment.grades[PARAM_TDS] == QUALITY_EXCELLENT) {
     // excellent - 白底黑字
     paint.Clear(UNCOLORED);
     char tdsStr[25];
-    sprintf(tdsStr, "  TDS: %.1f ppm", tdsValue);
+    sprintf(tdsStr, "  TDS: %.1f ppm", m.tds);
     paint.DrawStringAt(2, 2, tdsStr, &Font12, COLORED);
   } else {
     // 不是excellent - 黑底白字，垂直居中
     paint.Clear(COLORED);  // 黑色背景
     char tdsStr[25];
-    sprintf(tdsStr, "  TDS: %.1f ppm", tdsValue);
+    sprintf(tdsStr, "  TDS: %.1f ppm", m.tds);
     // 垂直居中计算：(画布高度20 - 字体高度12) / 2 = 4
     paint.DrawStringAt(2, 4, tdsStr, &Font12, UNCOLORED);
   }
@@ -236,17 +255,17 @@ void displaySensorData() {
   currentY += LINE_SPACING;
 
   // 电导率显示 - 根据是否excellent决定显示样式
-  if (isExcellentEC(conductivityValue)) {
+  if (m.assessment.grades[PARAM_EC] == QUALITY_EXCELLENT) {
     // excellent - 白底黑字
     paint.Clear(UNCOLORED);
     char ecStr[30];
-    sprintf(ecStr, "   EC: %.1f uS/cm", conductivityValue);
+    sprintf(ecStr, "   EC: %.1f uS/cm", m.conductivity);
     paint.DrawStringAt(2, 2, ecStr, &Font12, COLORED);
   } else {
     // 不是excellent - 黑底白字，垂直居中
     paint.Clear(COLORED);  // 黑色背景
     char ecStr[30];
-    sprintf(ecStr, "   EC: %.1f uS/cm", conductivityValue);
+    sprintf(ecStr, "   EC: %.1f uS/cm", m.conductivity);
     // 垂直居中计算：(画布高度20 - 字体高度12) / 2 = 4
     paint.DrawStringAt(2, 4, ecStr, &Font12, UNCOLORED);
   }
@@ -256,30 +275,16 @@ void displaySensorData() {
   currentY += LINE_SPACING;  // 这会创建一个空行
   // === 水质状态显示 - 使用Font16并统一黑底白字显示 ===
   paint.SetHeight(32);  // 32像素高的画布
-  String status = getSimplifiedWaterStatus();
+  const char* status = getWaterQualityName(m.assessment.overall);
   
   // 统一使用黑底白字显示，突出所有状态
   paint.Clear(COLORED);  // 黑色背景
   
-  if (status.indexOf("UNSAFE") != -1) {
-    // UNSAFE - 黑底白字
-    // "UNSAFE" = 6个字符，Font16每字符11像素，总宽66像素
-    // 水平居中：(128 - 66) / 2 = 31像素
-    // 垂直居中：(32 - 16) / 2 = 8像素
-    paint.DrawStringAt(31, 8, status.c_str(), &Font16, UNCOLORED);
-  } else if (status.indexOf("EXCELLENT") != -1) {
-    // EXCELLENT - 黑底白字（与UNSAFE统一）
-    // "EXCELLENT" = 9个字符，Font16每字符11像素，总宽99像素
-    // 水平居中：(128 - 99) / 2 = 14像素
-    // 垂直居中：(32 - 16) / 2 = 8像素
-    paint.DrawStringAt(14, 8, status.c_str(), &Font16, UNCOLORED);
-  } else {
-    // MARGINAL或其他 - 黑底白字（与UNSAFE统一）
-    // "MARGINAL" = 8个字符，Font16每字符11像素，总宽88像素
-    // 水平居中：(128 - 88) / 2 = 20像素
-    // 垂直居中：(32 - 16) / 2 = 8像素
-    paint.DrawStringAt(20, 8, status.c_str(), &Font16, UNCOLORED);
-  }
+  // Font16每字符11像素，水平居中：(128 - 字符数 * 11) / 2
+  // 例如 "EXCELLENT" 9个字符 → 14像素，"UNSAFE" 6个字符 → 31像素
+  // 垂直居中：(32 - 16) / 2 = 8像素
+  int statusX = (128 - (int)strlen(status) * 11) / 2;
+  paint.DrawStringAt(statusX, 8, status, &Font16, UNCOLORED);
   
   epd.SetFrameMemory(paint.GetImage(), 0, currentY, paint.GetWidth(), paint.GetHeight());
   
@@ -296,17 +301,16 @@ void displaySensorData() {
   // 调整底部位置：296 - 50 = 246  
   epd.SetFrameMemory(paint.GetImage(), 0, 246, paint.GetWidth(), paint.GetHeight());
   
-  Serial.println("刷新显示到屏幕...");
+  LOG_PRINTLN(LOG_DBG, "刷新显示到屏幕...");
   epd.DisplayFrame();
-  delay(2000);
   
-  Serial.println("传感器数据显示完成");
+  LOG_PRINTLN(LOG_DBG, "传感器数据显示完成");
 }
 
 // ==================== 显示错误信息 ====================
 void displayError(const char* errorMsg) {
-  Serial.print("显示错误信息: ");
-  Serial.println(errorMsg);
+  LOG_PRINT(LOG_WRN, "显示错误信息: ");
+  LOG_PRINTLN(LOG_WRN, errorMsg);
   
   // 先清屏
   clearEntireScreen();
@@ -327,12 +331,11 @@ void displayError(const char* errorMsg) {
   epd.SetFrameMemory(paint.GetImage(), 0, 80, paint.GetWidth(), paint.GetHeight());
   
   epd.DisplayFrame();
-  delay(3000);
 }
 
 // ==================== 显示进度信息 ====================
 void displayProgress(const char* progressMsg) {
-  Serial.print("显示进度: ");
-  Serial.println(progressMsg);
+  LOG_PRINT(LOG_INF, "显示进度: ");
+  LOG_PRINTLN(LOG_INF, progressMsg);
   // 避免频繁刷新E-Paper，只在串口显示
 }
\ No newline at end of file
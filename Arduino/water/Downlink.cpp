@@ -0,0 +1,205 @@
+/**
+ * Downlink.cpp - LoRaWAN下行命令协议实现
+ *
+ * 先整体校验TLV结构，再通过命令表分发给各处理函数；
+ * 每个处理函数自行校验数值范围，校验失败的命令不会生效
+ */
+
+#define LOG_MODULE LOG_MOD_LORA
+
+#include "Downlink.h"
+#include "LoRaComm.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+// ==================== 全局变量定义 ====================
+DownlinkStats downlinkStats = {0, 0, 0, 0, 0};
+
+// ==================== 大端读取辅助函数 ====================
+static uint16_t readUint16(const uint8_t* p) {
+  return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static int16_t readInt16(const uint8_t* p) {
+  return (int16_t)readUint16(p);
+}
+
+static uint32_t readUint32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | p[3];
+}
+
+// ==================== 命令处理函数 ====================
+// 分发前已按表中的固定长度检查，处理函数不再使用 length
+static bool handleSetUplinkInterval(const uint8_t* value, uint8_t) {
+  uint32_t seconds = readUint32(value);
+  if (seconds < DL_MIN_UPLINK_INTERVAL || seconds > DL_MAX_UPLINK_INTERVAL) {
+    return false;
+  }
+  setLoRaSendInterval(seconds * 1000UL);
+  return true;
+}
+
+static bool handleSetAutoSend(const uint8_t* value, uint8_t) {
+  if (value[0] > 1) {
+    return false;
+  }
+  enableAutoSend(value[0] == 1);
+  return true;
+}
+
+static bool handleSetPayloadFormat(const uint8_t* value, uint8_t) {
+  return setPayloadFormat(value[0]);
+}
+
+static bool handleFlushBacklog(const uint8_t*, uint8_t) {
+  // 在下行处理结束后由LoRa处理函数补发，避免在接收过程中发送
+  backlogFlushRequested = true;
+  return true;
+}
+
+// 阈值的定点倍数，按参数量程选择，保证 int16 能覆盖默认范围（TDS/电导率可达数百）
+static const float THRESHOLD_SCALE[PARAM_COUNT] = {
+  100.0,   // pH
+  10.0,    // 浊度 NTU
+  1.0,     // TDS ppm
+  1.0      // 电导率 μS/cm
+};
+
+static bool handleSetThresholds(const uint8_t* value, uint8_t) {
+  if (value[0] >= PARAM_COUNT) {
+    return false;
+  }
+  float scale = THRESHOLD_SCALE[value[0]];
+  ParameterThresholds thresholds;
+  thresholds.excellentMin  = readInt16(&value[1]) / scale;
+  thresholds.excellentMax  = readInt16(&value[3]) / scale;
+  thresholds.acceptableMin = readInt16(&value[5]) / scale;
+  thresholds.acceptableMax = readInt16(&value[7]) / scale;
+  return setParameterThresholds(value[0], thresholds);
+}
+
+static bool handleSetCalibration(const uint8_t* value, uint8_t) {
+  int32_t scaled = (int32_t)readUint32(&value[1]);
+  return setCalibrationValue(value[0], scaled / 1000.0);
+}
+
+static bool handleSetRedundancy(const uint8_t* value, uint8_t) {
+  return setRedundancyDepth(value[0]);
+}
+
+static bool handleSetSampling(const uint8_t* value, uint8_t) {
+  uint32_t seconds = readUint32(&value[1]);
+  if (value[0] > 1 || seconds < DL_MIN_UPLINK_INTERVAL || seconds > DL_MAX_UPLINK_INTERVAL) {
+    return false;
+  }
+  setSamplingInterval(seconds * 1000UL);
+  enablePeriodicSampling(value[0] == 1);
+  return true;
+}
+
+static bool handleSetProfile(const uint8_t* value, uint8_t) {
+  return setWaterQualityProfile(value[0], true);
+}
+
+// ==================== 命令分发表 ====================
+struct DownlinkHandler {
+  uint8_t type;
+  uint8_t length;   // 值的固定长度
+  const char* name;
+  bool (*handle)(const uint8_t* value, uint8_t length);
+};
+
+static const DownlinkHandler DOWNLINK_HANDLERS[] = {
+  {DL_SET_UPLINK_INTERVAL, 4, "SET_UPLINK_INTERVAL", handleSetUplinkInterval},
+  {DL_SET_AUTOSEND,        1, "SET_AUTOSEND",        handleSetAutoSend},
+  {DL_SET_PAYLOAD_FORMAT,  1, "SET_PAYLOAD_FORMAT",  handleSetPayloadFormat},
+  {DL_FLUSH_BACKLOG,       0, "FLUSH_BACKLOG",       handleFlushBacklog},
+  {DL_SET_THRESHOLDS,      9, "SET_THRESHOLDS",      handleSetThresholds},
+  {DL_SET_CALIBRATION,     5, "SET_CALIBRATION",     handleSetCalibration},
+  {DL_SET_REDUNDANCY,      1, "SET_REDUNDANCY",      handleSetRedundancy},
+  {DL_SET_SAMPLING,        5, "SET_SAMPLING",        handleSetSampling},
+  {DL_SET_PROFILE,         1, "SET_PROFILE",         handleSetProfile},
+};
+
+static const int DOWNLINK_HANDLER_COUNT = sizeof(DOWNLINK_HANDLERS) / sizeof(DOWNLINK_HANDLERS[0]);
+
+static const DownlinkHandler* findHandler(uint8_t type) {
+  for (int i = 0; i < DOWNLINK_HANDLER_COUNT; i++) {
+    if (DOWNLINK_HANDLERS[i].type == type) {
+      return &DOWNLINK_HANDLERS[i];
+    }
+  }
+  return NULL;
+}
+
+// ==================== 下行帧处理 ====================
+int processDownlink(const uint8_t* data, int length) {
+  if (length <= 0) {
+    return 0;
+  }
+  downlinkStats.framesReceived++;
+
+  // 第一遍：校验整帧结构，任何一条命令格式错误则整帧丢弃
+  int offset = 0;
+  while (offset < length) {
+    if (offset + 2 > length) {
+      LOG_PRINTLN(LOG_ERR, "✗ 下行帧被截断，已丢弃");
+      downlinkStats.framesRejected++;
+      return 0;
+    }
+
+    const DownlinkHandler* handler = findHandler(data[offset]);
+    uint8_t valueLength = data[offset + 1];
+
+    if (handler == NULL || valueLength != handler->length ||
+        offset + 2 + valueLength > length) {
+      LOG_PRINT(LOG_ERR, "✗ 无效的下行命令 0x");
+      LOG_PRINT(LOG_ERR, data[offset], HEX);
+      LOG_PRINTLN(LOG_ERR, "，整帧已丢弃");
+      downlinkStats.framesRejected++;
+      return 0;
+    }
+
+    offset += 2 + valueLength;
+  }
+
+  // 第二遍：依次执行命令
+  int applied = 0;
+  offset = 0;
+  while (offset < length) {
+    const DownlinkHandler* handler = findHandler(data[offset]);
+    uint8_t valueLength = data[offset + 1];
+    const uint8_t* value = &data[offset + 2];
+
+    downlinkStats.lastCommand = handler->type;
+    LOG_PRINT(LOG_INF, "下行命令: ");
+    LOG_PRINT(LOG_INF, handler->name);
+
+    if (handler->handle(value, valueLength)) {
+      LOG_PRINTLN(LOG_INF, " ✓");
+      downlinkStats.commandsApplied++;
+      applied++;
+    } else {
+      LOG_PRINTLN(LOG_ERR, " ✗ 参数无效");
+      downlinkStats.commandsRejected++;
+    }
+
+    offset += 2 + valueLength;
+  }
+
+  TRACE(TRACE_DOWNLINK, length, applied);
+  return applied;
+}
+
+// ==================== 状态输出 ====================
+void printDownlinkStats() {
+  Serial.print("下行帧: ");
+  Serial.print(downlinkStats.framesReceived);
+  Serial.print(" (丢弃 ");
+  Serial.print(downlinkStats.framesRejected);
+  Serial.print("), 命令成功/失败: ");
+  Serial.print(downlinkStats.commandsApplied);
+  Serial.print("/");
+  Serial.println(downlinkStats.commandsRejected);
+}
@@ -0,0 +1,46 @@
+/**
+ * Downlink.h - LoRaWAN下行命令协议头文件
+ *
+ * 紧凑的TLV二进制格式，用于远程调整采样/上传间隔、自动发送、
+ * 上行数据格式、补发缓存、水质标准配置、阈值和校准常数
+ *
+ * 帧格式: [类型 1字节][长度 1字节][值 N字节] ... 可串联多条命令
+ * 多字节数值一律为大端（与上行数据一致）
+ */
+
+#ifndef DOWNLINK_H
+#define DOWNLINK_H
+
+#include <Arduino.h>
+
+// ==================== 命令类型 ====================
+#define DL_SET_UPLINK_INTERVAL  0x01  // uint32 秒 (60 - 86400)
+#define DL_SET_AUTOSEND         0x02  // uint8  0 = 关闭, 1 = 开启
+#define DL_SET_PAYLOAD_FORMAT   0x03  // uint8  PayloadFormat
+#define DL_FLUSH_BACKLOG        0x04  // 无值
+#define DL_SET_THRESHOLDS       0x05  // uint8 参数 + int16 x4 (优秀下限/上限, 可接受下限/上限; pH x100, 浊度 x10, TDS/电导率 x1)
+#define DL_SET_CALIBRATION      0x06  // uint8 CalibrationId + int32 (x1000)
+#define DL_SET_REDUNDANCY       0x07  // uint8 冗余深度 (0 - LORA_REDUNDANCY_MAX_DEPTH)
+#define DL_SET_SAMPLING         0x08  // uint8 0 = 关闭, 1 = 开启 + uint32 采样间隔秒 (60 - 86400)
+#define DL_SET_PROFILE          0x09  // uint8 WaterQualityProfileId，保存到Flash
+
+// ==================== 参数范围 ====================
+#define DL_MIN_UPLINK_INTERVAL  60UL      // 1分钟
+#define DL_MAX_UPLINK_INTERVAL  86400UL   // 24小时
+
+// ==================== 处理结果统计 ====================
+struct DownlinkStats {
+  uint32_t framesReceived;    // 收到的下行帧
+  uint32_t framesRejected;    // 格式错误被整帧丢弃的帧
+  uint32_t commandsApplied;   // 成功执行的命令
+  uint32_t commandsRejected;  // 校验失败的命令
+  uint8_t lastCommand;        // 最近一条命令类型
+};
+
+extern DownlinkStats downlinkStats;
+
+// ==================== 函数声明 ====================
+int processDownlink(const uint8_t* data, int length);  // 返回成功执行的命令数
+void printDownlinkStats();
+
+#endif // DOWNLINK_H
@@ -0,0 +1,49 @@
+/**
+ * Hal.h - 硬件抽象层头文件
+ *
+ * 驱动代码通过这些函数访问 ADC、GPIO、SPI 和串口原始字节，
+ * 板上由 HalArduino.cpp 转发到 Arduino 核心库，
+ * 主机构建（Arduino/host）由 HalLinux.cpp 提供可控的模拟实现，
+ * 这样绘图、编码、水质评估等逻辑可以在电脑上编译、测试和性能分析
+ *
+ * 时钟：应用代码继续使用 millis()/micros()/delay()，
+ *       主机端的 Arduino 兼容层把它们转发到这里的 halMillis() 等函数
+ * 调制解调器：沿用 MKRWAN 的 LoRaModem 接口，主机端提供同名的模拟类
+ * 格式化输出：继续使用 Serial.print()，主机端同样经 halSerialWrite() 输出
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 时钟 ====================
+uint32_t halMillis();
+uint32_t halMicros();
+void halDelay(uint32_t ms);
+
+// ==================== GPIO ====================
+typedef void (*HalIsr)();
+
+void halPinMode(uint8_t pin, uint8_t mode);
+void halDigitalWrite(uint8_t pin, uint8_t value);
+int halDigitalRead(uint8_t pin);
+void halAttachInterrupt(uint8_t pin, HalIsr isr, uint8_t mode);
+
+// ==================== ADC ====================
+int halAnalogRead(uint8_t pin);
+
+// ==================== SPI ====================
+void halSpiBegin();
+void halSpiEnd();
+uint8_t halSpiTransfer(uint8_t data);
+
+// ==================== 串口原始字节 ====================
+int halSerialAvailable();
+int halSerialRead();                   // 没有数据时返回-1
+size_t halSerialWrite(const uint8_t* data, size_t length);
+int halSerialAvailableForWrite();
+bool halSerialHostAttached();          // 电脑端是否打开了串口
+
+#endif // HAL_H
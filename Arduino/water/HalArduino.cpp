@@ -0,0 +1,94 @@
+/**
+ * HalArduino.cpp - 硬件抽象层的 Arduino 实现
+ *
+ * 只是对 Arduino 核心库的直接转发。这些函数在单独的编译单元里，SAMD 构建
+ * 没有 LTO，不会被内联；多一次函数调用相对 analogRead()、SPI.transfer() 本身可以忽略
+ * 主机构建不定义 ARDUINO，整个文件为空，由 Arduino/host/HalLinux.cpp 代替
+ */
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "Hal.h"
+
+// E-Paper 的 SPI 参数（2MHz，模式0）
+#define HAL_SPI_CLOCK 2000000
+
+// ==================== 时钟 ====================
+uint32_t halMillis() {
+  return millis();
+}
+
+uint32_t halMicros() {
+  return micros();
+}
+
+void halDelay(uint32_t ms) {
+  delay(ms);
+}
+
+// ==================== GPIO ====================
+void halPinMode(uint8_t pin, uint8_t mode) {
+  pinMode(pin, mode);
+}
+
+void halDigitalWrite(uint8_t pin, uint8_t value) {
+  digitalWrite(pin, value);
+}
+
+int halDigitalRead(uint8_t pin) {
+  return digitalRead(pin);
+}
+
+void halAttachInterrupt(uint8_t pin, HalIsr isr, uint8_t mode) {
+  attachInterrupt(digitalPinToInterrupt(pin), isr, mode);
+}
+
+// ==================== ADC ====================
+int halAnalogRead(uint8_t pin) {
+  return analogRead(pin);
+}
+
+// ==================== SPI ====================
+void halSpiBegin() {
+  SPI.begin();
+  SPI.beginTransaction(SPISettings(HAL_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+}
+
+void halSpiEnd() {
+  SPI.endTransaction();
+  SPI.end();
+}
+
+uint8_t halSpiTransfer(uint8_t data) {
+  return SPI.transfer(data);
+}
+
+// ==================== 串口原始字节 ====================
+int halSerialAvailable() {
+  return Serial.available();
+}
+
+int halSerialRead() {
+  return Serial.read();
+}
+
+size_t halSerialWrite(const uint8_t* data, size_t length) {
+  return Serial.write(data, length);
+}
+
+int halSerialAvailableForWrite() {
+  return Serial.availableForWrite();
+}
+
+bool halSerialHostAttached() {
+#if defined(ARDUINO_ARCH_SAMD)
+  // USB CDC的DTR信号：电脑端打开串口时置位
+  return Serial.dtr();
+#else
+  return true;
+#endif
+}
+
+#endif // ARDUINO
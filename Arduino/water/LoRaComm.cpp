@@ -5,8 +5,13 @@
  * 处理水质数据的LoRaWAN上传功能
  */
 
+#define LOG_MODULE LOG_MOD_LORA
+
 #include "LoRaComm.h"
+#include "LoRaSession.h"
 #include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+#include "Downlink.h"
 
 // ==================== 全局变量定义 ====================
 LoRaModem loraModem;
@@ -15,21 +20,59 @@ bool loraConnected = false;
 unsigned long lastLoRaSend = 0;
 int loraRetryCount = 0;
 bool autoSendEnabled = false;  // 新增：默认关闭自动发送
+unsigned long loraSendInterval = LORA_SEND_INTERVAL;
+uint8_t payloadFormat = PAYLOAD_FORMAT_LEGACY;
+bool backlogFlushRequested = false;
+uint8_t redundancyDepth = LORA_REDUNDANCY_DEPTH;
+
+// 已发送读数的历史（[0]为最近一条），用于冗余格式
+struct SentRecord {
+  WaterQualityPacket packet;
+  uint16_t fcnt;
+  bool valid;
+};
+static SentRecord sentHistory[LORA_REDUNDANCY_MAX_DEPTH];
+static int currentLoRaPort = -1;
+
+// 发送失败数据的环形缓存（最旧的数据在head）
+static WaterQualityPacket loraBacklog[LORA_BACKLOG_SIZE];
+static int loraBacklogHead = 0;
+static int loraBacklogCount = 0;
+
+UplinkPolicy uplinkPolicy = {
+  LORA_CONFIRM_EVERY_N_FRAMES,
+  LORA_CONFIRM_MAX_INTERVAL,
+  LORA_CONFIRM_UNSAFE
+};
+LinkHealthStats linkHealth = {0, 0, 0, 0, 0, 0, 0, false};
+DataRateState dataRateState = {
+  LORA_ADR_ENABLED && !LORA_LOCAL_DR_POLICY,
+  LORA_LOCAL_DR_POLICY,
+  LORA_DEFAULT_DATA_RATE,
+  0,
+  {},
+  0,
+  0
+};
+
+static const char* const DR_REASON_NAMES[] = {
+  "入网", "ADR", "本地升速", "本地降速", "手动"
+};
 
 // ==================== LoRa初始化 ====================
 bool initializeLoRa() {
-  Serial.println("正在初始化LoRa模块...");
+  LOG_PRINTLN(LOG_INF, "正在初始化LoRa模块...");
   
   // 初始化LoRa模块
   if (!loraModem.begin(EU868)) {  // 根据你的地区调整：EU868, US915, AS923等
-    Serial.println("✗ LoRa模块初始化失败!");
+    LOG_PRINTLN(LOG_ERR, "✗ LoRa模块初始化失败!");
     return false;
   }
   
   loraInitialized = true;
-  Serial.println("✓ LoRa模块初始化成功");
-  Serial.print("设备EUI: ");
-  Serial.println(loraModem.deviceEUI());
+  LOG_PRINTLN(LOG_INF, "✓ LoRa模块初始化成功");
+  LOG_PRINT(LOG_INF, "设备EUI: ");
+  LOG_PRINTLN(LOG_INF, loraModem.deviceEUI());
   
   return true;
 }
@@ -37,167 +80,537 @@ bool initializeLoRa() {
 // ==================== 连接到网络 ====================
 bool connectToNetwork() {
   if (!loraInitialized) {
-    Serial.println("LoRa模块未初始化");
+    LOG_PRINTLN(LOG_INF, "LoRa模块未初始化");
     return false;
   }
   
-  Serial.println("正在连接到LoRaWAN网络...");
+  LOG_PRINTLN(LOG_INF, "正在连接到LoRaWAN网络...");
   
   unsigned long startTime = millis();
-  int connected = loraModem.joinOTAA(APP_EUI, APP_KEY);
-  
-  if (!connected) {
-    Serial.println("✗ 网络连接失败!");
-    Serial.println("请检查:");
-    Serial.println("  - App EUI和App Key是否正确");
-    Serial.println("  - 是否有网关覆盖");
-    Serial.println("  - 频段设置是否正确");
-    return false;
-  }
   
-  loraConnected = true;
-  Serial.println("✓ 成功连接到LoRaWAN网络!");
+  // 优先恢复Flash中保存的会话，跳过OTAA入网
+  if (restoreLoRaSession()) {
+    loraConnected = true;
+    LOG_PRINTLN(LOG_INF, "✓ 已使用保存的会话连接到LoRaWAN网络!");
+  } else {
+    int connected = loraModem.joinOTAA(APP_EUI, APP_KEY);
+    
+    if (!connected) {
+      LOG_PRINTLN(LOG_ERR, "✗ 网络连接失败!");
+      LOG_PRINTLN(LOG_INF, "请检查:");
+      LOG_PRINTLN(LOG_INF, "  - App EUI和App Key是否正确");
+      LOG_PRINTLN(LOG_INF, "  - 是否有网关覆盖");
+      LOG_PRINTLN(LOG_INF, "  - 频段设置是否正确");
+      return false;
+    }
+    
+    loraConnected = true;
+    LOG_PRINTLN(LOG_INF, "✓ 成功连接到LoRaWAN网络!");
+    
+    // 保存新会话，下次上电直接恢复
+    saveLoRaSession();
+  }
   
-  // 设置更高的数据速率以支持更大的数据包
-  loraModem.dataRate(3);  // SF9BW125 - 更好的兼容性
-  Serial.println("数据速率设置为DR3 (SF9BW125)");
+  // 设置初始数据速率并启用ADR（或本地速率策略）
+  configureDataRate();
   
-  Serial.print("连接耗时: ");
-  Serial.print((millis() - startTime) / 1000);
-  Serial.println(" 秒");
+  LOG_PRINT(LOG_INF, "连接耗时: ");
+  LOG_PRINT(LOG_INF, (millis() - startTime) / 1000);
+  LOG_PRINTLN(LOG_INF, " 秒");
   
   return true;
 }
 
 // ==================== 数据打包 ====================
-WaterQualityPacket packWaterQualityData() {
+WaterQualityPacket packWaterQualityData(const Measurement& m) {
   WaterQualityPacket packet;
   
   // 温度（乘以100保留两位小数）
-  packet.temperature = (uint16_t)(waterTemperature * 100);
+  packet.temperature = (uint16_t)(m.temperature * 100);
   
   // pH（乘以100保留两位小数）
-  packet.ph = (uint16_t)(pHValue * 100);
+  packet.ph = (uint16_t)(m.pH * 100);
   
   // 浊度（乘以10保留一位小数）
-  packet.turbidity = (uint16_t)(turbidityNTU * 10);
+  packet.turbidity = (uint16_t)(m.turbidity * 10);
   
   // 电导率（乘以10保留一位小数）
-  packet.conductivity = (uint16_t)(conductivityValue * 10);
+  packet.conductivity = (uint16_t)(m.conductivity * 10);
   
   // TDS（乘以10保留一位小数）
-  packet.tds = (uint16_t)(tdsValue * 10);
+  packet.tds = (uint16_t)(m.tds * 10);
+  
+  // 后端按分级时使用的配置重新解释读数
+  packet.profile = m.profile;
+  packet.flags = isMeasurementSettled(m) ? 0 : PACKET_FLAG_UNSETTLED;
   
   return packet;
 }
 
+// ==================== 数据编码 ====================
+static int encodeField(uint8_t* buffer, uint16_t value) {
+  buffer[0] = (value >> 8) & 0xFF;
+  buffer[1] = value & 0xFF;
+  return 2;
+}
+
+static int encodeRecord(const WaterQualityPacket& packet, uint8_t* buffer) {
+  int offset = 0;
+  offset += encodeField(&buffer[offset], packet.temperature);
+  offset += encodeField(&buffer[offset], packet.ph);
+  offset += encodeField(&buffer[offset], packet.turbidity);
+  offset += encodeField(&buffer[offset], packet.conductivity);
+  offset += encodeField(&buffer[offset], packet.tds);
+  return offset;  // 10字节
+}
+
+static int encodeDeltaRecord(const WaterQualityPacket& current, const SentRecord& previous,
+                             uint16_t currentFcnt, bool fcntKnown, uint8_t* buffer) {
+  const uint16_t currentFields[5] = {
+    current.temperature, current.ph, current.turbidity, current.conductivity, current.tds
+  };
+  const uint16_t previousFields[5] = {
+    previous.packet.temperature, previous.packet.ph, previous.packet.turbidity,
+    previous.packet.conductivity, previous.packet.tds
+  };
+  
+  // 帧计数差超出1字节范围时记为未知
+  uint16_t fcntDelta = (uint16_t)(currentFcnt - previous.fcnt);
+  buffer[0] = (fcntKnown && previous.valid && fcntDelta <= 0xFF) ? (uint8_t)fcntDelta : 0;
+  
+  int offset = 2;
+  uint8_t widthMask = 0;
+  for (int i = 0; i < 5; i++) {
+    int32_t delta = (int32_t)previousFields[i] - (int32_t)currentFields[i];
+    if (delta >= -128 && delta <= 127) {
+      buffer[offset++] = (uint8_t)(int8_t)delta;
+    } else {
+      widthMask |= (1 << i);
+      offset += encodeField(&buffer[offset], previousFields[i]);
+    }
+  }
+  buffer[1] = widthMask;
+  
+  return offset;
+}
+
+int encodeWaterQualityPayload(const WaterQualityPacket& packet, int fcnt, uint8_t* buffer, int bufferSize) {
+  if (payloadFormat != PAYLOAD_FORMAT_REDUNDANT) {
+    int length = encodeRecord(packet, buffer);
+    buffer[length++] = packet.profile | packet.flags;
+    return length;
+  }
+  
+  int offset = 1;
+  uint8_t depth = 0;
+  
+  buffer[offset++] = packet.profile | packet.flags;
+  offset += encodeRecord(packet, &buffer[offset]);
+  
+  // 差分记录最长12字节，放不下时减少冗余深度
+  for (uint8_t i = 0; i < redundancyDepth && i < LORA_REDUNDANCY_MAX_DEPTH; i++) {
+    if (!sentHistory[i].valid || offset + 12 > bufferSize) {
+      break;
+    }
+    offset += encodeDeltaRecord(packet, sentHistory[i], (uint16_t)fcnt, fcnt >= 0, &buffer[offset]);
+    depth++;
+  }
+  
+  buffer[0] = (REDUNDANT_PAYLOAD_VERSION << 4) | depth;
+  return offset;
+}
+
 // ==================== 发送数据包 ====================
-bool sendDataPacket(const WaterQualityPacket& packet) {
+bool sendDataPacket(const WaterQualityPacket& packet, bool confirmed) {
+  PERF_SCOPE(PERF_SEND_PACKET);
   if (!loraConnected) {
-    Serial.println("LoRa未连接到网络");
+    LOG_PRINTLN(LOG_INF, "LoRa未连接到网络");
     return false;
   }
   
-  Serial.println("\n=== 发送水质数据到TTN ===");
-  Serial.print("数据包大小: ");
-  Serial.print(sizeof(packet));
-  Serial.println(" 字节");
+  LOG_PRINTLN(LOG_INF, "\n=== 发送水质数据到TTN ===");
+  LOG_PRINT(LOG_INF, "帧类型: ");
+  LOG_PRINTLN(LOG_INF, confirmed ? "确认帧" : "非确认帧");
   
+#if LORA_DUMP_PAYLOAD
   // 显示要发送的数据
-  Serial.print("温度: ");
-  Serial.print(packet.temperature / 100.0, 2);
-  Serial.println("°C");
-  
-  Serial.print("pH: ");
-  Serial.print(packet.ph / 100.0, 2);
-  Serial.println();
+  LOG_PRINT(LOG_DBG, "温度: ");
+  LOG_PRINT(LOG_DBG, packet.temperature / 100.0, 2);
+  LOG_PRINTLN(LOG_DBG, "°C");
   
-  Serial.print("浊度: ");
-  Serial.print(packet.turbidity / 10.0, 1);
-  Serial.println(" NTU");
+  LOG_PRINT(LOG_DBG, "pH: ");
+  LOG_PRINT(LOG_DBG, packet.ph / 100.0, 2);
+  LOG_PRINTLN(LOG_DBG, "");
   
-  Serial.print("电导率: ");
-  Serial.print(packet.conductivity / 10.0, 1);
-  Serial.println(" μS/cm");
+  LOG_PRINT(LOG_DBG, "浊度: ");
+  LOG_PRINT(LOG_DBG, packet.turbidity / 10.0, 1);
+  LOG_PRINTLN(LOG_DBG, " NTU");
   
-  Serial.print("TDS: ");
-  Serial.print(packet.tds / 10.0, 1);
-  Serial.println(" ppm");
+  LOG_PRINT(LOG_DBG, "电导率: ");
+  LOG_PRINT(LOG_DBG, packet.conductivity / 10.0, 1);
+  LOG_PRINTLN(LOG_DBG, " μS/cm");
   
-  // 准备Big-Endian格式的数据包（TTN期望的格式）
-  uint8_t payload[10];
+  LOG_PRINT(LOG_DBG, "TDS: ");
+  LOG_PRINT(LOG_DBG, packet.tds / 10.0, 1);
+  LOG_PRINTLN(LOG_DBG, " ppm");
+#endif
   
-  // 温度 - Big Endian
-  payload[0] = (packet.temperature >> 8) & 0xFF;
-  payload[1] = packet.temperature & 0xFF;
+  // 本帧的帧计数，用于冗余副本的帧计数差
+  int fcnt = loraModem.getFCU();
   
-  // pH - Big Endian
-  payload[2] = (packet.ph >> 8) & 0xFF;
-  payload[3] = packet.ph & 0xFF;
+  // 按当前格式编码数据包（大端，TTN期望的格式）
+  uint8_t payload[LORA_MAX_PAYLOAD_SIZE];
+  int payloadLength = encodeWaterQualityPayload(packet, fcnt, payload, sizeof(payload));
+  uint8_t port = (payloadFormat == PAYLOAD_FORMAT_REDUNDANT) ? LORA_PORT_REDUNDANT : LORA_PORT_LEGACY;
   
-  // 浊度 - Big Endian
-  payload[4] = (packet.turbidity >> 8) & 0xFF;
-  payload[5] = packet.turbidity & 0xFF;
-  
-  // 电导率 - Big Endian
-  payload[6] = (packet.conductivity >> 8) & 0xFF;
-  payload[7] = packet.conductivity & 0xFF;
-  
-  // TDS - Big Endian
-  payload[8] = (packet.tds >> 8) & 0xFF;
-  payload[9] = packet.tds & 0xFF;
+  TRACE(TRACE_LORA_TX_START, ((uint16_t)port << 8) | payloadLength, (uint32_t)fcnt);
   
+#if LORA_DUMP_PAYLOAD
   // 显示发送的字节数据
-  Serial.print("发送数据: ");
-  for (int i = 0; i < 10; i++) {
-    Serial.print("0x");
-    if (payload[i] < 16) Serial.print("0");
-    Serial.print(payload[i], HEX);
-    Serial.print(" ");
+  LOG_PRINT(LOG_DBG, "发送数据 (端口");
+  LOG_PRINT(LOG_DBG, port);
+  LOG_PRINT(LOG_DBG, ", ");
+  LOG_PRINT(LOG_DBG, payloadLength);
+  LOG_PRINT(LOG_DBG, "字节): ");
+  for (int i = 0; i < payloadLength; i++) {
+    LOG_PRINT(LOG_DBG, "0x");
+    if (payload[i] < 16) LOG_PRINT(LOG_DBG, "0");
+    LOG_PRINT(LOG_DBG, payload[i], HEX);
+    LOG_PRINT(LOG_DBG, " ");
+  }
+  LOG_PRINTLN(LOG_DBG, "");
+#endif
+  
+  // 端口只在格式变化时切换
+  if (port != currentLoRaPort && loraModem.setPort(port)) {
+    currentLoRaPort = port;
   }
-  Serial.println();
   
   // 发送数据
   loraModem.beginPacket();
-  loraModem.write(payload, 10);
+  loraModem.write(payload, payloadLength);
   
-  int err = loraModem.endPacket(true);  // true = 需要确认
+  int err = loraModem.endPacket(confirmed);  // 确认帧需要等待网关ACK
+  TRACE(TRACE_LORA_TX_END, confirmed ? 1 : 0, (uint32_t)err);
+  
+  // 确认帧的结果就是链路检测结果
+  recordLinkCheckResult(confirmed, err > 0);
+  if (confirmed) {
+    // 记录确认结果（连续失败会触发重新入网）
+    recordConfirmedUplinkResult(err > 0);
+  }
+  updateLoRaSessionCounters();
+  observeDataRate();  // 记录ADR带来的速率变化
   
   if (err > 0) {
-    Serial.println("✓ 数据发送成功!");
-    Serial.println("请检查TTN Console获取解码结果");
+    // 更新已发送历史（最新在前）
+    for (int i = LORA_REDUNDANCY_MAX_DEPTH - 1; i > 0; i--) {
+      sentHistory[i] = sentHistory[i - 1];
+    }
+    sentHistory[0].packet = packet;
+    sentHistory[0].fcnt = (fcnt >= 0) ? (uint16_t)fcnt : 0;
+    sentHistory[0].valid = (fcnt >= 0);
+    
+    LOG_PRINTLN(LOG_INF, confirmed ? "✓ 数据发送成功，已收到确认!" : "✓ 数据已发送（未请求确认）");
+    LOG_PRINTLN(LOG_INF, "请检查TTN Console获取解码结果");
     loraRetryCount = 0;  // 重置重试计数
     return true;
   } else {
-    Serial.print("✗ 发送失败，错误代码: ");
-    Serial.println(err);
+    LOG_PRINT(LOG_ERR, "✗ 发送失败，错误代码: ");
+    LOG_PRINTLN(LOG_ERR, err);
     loraRetryCount++;
     return false;
   }
 }
 
+// ==================== 上行确认策略 ====================
+bool shouldConfirmUplink(bool unsafeResult) {
+  // UNSAFE结果必须确保送达
+  if (unsafeResult && uplinkPolicy.confirmUnsafe) {
+    return true;
+  }
+  
+  // 从未做过链路检测
+  if (linkHealth.confirmedSent == 0) {
+    return true;
+  }
+  
+  // 按帧数周期确认
+  if (uplinkPolicy.confirmEveryNFrames > 0 &&
+      linkHealth.framesSinceConfirm + 1 >= uplinkPolicy.confirmEveryNFrames) {
+    return true;
+  }
+  
+  // 按时间周期确认
+  if (uplinkPolicy.confirmIntervalMs > 0 &&
+      millis() - linkHealth.lastConfirmTime >= uplinkPolicy.confirmIntervalMs) {
+    return true;
+  }
+  
+  return false;
+}
+
+void recordLinkCheckResult(bool confirmed, bool ok) {
+  if (!confirmed) {
+    if (ok) {
+      linkHealth.unconfirmedSent++;
+    } else {
+      linkHealth.sendErrors++;
+    }
+    if (linkHealth.framesSinceConfirm < 0xFF) {
+      linkHealth.framesSinceConfirm++;
+    }
+    return;
+  }
+  
+  linkHealth.confirmedSent++;
+  linkHealth.framesSinceConfirm = 0;
+  linkHealth.lastConfirmTime = millis();
+  linkHealth.lastCheckOk = ok;
+  
+  if (ok) {
+    linkHealth.confirmedAcked++;
+    linkHealth.lastAckTime = millis();
+  }
+  
+  applyLocalDataRatePolicy(ok);
+}
+
+// ==================== 数据速率管理 ====================
+static void pushDataRateHistory(uint8_t dataRate, uint8_t reason) {
+  DataRateChange& entry = dataRateState.history[dataRateState.historyHead];
+  entry.time = millis();
+  entry.dataRate = dataRate;
+  entry.reason = reason;
+  
+  dataRateState.historyHead = (dataRateState.historyHead + 1) % LORA_DR_HISTORY_SIZE;
+  if (dataRateState.historyCount < LORA_DR_HISTORY_SIZE) {
+    dataRateState.historyCount++;
+  }
+}
+
+void configureDataRate() {
+  // 本地策略和ADR互斥，避免两者同时调整速率
+  loraModem.setADR(dataRateState.adrEnabled);
+  setLoRaDataRate(dataRateState.currentDataRate, DR_REASON_JOIN);
+  dataRateState.consecutiveChecksOk = 0;
+  
+  LOG_PRINT(LOG_INF, "ADR: ");
+  LOG_PRINT(LOG_INF, dataRateState.adrEnabled ? "开启" : "关闭");
+  LOG_PRINT(LOG_INF, ", 本地速率策略: ");
+  LOG_PRINTLN(LOG_INF, dataRateState.localPolicyEnabled ? "开启" : "关闭");
+}
+
+bool setLoRaDataRate(uint8_t dataRate, uint8_t reason) {
+  // DR0 即 LORA_MIN_DATA_RATE，无符号数只需检查上限
+  if (dataRate > LORA_MAX_DATA_RATE) {
+    LOG_PRINT(LOG_ERR, "✗ 数据速率超出范围: DR");
+    LOG_PRINTLN(LOG_ERR, dataRate);
+    return false;
+  }
+  
+  if (!loraModem.dataRate(dataRate)) {
+    LOG_PRINT(LOG_ERR, "✗ 设置数据速率失败: DR");
+    LOG_PRINTLN(LOG_ERR, dataRate);
+    return false;
+  }
+  
+  dataRateState.currentDataRate = dataRate;
+  pushDataRateHistory(dataRate, reason);
+  
+  LOG_PRINT(LOG_INF, "数据速率设置为DR");
+  LOG_PRINT(LOG_INF, dataRate);
+  LOG_PRINT(LOG_INF, " (SF");
+  LOG_PRINT(LOG_INF, 12 - dataRate);
+  LOG_PRINTLN(LOG_INF, "BW125)");
+  return true;
+}
+
+void observeDataRate() {
+  int dataRate = loraModem.getDataRate();
+  if (dataRate < 0 || dataRate == dataRateState.currentDataRate) {
+    return;
+  }
+  
+  // 速率不是本地设置的，说明网络通过ADR做了调整
+  dataRateState.currentDataRate = (uint8_t)dataRate;
+  pushDataRateHistory((uint8_t)dataRate, DR_REASON_ADR);
+}
+
+void applyLocalDataRatePolicy(bool checkOk) {
+  if (!dataRateState.localPolicyEnabled) {
+    return;
+  }
+  
+  if (!checkOk) {
+    // 链路检测失败：立即降一档（SF增大，覆盖更远）
+    dataRateState.consecutiveChecksOk = 0;
+    if (dataRateState.currentDataRate > LORA_MIN_DATA_RATE) {
+      setLoRaDataRate(dataRateState.currentDataRate - 1, DR_REASON_STEP_DOWN);
+    }
+    return;
+  }
+  
+  // 连续多次成功说明余量充足：升一档以减少空中时间
+  dataRateState.consecutiveChecksOk++;
+  if (dataRateState.consecutiveChecksOk >= LORA_DR_STEP_UP_CHECKS) {
+    dataRateState.consecutiveChecksOk = 0;
+    if (dataRateState.currentDataRate < LORA_MAX_DATA_RATE) {
+      setLoRaDataRate(dataRateState.currentDataRate + 1, DR_REASON_STEP_UP);
+    }
+  }
+}
+
+void enableLocalDataRatePolicy(bool enable) {
+  dataRateState.localPolicyEnabled = enable;
+  dataRateState.adrEnabled = !enable && LORA_ADR_ENABLED;
+  dataRateState.consecutiveChecksOk = 0;
+  
+  if (loraInitialized) {
+    loraModem.setADR(dataRateState.adrEnabled);
+  }
+  
+  LOG_PRINT(LOG_INF, "本地速率策略已");
+  LOG_PRINTLN(LOG_INF, enable ? "开启（ADR关闭）" : "关闭");
+}
+
+void printDataRateStatus() {
+  Serial.print("数据速率: DR");
+  Serial.print(dataRateState.currentDataRate);
+  Serial.print(" (SF");
+  Serial.print(12 - dataRateState.currentDataRate);
+  Serial.print("), ADR: ");
+  Serial.print(dataRateState.adrEnabled ? "开启" : "关闭");
+  Serial.print(", 本地策略: ");
+  Serial.println(dataRateState.localPolicyEnabled ? "开启" : "关闭");
+  
+  if (dataRateState.historyCount == 0) {
+    return;
+  }
+  
+  Serial.println("速率历史 (最新在前):");
+  for (uint8_t i = 0; i < dataRateState.historyCount; i++) {
+    uint8_t index = (dataRateState.historyHead + LORA_DR_HISTORY_SIZE - 1 - i) % LORA_DR_HISTORY_SIZE;
+    const DataRateChange& entry = dataRateState.history[index];
+    Serial.print("  DR");
+    Serial.print(entry.dataRate);
+    Serial.print(" - ");
+    Serial.print(DR_REASON_NAMES[entry.reason]);
+    Serial.print(", ");
+    Serial.print((millis() - entry.time) / 1000);
+    Serial.println(" 秒前");
+  }
+}
+
+void printLinkHealth() {
+  Serial.print("非确认帧: ");
+  Serial.print(linkHealth.unconfirmedSent);
+  Serial.print(", 发送错误: ");
+  Serial.println(linkHealth.sendErrors);
+  
+  Serial.print("链路检测: ");
+  Serial.print(linkHealth.confirmedAcked);
+  Serial.print("/");
+  Serial.print(linkHealth.confirmedSent);
+  Serial.print(" 已确认");
+  if (linkHealth.confirmedSent > 0) {
+    Serial.print(" (");
+    Serial.print(linkHealth.confirmedAcked * 100 / linkHealth.confirmedSent);
+    Serial.print("%), 最近一次: ");
+    Serial.print(linkHealth.lastCheckOk ? "成功" : "失败");
+  }
+  Serial.println();
+  
+  if (linkHealth.lastAckTime > 0) {
+    Serial.print("上次ACK: ");
+    Serial.print((millis() - linkHealth.lastAckTime) / 1000);
+    Serial.println(" 秒前");
+  }
+  
+  Serial.print("确认策略: 每");
+  Serial.print(uplinkPolicy.confirmEveryNFrames);
+  Serial.print("帧 / ");
+  Serial.print(uplinkPolicy.confirmIntervalMs / 60000);
+  Serial.print("分钟");
+  Serial.println(uplinkPolicy.confirmUnsafe ? ", UNSAFE必确认" : "");
+}
+
 // ==================== 发送水质数据 ====================
-bool sendWaterQualityData() {
-  if (!loraConnected) {
-    Serial.println("LoRa未连接，尝试重连...");
+bool sendWaterQualityData(const Measurement& m) {
+  // 打包数据
+  WaterQualityPacket packet = packWaterQualityData(m);
+  
+  if (!loraConnected || loraRejoinPending) {
+    LOG_PRINTLN(LOG_INF, "LoRa会话不可用，尝试重新入网...");
     if (!reconnectLoRa()) {
+      // 联网后由后台重连或补发逻辑发送
+      queueLoRaBacklog(packet);
       return false;
     }
   }
   
-  // 打包数据
-  WaterQualityPacket packet = packWaterQualityData();
+  // 根据确认策略决定是否请求ACK（UNSAFE结果升级为确认帧）
+  bool unsafeResult = m.assessment.overall == QUALITY_UNSAFE;
+  bool confirmed = shouldConfirmUplink(unsafeResult);
   
   // 发送数据
-  bool success = sendDataPacket(packet);
+  bool success = sendDataPacket(packet, confirmed);
   
   if (success) {
     lastLoRaSend = millis();
+  } else {
+    // 保存失败的数据，稍后补发
+    queueLoRaBacklog(packet);
   }
   
   return success;
 }
 
+// ==================== 发送失败数据缓存 ====================
+bool queueLoRaBacklog(const WaterQualityPacket& packet) {
+  if (loraBacklogCount == LORA_BACKLOG_SIZE) {
+    // 缓存已满，丢弃最旧的数据
+    loraBacklogHead = (loraBacklogHead + 1) % LORA_BACKLOG_SIZE;
+    loraBacklogCount--;
+    LOG_PRINTLN(LOG_WRN, "⚠ 缓存已满，丢弃最旧的数据");
+  }
+  
+  int tail = (loraBacklogHead + loraBacklogCount) % LORA_BACKLOG_SIZE;
+  loraBacklog[tail] = packet;
+  loraBacklogCount++;
+  
+  TRACE(TRACE_BACKLOG, loraBacklogCount, 0);
+  LOG_PRINT(LOG_INF, "数据已缓存，待发送: ");
+  LOG_PRINTLN(LOG_INF, loraBacklogCount);
+  return true;
+}
+
+int flushLoRaBacklog(int maxPackets) {
+  int sent = 0;
+  
+  while (loraBacklogCount > 0 && sent < maxPackets) {
+    if ((!loraConnected || loraRejoinPending) && !reconnectLoRa()) {
+      break;
+    }
+    
+    // 从最旧的数据开始补发
+    if (!sendDataPacket(loraBacklog[loraBacklogHead], shouldConfirmUplink(false))) {
+      break;
+    }
+    
+    loraBacklogHead = (loraBacklogHead + 1) % LORA_BACKLOG_SIZE;
+    loraBacklogCount--;
+    lastLoRaSend = millis();
+    sent++;
+  }
+  
+  return sent;
+}
+
+int getLoRaBacklogCount() {
+  return loraBacklogCount;
+}
+
 // ==================== 检查是否需要发送（修改版） ====================
 bool shouldSendLoRaData() {
   // 如果自动发送被禁用，只允许重试失败的发送
@@ -216,7 +629,7 @@ bool shouldSendLoRaData() {
   unsigned long currentTime = millis();
   
   // 检查时间间隔
-  if (currentTime - lastLoRaSend >= LORA_SEND_INTERVAL) {
+  if (currentTime - lastLoRaSend >= loraSendInterval) {
     return true;
   }
   
@@ -231,29 +644,52 @@ bool shouldSendLoRaData() {
   return false;
 }
 
+// ==================== 接收下行消息 ====================
+static void receiveDownlink() {
+  if (!loraModem.available()) {
+    return;
+  }
+  
+  uint8_t buffer[LORA_MAX_DOWNLINK_SIZE];
+  int length = 0;
+  
+  LOG_PRINTLN(LOG_DBG, "\n收到下行消息:");
+  while (loraModem.available()) {
+    uint8_t rcv = loraModem.read();
+    LOG_PRINT(LOG_DBG, "0x");
+    if (rcv < 16) LOG_PRINT(LOG_DBG, "0");
+    LOG_PRINT(LOG_DBG, rcv, HEX);
+    LOG_PRINT(LOG_DBG, " ");
+    
+    if (length < LORA_MAX_DOWNLINK_SIZE) {
+      buffer[length++] = rcv;
+    }
+  }
+  LOG_PRINTLN(LOG_DBG, "");
+  
+  // 解析并执行下行命令
+  processDownlink(buffer, length);
+}
+
 // ==================== 处理LoRa通信（原版） ====================
 void handleLoRaCommunication() {
   // 检查下行消息
-  if (loraModem.available()) {
-    Serial.println("\n收到下行消息:");
-    while (loraModem.available()) {
-      uint8_t rcv = loraModem.read();
-      Serial.print("0x");
-      if (rcv < 16) Serial.print("0");
-      Serial.print(rcv, HEX);
-      Serial.print(" ");
-    }
-    Serial.println();
+  receiveDownlink();
+  
+  // 下行命令请求补发缓存数据
+  if (backlogFlushRequested) {
+    backlogFlushRequested = false;
+    flushLoRaBacklog(LORA_BACKLOG_SIZE);
   }
   
   // 检查是否需要发送数据
   if (shouldSendLoRaData()) {
     if (loraRetryCount >= LORA_MAX_RETRIES) {
-      Serial.println("达到最大重试次数，重置重试计数");
+      LOG_PRINTLN(LOG_INF, "达到最大重试次数，重置重试计数");
       loraRetryCount = 0;
       lastLoRaSend = millis();  // 重置发送时间
     } else {
-      sendWaterQualityData();
+      sendWaterQualityData(getLatestMeasurement());
     }
   }
 }
@@ -261,56 +697,110 @@ void handleLoRaCommunication() {
 // ==================== 新增：只处理LoRa接收 ====================
 void handleLoRaReceiveOnly() {
   // 只检查下行消息，不自动发送数据
-  if (loraModem.available()) {
-    Serial.println("\n收到下行消息:");
-    while (loraModem.available()) {
-      uint8_t rcv = loraModem.read();
-      Serial.print("0x");
-      if (rcv < 16) Serial.print("0");
-      Serial.print(rcv, HEX);
-      Serial.print(" ");
-    }
-    Serial.println();
+  receiveDownlink();
+  
+  // 下行命令请求补发缓存数据
+  if (backlogFlushRequested) {
+    backlogFlushRequested = false;
+    // 补发放在日志宏外面，日志被编译掉时仍然执行
+    int flushed = flushLoRaBacklog(LORA_BACKLOG_SIZE);
+    LOG_PRINT(LOG_INF, "补发缓存数据: ");
+    LOG_PRINTLN(LOG_INF, flushed);
+    return;
   }
   
   // 只处理重试逻辑，不处理定时发送
-  if (loraRetryCount > 0 && loraRetryCount < LORA_MAX_RETRIES) {
+  if (loraRetryCount > 0 && loraRetryCount < LORA_MAX_RETRIES && loraBacklogCount > 0) {
     unsigned long currentTime = millis();
     if (currentTime - lastLoRaSend >= 60000) {  // 1分钟重试间隔
-      Serial.println("重试发送失败的数据...");
-      sendWaterQualityData();
+      LOG_PRINTLN(LOG_INF, "重试发送失败的数据...");
+      if (flushLoRaBacklog(1) == 0) {
+        lastLoRaSend = currentTime;  // 等下一个重试间隔
+      }
     }
   }
 }
 
+// ==================== 运行时配置 ====================
+void setLoRaSendInterval(unsigned long intervalMs) {
+  loraSendInterval = intervalMs;
+  LOG_PRINT(LOG_INF, "自动发送间隔已设置为 ");
+  LOG_PRINT(LOG_INF, intervalMs / 1000);
+  LOG_PRINTLN(LOG_INF, " 秒");
+}
+
+bool setRedundancyDepth(uint8_t depth) {
+  if (depth > LORA_REDUNDANCY_MAX_DEPTH) {
+    return false;
+  }
+  redundancyDepth = depth;
+  LOG_PRINT(LOG_INF, "冗余深度已设置为 ");
+  LOG_PRINTLN(LOG_INF, depth);
+  return true;
+}
+
+bool setPayloadFormat(uint8_t format) {
+  if (format >= PAYLOAD_FORMAT_COUNT) {
+    return false;
+  }
+  payloadFormat = format;
+  LOG_PRINT(LOG_INF, "上行数据格式已设置为 ");
+  LOG_PRINTLN(LOG_INF, format);
+  return true;
+}
+
 // ==================== 新增：控制自动发送开关 ====================
 void enableAutoSend(bool enable) {
   autoSendEnabled = enable;
-  Serial.print("LoRa自动发送已");
-  Serial.println(enable ? "开启" : "关闭");
+  LOG_PRINT(LOG_INF, "LoRa自动发送已");
+  LOG_PRINTLN(LOG_INF, enable ? "开启" : "关闭");
   
   if (enable) {
-    Serial.print("发送间隔: ");
-    Serial.print(LORA_SEND_INTERVAL / 1000);
-    Serial.println(" 秒");
+    LOG_PRINT(LOG_INF, "发送间隔: ");
+    LOG_PRINT(LOG_INF, loraSendInterval / 1000);
+    LOG_PRINTLN(LOG_INF, " 秒");
   }
 }
 
 // ==================== 重连LoRa网络 ====================
+// 每次尝试都记录时间；失败后后台重连间隔翻倍，成功后恢复到最小间隔
+static unsigned long lastReconnectAttemptMs = 0;
+static unsigned long reconnectBackoffMs = LORA_REJOIN_MIN_BACKOFF_MS;
+
 bool reconnectLoRa() {
-  Serial.println("尝试重连LoRa网络...");
+  LOG_PRINTLN(LOG_INF, "尝试重连LoRa网络...");
   
   loraConnected = false;
+  lastReconnectAttemptMs = millis();
   
-  // 重新初始化（如果需要）
-  if (!loraInitialized) {
-    if (!initializeLoRa()) {
-      return false;
+  // 重新初始化（如果需要），然后重新连接
+  if ((!loraInitialized && !initializeLoRa()) || !connectToNetwork()) {
+    reconnectBackoffMs *= 2;
+    if (reconnectBackoffMs > LORA_REJOIN_MAX_BACKOFF_MS) {
+      reconnectBackoffMs = LORA_REJOIN_MAX_BACKOFF_MS;
     }
+    LOG_PRINT(LOG_WRN, "⚠ 重连失败，");
+    LOG_PRINT(LOG_WRN, reconnectBackoffMs / 1000);
+    LOG_PRINTLN(LOG_WRN, " 秒后再试");
+    return false;
+  }
+  
+  loraRejoinPending = false;
+  reconnectBackoffMs = LORA_REJOIN_MIN_BACKOFF_MS;
+  return true;
+}
+
+// 入网失败或重新入网失败后，上行路径都因 loraConnected 为 false 而跳过发送，
+// 由LoRa任务在这里后台重连，避免设备一直离线、缓存无法清空
+bool maintainLoRaConnection() {
+  if (loraConnected || !loraInitialized) {
+    return false;
+  }
+  if (millis() - lastReconnectAttemptMs < reconnectBackoffMs) {
+    return false;
   }
   
-  // 重新连接
-  return connectToNetwork();
+  return reconnectLoRa();
 }
 
 // ==================== 状态检查 ====================
@@ -324,16 +814,22 @@ void printLoRaStatus() {
   Serial.println(autoSendEnabled ? "开启" : "关闭");
   Serial.print("重试次数: ");
   Serial.println(loraRetryCount);
+  Serial.print("待补发数据: ");
+  Serial.println(loraBacklogCount);
+  printLoRaSessionStatus();
+  printLinkHealth();
+  printDataRateStatus();
+  printDownlinkStats();
   
   if (lastLoRaSend > 0) {
     Serial.print("上次发送: ");
     Serial.print((millis() - lastLoRaSend) / 1000);
     Serial.println(" 秒前");
     
-    if (autoSendEnabled && LORA_SEND_INTERVAL > 0) {
+    if (autoSendEnabled && loraSendInterval > 0) {
       Serial.print("下次发送: ");
-      unsigned long nextSend = LORA_SEND_INTERVAL - (millis() - lastLoRaSend);
-      if (nextSend > LORA_SEND_INTERVAL) {
+      unsigned long nextSend = loraSendInterval - (millis() - lastLoRaSend);
+      if (nextSend > loraSendInterval) {
         Serial.println("立即");
       } else {
         Serial.print(nextSend / 1000);
@@ -11,6 +11,7 @@
 
 #include <Arduino.h>
 #include <MKRWAN.h>
+#include "Measurement.h"
 
 // ==================== LoRaWAN配置 ====================
 // 请替换为你的TTN应用凭证
@@ -21,15 +22,112 @@
 #define LORA_SEND_INTERVAL 0  // 禁用自动发送（原来是300000）
 #define LORA_MAX_RETRIES 3
 #define LORA_TIMEOUT 30000
+#define LORA_BACKLOG_SIZE 8           // 发送失败数据的缓存条数
+#define LORA_REJOIN_MIN_BACKOFF_MS 60000UL    // 离线后台重连的首次间隔，每次失败翻倍
+#define LORA_REJOIN_MAX_BACKOFF_MS 3600000UL  // 重连间隔上限（1小时）
+#define LORA_DUMP_PAYLOAD       false   // 发送前在串口打印各字段和原始字节（阻塞较久，仅调试用）
+#define LORA_MAX_DOWNLINK_SIZE 64     // 下行消息缓冲区大小
+
+// 冗余上行配置：每帧附带前N条读数的差分副本，丢帧时后端可补齐数据
+#define LORA_REDUNDANCY_MAX_DEPTH 2   // 最多附带的历史读数条数
+#define LORA_REDUNDANCY_DEPTH 1       // 默认冗余深度
+#define LORA_MAX_PAYLOAD_SIZE 51      // EU868 DR0最大有效载荷
+
+// 上行端口：后端根据端口区分数据格式
+#define LORA_PORT_LEGACY 2            // 旧格式（MKRWAN默认端口）
+#define LORA_PORT_REDUNDANT 3         // 多记录冗余格式
+
+// 上行确认策略：默认不确认，周期性发送确认帧作为链路检测
+#define LORA_CONFIRM_EVERY_N_FRAMES 8         // 每N帧发送一次确认帧（0 = 不按帧数）
+#define LORA_CONFIRM_MAX_INTERVAL   1800000UL // 距上次确认帧超过T毫秒则下一帧确认（30分钟，0 = 不按时间）
+#define LORA_CONFIRM_UNSAFE         true      // UNSAFE结果总是使用确认帧
+
+// 数据速率配置（EU868: DR0 = SF12 ... DR5 = SF7）
+#define LORA_ADR_ENABLED        true   // 由网络服务器通过ADR调整速率
+#define LORA_LOCAL_DR_POLICY    false  // 本地根据链路检测结果调整速率（开启时关闭ADR）
+#define LORA_DEFAULT_DATA_RATE  3      // SF9BW125
+#define LORA_MIN_DATA_RATE      0      // SF12BW125
+#define LORA_MAX_DATA_RATE      5      // SF7BW125
+#define LORA_DR_STEP_UP_CHECKS  3      // 连续N次链路检测成功后提高一档速率
+#define LORA_DR_HISTORY_SIZE    8      // 保留最近N次速率变化
 
 // ==================== 数据包结构 ====================
-// 完整的水质数据包（10字节，包含所有主要参数）
+// 完整的水质数据包（编码后10字节，包含所有主要参数）
 struct WaterQualityPacket {
   uint16_t temperature;    // 温度 * 100 (例: 25.67°C = 2567)
   uint16_t ph;            // pH * 100 (例: 7.45 = 745) 
   uint16_t turbidity;     // 浊度 * 10 (例: 15.3 NTU = 153)
   uint16_t conductivity;  // 电导率 (μS/cm)
   uint16_t tds;          // TDS (ppm)
+  uint8_t profile;       // 分级所用的监管配置 id（WaterQualityProfileId）
+  uint8_t flags;         // PACKET_FLAG_*，与配置 id 合并在同一字节发送
+};
+
+// 配置 id 字节的最高位：探头在超时前未稳定，读数可能取自漂移过程中
+#define PACKET_FLAG_UNSETTLED 0x80
+
+// 上行数据格式
+enum PayloadFormat {
+  PAYLOAD_FORMAT_LEGACY = 0,   // 10字节大端格式（温度/pH/浊度/电导率/TDS）+ 1字节配置 id
+  PAYLOAD_FORMAT_REDUNDANT,    // 当前读数 + 前N条读数的差分副本
+  PAYLOAD_FORMAT_COUNT
+};
+
+// 旧格式（端口2）: [读数 10字节][配置 id 1字节]，只读前10字节的旧解码器不受影响
+// 配置 id 字节: 低7位为配置 id，最高位为 PACKET_FLAG_UNSETTLED
+//
+// 冗余格式（端口3）:
+//   [头部 1字节: 版本(高4位) | 冗余深度(低4位)]
+//   [配置 id 1字节]（版本2起）
+//   [当前读数 10字节]
+//   每条历史读数: [帧计数差 1字节][宽度掩码 1字节][5个字段]
+//     帧计数差 = 当前帧计数 - 历史帧计数（0 = 未知）
+//     掩码第i位为1: 字段i为完整uint16绝对值（2字节）
+//     掩码第i位为0: 字段i为相对当前读数的int8差值（1字节）
+#define REDUNDANT_PAYLOAD_VERSION 2
+
+// ==================== 上行确认策略 ====================
+struct UplinkPolicy {
+  uint8_t confirmEveryNFrames;       // 每N帧确认一次
+  unsigned long confirmIntervalMs;   // 最长确认间隔
+  bool confirmUnsafe;                // UNSAFE结果升级为确认帧
+};
+
+// ==================== 链路健康统计 ====================
+struct LinkHealthStats {
+  uint32_t unconfirmedSent;          // 已发送的非确认帧
+  uint32_t confirmedSent;            // 已发送的确认帧（链路检测）
+  uint32_t confirmedAcked;           // 收到ACK的确认帧
+  uint32_t sendErrors;               // 模块返回错误的发送次数
+  uint8_t framesSinceConfirm;        // 距上次确认帧的帧数
+  unsigned long lastConfirmTime;     // 上次发送确认帧的时间
+  unsigned long lastAckTime;         // 上次收到ACK的时间
+  bool lastCheckOk;                  // 最近一次链路检测结果
+};
+
+// ==================== 数据速率记录 ====================
+enum DataRateChangeReason {
+  DR_REASON_JOIN = 0,      // 入网时设置
+  DR_REASON_ADR,           // 网络ADR调整
+  DR_REASON_STEP_UP,       // 本地策略：链路余量充足
+  DR_REASON_STEP_DOWN,     // 本地策略：链路检测失败
+  DR_REASON_MANUAL         // 串口或下行命令
+};
+
+struct DataRateChange {
+  unsigned long time;      // millis()
+  uint8_t dataRate;
+  uint8_t reason;          // DataRateChangeReason
+};
+
+struct DataRateState {
+  bool adrEnabled;
+  bool localPolicyEnabled;
+  uint8_t currentDataRate;
+  uint8_t consecutiveChecksOk;                    // 本地策略：连续成功次数
+  DataRateChange history[LORA_DR_HISTORY_SIZE];   // 环形缓冲
+  uint8_t historyCount;
+  uint8_t historyHead;
 };
 
 // ==================== 全局变量声明 ====================
@@ -39,22 +137,48 @@ extern bool loraConnected;
 extern unsigned long lastLoRaSend;
 extern int loraRetryCount;
 extern bool autoSendEnabled;  // 新增：自动发送开关
+extern unsigned long loraSendInterval;  // 自动发送间隔（毫秒），可通过下行命令修改
+extern uint8_t payloadFormat;           // 当前上行数据格式
+extern bool backlogFlushRequested;      // 下行命令请求补发缓存数据
+extern uint8_t redundancyDepth;         // 冗余格式附带的历史读数条数
+extern UplinkPolicy uplinkPolicy;
+extern LinkHealthStats linkHealth;
+extern DataRateState dataRateState;
 
 // ==================== 函数声明 ====================
 // 主要函数
 bool initializeLoRa();
 bool connectToNetwork();
-bool sendWaterQualityData();
+bool sendWaterQualityData(const Measurement& m);
 bool shouldSendLoRaData();
 void handleLoRaCommunication();
 void handleLoRaReceiveOnly();  // 新增：只处理接收的函数
 void printLoRaStatus();
 
 // 辅助函数
-WaterQualityPacket packWaterQualityData();
-bool sendDataPacket(const WaterQualityPacket& packet);
+WaterQualityPacket packWaterQualityData(const Measurement& m);
+bool sendDataPacket(const WaterQualityPacket& packet, bool confirmed);
+bool shouldConfirmUplink(bool unsafeResult);
+void recordLinkCheckResult(bool confirmed, bool ok);
+void printLinkHealth();
+void configureDataRate();
+bool setLoRaDataRate(uint8_t dataRate, uint8_t reason);
+void observeDataRate();
+void applyLocalDataRatePolicy(bool checkOk);
+void enableLocalDataRatePolicy(bool enable);
+void printDataRateStatus();
 bool reconnectLoRa();
+bool maintainLoRaConnection();     // 离线时按退避间隔重连，返回本次是否连上
 void printLoRaDiagnostics();
 void enableAutoSend(bool enable);  // 新增：控制自动发送开关
+void setLoRaSendInterval(unsigned long intervalMs);
+bool setPayloadFormat(uint8_t format);
+bool setRedundancyDepth(uint8_t depth);
+int encodeWaterQualityPayload(const WaterQualityPacket& packet, int fcnt, uint8_t* buffer, int bufferSize);
+
+// 发送失败数据缓存
+bool queueLoRaBacklog(const WaterQualityPacket& packet);
+int flushLoRaBacklog(int maxPackets);
+int getLoRaBacklogCount();
 
 #endif // LORA_COMM_H
\ No newline at end of file
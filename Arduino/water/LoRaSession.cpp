@@ -0,0 +1,205 @@
+/**
+ * LoRaSession.cpp - LoRaWAN会话持久化模块实现
+ *
+ * 入网后保存会话，上电恢复会话；连续确认帧失败时强制重新入网
+ */
+
+#define LOG_MODULE LOG_MOD_LORA
+
+#include "LoRaSession.h"
+#include "LoRaComm.h"
+#include "Log.h"
+#include <FlashStorage.h>
+
+// ==================== Flash存储 ====================
+FlashStorage(loraSessionStore, LoRaSessionRecord);
+
+// ==================== 全局变量定义 ====================
+bool loraSessionRestored = false;
+int loraConfirmedFailureCount = 0;
+bool loraRejoinPending = false;
+
+static LoRaSessionRecord currentSession;  // RAM中的会话副本
+static bool currentSessionLoaded = false;
+
+// ==================== 内部辅助函数 ====================
+static bool isRecordValid(const LoRaSessionRecord& record) {
+  return record.magic == LORA_SESSION_MAGIC &&
+         record.version == LORA_SESSION_VERSION &&
+         record.valid == 1 &&
+         strlen(record.devAddr) == 8 &&
+         strlen(record.nwkSKey) == 32 &&
+         strlen(record.appSKey) == 32;
+}
+
+static void copyField(char* dest, size_t size, const String& value) {
+  strncpy(dest, value.c_str(), size - 1);
+  dest[size - 1] = '\0';
+}
+
+static void writeSession() {
+  loraSessionStore.write(currentSession);
+  currentSessionLoaded = true;
+}
+
+// ==================== 会话恢复 ====================
+bool hasStoredLoRaSession() {
+  LoRaSessionRecord record = loraSessionStore.read();
+  return isRecordValid(record);
+}
+
+bool restoreLoRaSession() {
+  loraSessionRestored = false;
+
+  LoRaSessionRecord record = loraSessionStore.read();
+  if (!isRecordValid(record)) {
+    LOG_PRINTLN(LOG_INF, "没有已保存的LoRa会话，需要OTAA入网");
+    return false;
+  }
+
+  LOG_PRINTLN(LOG_INF, "发现已保存的LoRa会话，尝试恢复...");
+  LOG_PRINT(LOG_INF, "DevAddr: ");
+  LOG_PRINTLN(LOG_INF, record.devAddr);
+
+  if (!loraModem.joinABP(String(record.devAddr), String(record.nwkSKey), String(record.appSKey))) {
+    LOG_PRINTLN(LOG_ERR, "✗ 会话恢复失败，改用OTAA入网");
+    return false;
+  }
+
+  // 上行计数器跳过一个保存间隔，保证不会重复使用掉电前已发出的计数值
+  uint32_t fcntUp = record.fcntUp + LORA_SESSION_FCNT_SAVE_INTERVAL;
+  if (fcntUp > 0xFFFF) {
+    // MKRWAN只支持16位计数器，溢出后必须重新入网
+    LOG_PRINTLN(LOG_WRN, "⚠ 帧计数器即将溢出，改用OTAA入网");
+    invalidateLoRaSession();
+    return false;
+  }
+  loraModem.setFCU((uint16_t)fcntUp);
+  loraModem.setFCD((uint16_t)record.fcntDown);
+
+  // 立即写回前移后的计数器，防止下次掉电前未保存导致计数器回退
+  currentSession = record;
+  currentSession.fcntUp = fcntUp;
+  writeSession();
+
+  loraSessionRestored = true;
+  loraConfirmedFailureCount = 0;
+
+  LOG_PRINT(LOG_INF, "✓ LoRa会话已恢复，上行计数器: ");
+  LOG_PRINTLN(LOG_INF, fcntUp);
+  return true;
+}
+
+// ==================== 会话保存 ====================
+bool saveLoRaSession() {
+  LoRaSessionRecord record;
+  memset(&record, 0, sizeof(record));
+
+  record.magic = LORA_SESSION_MAGIC;
+  record.version = LORA_SESSION_VERSION;
+  copyField(record.devAddr, sizeof(record.devAddr), loraModem.getDevAddr());
+  copyField(record.nwkSKey, sizeof(record.nwkSKey), loraModem.getNwkSKey());
+  copyField(record.appSKey, sizeof(record.appSKey), loraModem.getAppSKey());
+  record.fcntUp = loraModem.getFCU();
+  record.fcntDown = loraModem.getFCD();
+  record.valid = 1;
+
+  if (!isRecordValid(record)) {
+    LOG_PRINTLN(LOG_WRN, "⚠ 无法读取完整的会话信息，跳过保存");
+    return false;
+  }
+
+  currentSession = record;
+  writeSession();
+  loraConfirmedFailureCount = 0;
+
+  LOG_PRINTLN(LOG_INF, "✓ LoRa会话已保存到Flash");
+  return true;
+}
+
+void updateLoRaSessionCounters() {
+  if (!currentSessionLoaded || currentSession.valid != 1) {
+    return;
+  }
+
+  int fcntUp = loraModem.getFCU();
+  if (fcntUp < 0) {
+    return;
+  }
+
+  // 只有计数器前进超过保存间隔才写Flash
+  if ((uint32_t)fcntUp >= currentSession.fcntUp + LORA_SESSION_FCNT_SAVE_INTERVAL) {
+    currentSession.fcntUp = (uint32_t)fcntUp;
+    int fcntDown = loraModem.getFCD();
+    if (fcntDown >= 0) {
+      currentSession.fcntDown = (uint32_t)fcntDown;
+    }
+    writeSession();
+  }
+}
+
+void invalidateLoRaSession() {
+  LoRaSessionRecord record = loraSessionStore.read();
+  if (record.magic == LORA_SESSION_MAGIC && record.valid == 0) {
+    currentSessionLoaded = false;
+    return;  // 已经失效，避免重复擦写
+  }
+
+  memset(&record, 0, sizeof(record));
+  record.magic = LORA_SESSION_MAGIC;
+  record.version = LORA_SESSION_VERSION;
+  record.valid = 0;
+  loraSessionStore.write(record);
+
+  currentSessionLoaded = false;
+  loraSessionRestored = false;
+  LOG_PRINTLN(LOG_INF, "LoRa会话已失效，下次连接将重新OTAA入网");
+}
+
+// ==================== 确认帧失败处理 ====================
+void recordConfirmedUplinkResult(bool acked) {
+  if (acked) {
+    loraConfirmedFailureCount = 0;
+    return;
+  }
+
+  loraConfirmedFailureCount++;
+  LOG_PRINT(LOG_WRN, "确认帧连续失败次数: ");
+  LOG_PRINTLN(LOG_WRN, loraConfirmedFailureCount);
+
+  if (loraConfirmedFailureCount >= LORA_SESSION_MAX_FAILED_CONFIRMED) {
+    LOG_PRINTLN(LOG_WRN, "⚠ 连续确认帧失败，强制重新入网");
+    invalidateLoRaSession();
+    // 保持 loraConnected，上行路径照常进入 sendWaterQualityData()/flushLoRaBacklog()，
+    // 由它们在发送前调用 reconnectLoRa() 重新OTAA入网
+    loraRejoinPending = true;
+    loraConfirmedFailureCount = 0;
+  }
+}
+
+// ==================== 状态输出 ====================
+void printLoRaSessionStatus() {
+  Serial.print("会话来源: ");
+  if (!loraConnected) {
+    Serial.println("未连接");
+  } else if (loraRejoinPending) {
+    Serial.println("待重新入网");
+  } else {
+    Serial.println(loraSessionRestored ? "Flash恢复" : "OTAA入网");
+  }
+
+  Serial.print("已保存会话: ");
+  if (currentSessionLoaded && currentSession.valid == 1) {
+    Serial.print(currentSession.devAddr);
+    Serial.print(" (FCntUp ");
+    Serial.print(currentSession.fcntUp);
+    Serial.println(")");
+  } else {
+    Serial.println(hasStoredLoRaSession() ? "有" : "无");
+  }
+
+  Serial.print("确认帧连续失败: ");
+  Serial.print(loraConfirmedFailureCount);
+  Serial.print("/");
+  Serial.println(LORA_SESSION_MAX_FAILED_CONFIRMED);
+}
@@ -0,0 +1,51 @@
+/**
+ * LoRaSession.h - LoRaWAN会话持久化模块头文件
+ *
+ * OTAA入网成功后把会话(DevAddr、会话密钥、帧计数器)保存到Flash，
+ * 上电时直接恢复会话，跳过完整的OTAA入网流程
+ * 适配MKR WAN1310开发板 (SAMD21 Flash模拟EEPROM)
+ */
+
+#ifndef LORA_SESSION_H
+#define LORA_SESSION_H
+
+#include <Arduino.h>
+
+// ==================== 会话持久化配置 ====================
+#define LORA_SESSION_MAGIC               0x4C53  // "LS"
+#define LORA_SESSION_VERSION             1
+
+// 连续多少次确认帧失败后强制重新OTAA入网
+#define LORA_SESSION_MAX_FAILED_CONFIRMED 3
+
+// 帧计数器每隔多少帧写一次Flash（减少Flash擦写次数）
+// 恢复时上行计数器加上这个间隔，保证不会重复使用已发送过的计数值
+#define LORA_SESSION_FCNT_SAVE_INTERVAL  16
+
+// ==================== 会话记录结构 ====================
+struct LoRaSessionRecord {
+  uint16_t magic;          // 有效标记
+  uint8_t  version;        // 结构版本
+  uint8_t  valid;          // 1 = 会话可用
+  char     devAddr[9];     // 8位十六进制 + '\0'
+  char     nwkSKey[33];    // 32位十六进制 + '\0'
+  char     appSKey[33];    // 32位十六进制 + '\0'
+  uint32_t fcntUp;         // 上行帧计数器
+  uint32_t fcntDown;       // 下行帧计数器
+};
+
+// ==================== 全局变量声明 ====================
+extern bool loraSessionRestored;         // 本次连接是否来自恢复的会话
+extern int  loraConfirmedFailureCount;   // 连续确认帧失败次数
+extern bool loraRejoinPending;           // 会话已判定失效，下一次上行前重新OTAA入网
+
+// ==================== 函数声明 ====================
+bool restoreLoRaSession();               // 从Flash恢复会话并以ABP方式激活
+bool saveLoRaSession();                  // 入网后保存完整会话
+void updateLoRaSessionCounters();        // 上行成功后按间隔保存帧计数器
+void invalidateLoRaSession();            // 使已保存的会话失效
+bool hasStoredLoRaSession();
+void recordConfirmedUplinkResult(bool acked);  // 记录确认帧结果，必要时触发重新入网
+void printLoRaSessionStatus();
+
+#endif // LORA_SESSION_H
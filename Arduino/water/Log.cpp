@@ -0,0 +1,77 @@
+/**
+ * Log.cpp - 分级日志运行期设置
+ */
+
+#include "Log.h"
+#include "Hal.h"
+
+// ==================== 全局变量定义 ====================
+uint8_t logRuntimeLevel[LOG_MODULE_COUNT] = {
+  logCompiledLevel(LOG_MOD_SYSTEM),
+  logCompiledLevel(LOG_MOD_SENSORS),
+  logCompiledLevel(LOG_MOD_LED),
+  logCompiledLevel(LOG_MOD_DISPLAY),
+  logCompiledLevel(LOG_MOD_BUTTON),
+  logCompiledLevel(LOG_MOD_LORA),
+  logCompiledLevel(LOG_MOD_POWER),
+};
+
+static const char* const LOG_MODULE_NAMES[LOG_MODULE_COUNT] = {
+  "system", "sensors", "led", "display", "button", "lora", "power"
+};
+
+static const char* const LOG_LEVEL_NAMES[] = {
+  "off", "error", "warn", "info", "debug"
+};
+
+// ==================== 串口连接检测 ====================
+bool isSerialHostAttached() {
+  return halSerialHostAttached();
+}
+
+// ==================== 运行期级别 ====================
+bool setModuleLogLevel(uint8_t module, uint8_t level) {
+  if (module >= LOG_MODULE_COUNT || level > LOG_DBG) {
+    return false;
+  }
+  // 超过编译期级别的日志已被删除，设置更高的级别没有效果
+  logRuntimeLevel[module] = level;
+  return true;
+}
+
+void setLogLevel(uint8_t level) {
+  for (uint8_t module = 0; module < LOG_MODULE_COUNT; module++) {
+    setModuleLogLevel(module, level);
+  }
+}
+
+int findLogModule(const char* name) {
+  for (uint8_t module = 0; module < LOG_MODULE_COUNT; module++) {
+    if (strcmp(LOG_MODULE_NAMES[module], name) == 0) {
+      return module;
+    }
+  }
+  return -1;
+}
+
+int findLogLevel(const char* name) {
+  for (uint8_t level = LOG_OFF; level <= LOG_DBG; level++) {
+    if (strcmp(LOG_LEVEL_NAMES[level], name) == 0) {
+      return level;
+    }
+  }
+  return -1;
+}
+
+// ==================== 状态输出 ====================
+void printLogLevels() {
+  Serial.println("\n=== 日志级别 (运行期/编译期) ===");
+  for (uint8_t module = 0; module < LOG_MODULE_COUNT; module++) {
+    Serial.print(LOG_MODULE_NAMES[module]);
+    Serial.print(": ");
+    Serial.print(LOG_LEVEL_NAMES[logRuntimeLevel[module]]);
+    Serial.print(" / ");
+    Serial.println(LOG_LEVEL_NAMES[logCompiledLevel(module)]);
+  }
+  Serial.println("===============================");
+}
@@ -0,0 +1,105 @@
+/**
+ * Log.h - 分级日志宏
+ *
+ * 每个源文件在包含头文件之前定义 LOG_MODULE（默认 LOG_MOD_SYSTEM），
+ * 然后用 LOG_PRINT / LOG_PRINTLN 代替 Serial.print / Serial.println：
+ *   LOG_PRINT(LOG_DBG, "pH: "); LOG_PRINTLN(LOG_DBG, pHValue, 2);
+ *
+ * 编译期：高于 LOG_LEVEL（或模块自己的 LOG_LEVEL_xxx）的日志连同字符串一起被编译器删除，
+ *         发布版本可用 -DLOG_LEVEL=0 去掉全部日志
+ * 运行期：每个模块可再单独调低级别；没有电脑打开串口时不输出，避免占用USB CDC
+ * 命令响应（status、help等）仍直接使用 Serial，不受日志级别影响
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// ==================== 日志级别 ====================
+#define LOG_OFF 0
+#define LOG_ERR 1    // 错误（✗）
+#define LOG_WRN 2    // 警告（⚠）
+#define LOG_INF 3    // 关键流程和结果
+#define LOG_DBG 4    // 逐步调试信息
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_INF
+#endif
+
+// 各模块的编译期级别，默认与 LOG_LEVEL 相同
+#ifndef LOG_LEVEL_SYSTEM
+#define LOG_LEVEL_SYSTEM LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_SENSORS
+#define LOG_LEVEL_SENSORS LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LED
+#define LOG_LEVEL_LED LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_DISPLAY
+#define LOG_LEVEL_DISPLAY LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_BUTTON
+#define LOG_LEVEL_BUTTON LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LORA
+#define LOG_LEVEL_LORA LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_POWER
+#define LOG_LEVEL_POWER LOG_LEVEL
+#endif
+
+// ==================== 日志模块 ====================
+enum LogModule {
+  LOG_MOD_SYSTEM = 0,   // 主程序与任务
+  LOG_MOD_SENSORS,      // 传感器读取
+  LOG_MOD_LED,          // 水质评估与LED
+  LOG_MOD_DISPLAY,      // E-Paper
+  LOG_MOD_BUTTON,       // 按钮
+  LOG_MOD_LORA,         // LoRa、会话与下行命令
+  LOG_MOD_POWER,        // 待机与定时采样
+  LOG_MODULE_COUNT
+};
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MOD_SYSTEM
+#endif
+
+constexpr uint8_t logCompiledLevel(uint8_t module) {
+  return module == LOG_MOD_SYSTEM  ? LOG_LEVEL_SYSTEM  :
+         module == LOG_MOD_SENSORS ? LOG_LEVEL_SENSORS :
+         module == LOG_MOD_LED     ? LOG_LEVEL_LED     :
+         module == LOG_MOD_DISPLAY ? LOG_LEVEL_DISPLAY :
+         module == LOG_MOD_BUTTON  ? LOG_LEVEL_BUTTON  :
+         module == LOG_MOD_LORA    ? LOG_LEVEL_LORA    :
+         module == LOG_MOD_POWER   ? LOG_LEVEL_POWER   : LOG_LEVEL;
+}
+
+// ==================== 全局变量声明 ====================
+extern uint8_t logRuntimeLevel[LOG_MODULE_COUNT];
+
+// ==================== 函数声明 ====================
+bool isSerialHostAttached();          // 电脑已打开串口（不像 if (Serial) 那样延时10ms）
+void setLogLevel(uint8_t level);      // 设置全部模块的运行期级别
+bool setModuleLogLevel(uint8_t module, uint8_t level);
+int findLogModule(const char* name);  // 按名称查找，找不到返回-1
+int findLogLevel(const char* name);
+void printLogLevels();
+
+inline bool logEnabled(uint8_t module, uint8_t level) {
+  return level <= logRuntimeLevel[module] && isSerialHostAttached();
+}
+
+// ==================== 日志宏 ====================
+// 第一个条件是编译期常量，为假时整条语句（包括字符串常量）被删除
+#define LOG_ON(level) \
+  ((level) <= logCompiledLevel(LOG_MODULE) && logEnabled(LOG_MODULE, (level)))
+
+#define LOG_PRINT(level, ...) \
+  do { if (LOG_ON(level)) Serial.print(__VA_ARGS__); } while (0)
+
+#define LOG_PRINTLN(level, ...) \
+  do { if (LOG_ON(level)) Serial.println(__VA_ARGS__); } while (0)
+
+#endif // LOG_H
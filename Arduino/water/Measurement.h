@@ -0,0 +1,52 @@
+/**
+ * Measurement.h - 一次水质检测的结果
+ *
+ * 采集任务每次检测只生成一份 Measurement，分级也只在生成时做一次；
+ * 显示、LED、日志和上行都通过常量引用读取同一份快照，
+ * 因此各阶段看到的读数和等级始终一致，下一次采集也不会改写正在使用的结果
+ */
+
+#ifndef MEASUREMENT_H
+#define MEASUREMENT_H
+
+#include <Arduino.h>
+#include "WaterQualityLED.h"
+
+// ==================== 有效性标志 ====================
+// 读数无效时仍保留数值（默认值或超量程时的计算值），由使用方决定如何处理
+enum MeasurementField {
+  MEAS_TEMPERATURE  = 1 << 0,   // DS18B20 读数被接受（未连接或读数异常时为默认/上次温度）
+  MEAS_PH           = 1 << 1,   // pH 探头电压不在ADC两端
+  MEAS_TURBIDITY    = 1 << 2,   // 浊度传感器有输出（0V 表示断线）
+  MEAS_CONDUCTIVITY = 1 << 3,   // 电导率未超出ADC量程
+  MEAS_TDS          = 1 << 4,   // 由电导率换算，随电导率有效
+  MEAS_ALL_FIELDS   = 0x1F,
+  MEAS_SETTLE_FIELDS = MEAS_PH | MEAS_TURBIDITY | MEAS_CONDUCTIVITY | MEAS_TDS  // 做稳定检测的字段
+};
+
+// ==================== 检测结果 ====================
+struct Measurement {
+  uint32_t sequence;                  // 采集序号，从1开始；0 表示尚未采集
+  unsigned long timeMs;               // 采集完成时的 millis()
+  float temperature;                  // ℃
+  float pH;
+  float turbidity;                    // NTU
+  float conductivity;                 // μS/cm
+  float tds;                          // ppm
+  uint8_t validMask;                  // MeasurementField 的组合
+  uint8_t settledMask;                // 超时前已稳定的探头（MEAS_SETTLE_FIELDS 的子集）
+  uint16_t settleMs;                  // 从开始采集到结束的时间
+  uint8_t profile;                    // 分级所用的监管配置（WaterQualityProfileId）
+  WaterQualityAssessment assessment;  // 各参数等级和总体等级
+};
+
+inline bool isMeasurementFieldValid(const Measurement& m, uint8_t field) {
+  return (m.validMask & field) == field;
+}
+
+// 所有探头都在超时前稳定；否则读数可能取自漂移过程中
+inline bool isMeasurementSettled(const Measurement& m) {
+  return (m.settledMask & MEAS_SETTLE_FIELDS) == MEAS_SETTLE_FIELDS;
+}
+
+#endif // MEASUREMENT_H
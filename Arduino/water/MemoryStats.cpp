@@ -0,0 +1,219 @@
+/**
+ * MemoryStats.cpp - RAM 使用统计实现
+ *
+ * AVR 的 __heap_start/__brkval 在 ARM 上不存在，这里改用 newlib 的 sbrk/mallinfo
+ * 和链接脚本符号。栈向下增长，堆向上增长，两者之间的空闲区域被填充为固定图案，
+ * 从下往上找到第一个被改写的字即为栈到达过的最深位置
+ * 中断使用同一个栈，其深度计入被中断的任务
+ */
+
+#include "MemoryStats.h"
+#include "Scheduler.h"
+
+#if MEM_STATS_ENABLED
+
+#include <malloc.h>
+
+// ==================== 链接脚本符号 ====================
+extern "C" {
+  extern uint32_t __data_start__;
+  extern uint32_t __bss_end__;
+  extern uint32_t __end__;        // 堆起点
+  extern uint32_t __StackTop;     // RAM末尾，栈起点
+  char* sbrk(int incr);
+}
+
+// ==================== 内部状态 ====================
+static MemoryStats memStats = {0, 0, 0, 0, 0, 0, 0, 0, 0xFFFFFFFFUL, false};
+static uint32_t* paintBottom = NULL;   // 填充窗口下边界
+
+static uintptr_t heapBreak() {
+  return (uintptr_t)sbrk(0);
+}
+
+static uintptr_t stackTop() {
+  return (uintptr_t)&__StackTop;
+}
+
+// 在调用者栈帧下方（保留 MEM_STACK_MARGIN）填充图案
+static void __attribute__((noinline)) paintStack(uint32_t* from) {
+  uint32_t* to = (uint32_t*)(((uintptr_t)__builtin_frame_address(0) - MEM_STACK_MARGIN) & ~(uintptr_t)3);
+  for (uint32_t* p = from; p < to; p++) {
+    *p = MEM_STACK_PAINT;
+  }
+}
+
+// 从窗口底部向上找到第一个被改写的字；堆已长入窗口时从堆断点开始
+static uint32_t* __attribute__((noinline)) findLowestTouched() {
+  uint32_t* p = paintBottom;
+  uint32_t* brk = (uint32_t*)((heapBreak() + 3) & ~(uintptr_t)3);
+  if (brk > p) {
+    p = brk;
+  }
+  uint32_t* limit = (uint32_t*)(((uintptr_t)__builtin_frame_address(0) - MEM_STACK_MARGIN) & ~(uintptr_t)3);
+  while (p < limit && *p == MEM_STACK_PAINT) {
+    p++;
+  }
+  return p;
+}
+
+// ==================== 初始化 ====================
+void initializeMemoryStats() {
+  uintptr_t top = ((uintptr_t)__builtin_frame_address(0) - MEM_STACK_MARGIN) & ~(uintptr_t)3;
+  uintptr_t bottom = top - MEM_STACK_WINDOW;
+  uintptr_t brk = (heapBreak() + 3) & ~(uintptr_t)3;
+  if (bottom < brk) {
+    bottom = brk;
+  }
+
+  paintBottom = (uint32_t*)bottom;
+  paintStack(paintBottom);
+
+  memStats.staticBytes = (uintptr_t)&__bss_end__ - (uintptr_t)&__data_start__;
+}
+
+void recordSetupStackUsage() {
+  memStats.setupStackBytes = memoryStackCheckpoint();
+}
+
+// ==================== 检查点 ====================
+uint32_t memoryStackCheckpoint() {
+  if (paintBottom == NULL) {
+    return 0;
+  }
+
+  uint32_t* touched = findLowestTouched();
+  uint32_t depth = stackTop() - (uintptr_t)touched;
+  if (depth > memStats.stackPeakBytes) {
+    memStats.stackPeakBytes = depth;
+  }
+  if (touched <= paintBottom) {
+    memStats.stackWindowExceeded = true;
+  }
+
+  uintptr_t brk = heapBreak();
+  if (brk - (uintptr_t)&__end__ > memStats.heapPeakBytes) {
+    memStats.heapPeakBytes = brk - (uintptr_t)&__end__;
+  }
+  uint32_t headroom = (uintptr_t)touched > brk ? (uintptr_t)touched - brk : 0;
+  if (headroom < memStats.minHeadroomBytes) {
+    memStats.minHeadroomBytes = headroom;
+  }
+
+  // 只需重新填充本次被改写的区域
+  paintStack(touched);
+  return depth;
+}
+
+// ==================== 查询 ====================
+uint32_t getFreeRamBytes() {
+  uintptr_t sp = (uintptr_t)__builtin_frame_address(0);
+  uintptr_t brk = heapBreak();
+  return sp > brk ? sp - brk : 0;
+}
+
+const MemoryStats& getMemoryStats() {
+  struct mallinfo info = mallinfo();
+  uintptr_t brk = heapBreak();
+
+  memStats.heapBytes = brk - (uintptr_t)&__end__;
+  if (memStats.heapBytes > memStats.heapPeakBytes) {
+    memStats.heapPeakBytes = memStats.heapBytes;
+  }
+  memStats.heapUsedBytes = info.uordblks;
+  memStats.heapFreeBytes = info.fordblks;
+  memStats.freeBytes = getFreeRamBytes();
+  return memStats;
+}
+
+// ==================== 状态输出 ====================
+void printMemoryStats() {
+  const MemoryStats& s = getMemoryStats();
+
+  Serial.println("\n=== 内存统计 ===");
+  Serial.print("RAM总量: ");
+  Serial.print(stackTop() - (uintptr_t)&__data_start__);
+  Serial.println(" 字节");
+  Serial.print("静态RAM (.data + .bss): ");
+  Serial.print(s.staticBytes);
+  Serial.println(" 字节");
+
+  Serial.print("堆: 当前 ");
+  Serial.print(s.heapBytes);
+  Serial.print(", 峰值 ");
+  Serial.print(s.heapPeakBytes);
+  Serial.print(" 字节 (已分配 ");
+  Serial.print(s.heapUsedBytes);
+  Serial.print(", 空闲块 ");
+  Serial.print(s.heapFreeBytes);
+  Serial.println(")");
+
+  Serial.print("栈: 峰值 ");
+  Serial.print(s.stackPeakBytes);
+  Serial.print(" 字节 (setup ");
+  Serial.print(s.setupStackBytes);
+  Serial.print("), 填充窗口 ");
+  Serial.print(MEM_STACK_WINDOW);
+  Serial.println(" 字节");
+  if (s.stackWindowExceeded) {
+    Serial.println("⚠ 栈深度超出填充窗口，实际峰值可能更大");
+  }
+
+  Serial.print("空闲RAM: ");
+  Serial.print(s.freeBytes);
+  Serial.print(" 字节, 堆与栈最小余量: ");
+  if (s.minHeadroomBytes == 0xFFFFFFFFUL) {
+    Serial.println("无数据");
+  } else {
+    Serial.print(s.minHeadroomBytes);
+    Serial.println(" 字节");
+  }
+
+  Serial.println("各任务栈高水位:");
+  for (uint8_t id = 0; id < TASK_COUNT; id++) {
+    const Task* task = getTask(id);
+    if (task == NULL) {
+      continue;
+    }
+    Serial.print("  ");
+    Serial.print(task->name);
+    Serial.print(": ");
+    Serial.print(task->maxStackBytes);
+    Serial.println(" 字节");
+  }
+  Serial.println("================");
+}
+
+void printMemorySummary() {
+  const MemoryStats& s = getMemoryStats();
+  Serial.print("内存: 静态 ");
+  Serial.print(s.staticBytes);
+  Serial.print(", 堆峰值 ");
+  Serial.print(s.heapPeakBytes);
+  Serial.print(", 栈峰值 ");
+  Serial.print(s.stackPeakBytes);
+  Serial.print(s.stackWindowExceeded ? "+" : "");
+  Serial.print(", 空闲 ");
+  Serial.print(s.freeBytes);
+  Serial.println(" 字节");
+}
+
+#else // !MEM_STATS_ENABLED
+
+static MemoryStats memStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, false};
+
+void initializeMemoryStats() {}
+void recordSetupStackUsage() {}
+uint32_t memoryStackCheckpoint() { return 0; }
+uint32_t getFreeRamBytes() { return 0; }
+const MemoryStats& getMemoryStats() { return memStats; }
+
+void printMemoryStats() {
+  Serial.println("内存统计未启用 (MEM_STATS_ENABLED=0)");
+}
+
+void printMemorySummary() {
+  printMemoryStats();
+}
+
+#endif // MEM_STATS_ENABLED
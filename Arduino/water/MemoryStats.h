@@ -0,0 +1,54 @@
+/**
+ * MemoryStats.h - RAM 使用统计头文件
+ *
+ * SAMD21 (ARM newlib) 上的内存统计：
+ * - 静态RAM：链接脚本符号 __data_start__ ~ __bss_end__
+ * - 堆：sbrk(0) 当前断点与峰值，mallinfo() 已分配/空闲块
+ * - 栈：启动时在栈下方填充固定图案，每个任务运行后扫描被改写的深度，
+ *   记录各任务的栈高水位后重新填充
+ * 串口命令 mem 输出完整统计，perf 输出中附带一行摘要
+ */
+
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <Arduino.h>
+
+// 依赖链接脚本符号，仅在SAMD上启用；设为 0 可在编译时去掉栈扫描
+#ifndef MEM_STATS_ENABLED
+#if defined(ARDUINO_ARCH_SAMD)
+#define MEM_STATS_ENABLED 1
+#else
+#define MEM_STATS_ENABLED 0
+#endif
+#endif
+
+// ==================== 栈填充配置 ====================
+#define MEM_STACK_PAINT          0xCDCDCDCDUL  // 填充图案
+#define MEM_STACK_WINDOW         4096          // 填充并扫描的栈深度（字节）
+#define MEM_STACK_MARGIN         64            // 填充时在当前栈指针下方保留的字节
+
+// ==================== 统计结构 ====================
+struct MemoryStats {
+  uint32_t staticBytes;        // .data + .bss
+  uint32_t heapBytes;          // 当前堆大小（sbrk断点 - 堆起点）
+  uint32_t heapPeakBytes;      // 堆断点的最高位置
+  uint32_t heapUsedBytes;      // mallinfo: 已分配
+  uint32_t heapFreeBytes;      // mallinfo: 堆内空闲块
+  uint32_t stackPeakBytes;     // 栈高水位（含启动阶段）
+  uint32_t setupStackBytes;    // setup() 期间的栈深度
+  uint32_t freeBytes;          // 堆断点到当前栈指针之间的空闲RAM
+  uint32_t minHeadroomBytes;   // 堆峰值到栈最深处之间的最小余量
+  bool stackWindowExceeded;    // 栈深度超出填充窗口，实际值可能更大
+};
+
+// ==================== 函数声明 ====================
+void initializeMemoryStats();          // 在 setup() 最开始调用，填充栈
+void recordSetupStackUsage();          // 在 setup() 结束时调用
+uint32_t memoryStackCheckpoint();      // 返回上次检查点以来的栈深度并重新填充
+uint32_t getFreeRamBytes();
+const MemoryStats& getMemoryStats();   // 刷新堆统计后返回
+void printMemoryStats();
+void printMemorySummary();             // 单行摘要（perf / 诊断输出）
+
+#endif // MEMORY_STATS_H
@@ -0,0 +1,54 @@
+/**
+ * Oversample.cpp - ADC过采样与定点换算实现
+ */
+
+#include "Oversample.h"
+#include "Hal.h"
+
+// ==================== 过采样 ====================
+uint32_t readAdcOversampled(uint8_t pin, uint8_t samples, uint8_t spacingMs) {
+  if (samples == 0) {
+    samples = 1;
+  }
+
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < samples; i++) {
+    if (i > 0 && spacingMs > 0) {
+      halDelay(spacingMs);
+    }
+    sum += (uint32_t)halAnalogRead(pin);
+  }
+  // 四舍五入到 1/256 个ADC单位
+  return ((sum << ADC_FIXED_SHIFT) + samples / 2) / samples;
+}
+
+// ==================== 定点换算 ====================
+uint32_t adcFixedToMillivolts(uint32_t averageFixed) {
+  // averageFixed < 1024 * 256，乘以3300不超过32位
+  const uint32_t divisor = ADC_FULL_SCALE << ADC_FIXED_SHIFT;
+  return (averageFixed * ADC_VREF_MV + divisor / 2) / divisor;
+}
+
+float adcFixedToVolts(uint32_t averageFixed) {
+  return averageFixed * (ADC_VREF_MV / 1000.0f) / (float)(ADC_FULL_SCALE << ADC_FIXED_SHIFT);
+}
+
+// ==================== 校准表插值 ====================
+int32_t interpolateCalibration(const CalibrationPoint* table, uint8_t count, int32_t x) {
+  if (count == 0) {
+    return 0;
+  }
+  if (x <= table[0].x) {
+    return table[0].y;
+  }
+  for (uint8_t i = 1; i < count; i++) {
+    if (x <= table[i].x) {
+      const CalibrationPoint& a = table[i - 1];
+      const CalibrationPoint& b = table[i];
+      int32_t span = b.x - a.x;
+      int32_t offset = (b.y - a.y) * (x - a.x) / span;
+      return a.y + offset;
+    }
+  }
+  return table[count - 1].y;
+}
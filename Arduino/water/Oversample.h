@@ -0,0 +1,36 @@
+/**
+ * Oversample.h - ADC过采样与定点换算
+ *
+ * 各传感器通道共用：连续读取多次ADC求和，平均值以定点数表示（低8位为小数），
+ * 不经过浮点即可换算成毫伏；分段线性校准表也用整数插值
+ */
+
+#ifndef OVERSAMPLE_H
+#define OVERSAMPLE_H
+
+#include <Arduino.h>
+
+// ==================== 定点参数 ====================
+#define ADC_FIXED_SHIFT     8                     // 平均值的小数位数
+#define ADC_FIXED_ONE       (1UL << ADC_FIXED_SHIFT)
+#define ADC_FULL_SCALE      1024UL                // 10位ADC，与 ADC_RESOLUTION 一致
+#define ADC_VREF_MV         3300UL                // 与 VREF 一致
+#define ADC_MAX_SAMPLES     255                   // 求和不超过32位：1023 * 255 * 256
+
+// 分段线性校准点，表按 x 升序排列
+struct CalibrationPoint {
+  int32_t x;
+  int32_t y;
+};
+
+// ==================== 函数声明 ====================
+// 读取 samples 次（1~ADC_MAX_SAMPLES），每次间隔 spacingMs 毫秒，返回定点平均值
+uint32_t readAdcOversampled(uint8_t pin, uint8_t samples, uint8_t spacingMs);
+
+uint32_t adcFixedToMillivolts(uint32_t averageFixed);
+float adcFixedToVolts(uint32_t averageFixed);
+
+// 超出表范围时取端点值；相邻点的 y 差与 x 差之积须在 int32 范围内（避免M0上的64位除法）
+int32_t interpolateCalibration(const CalibrationPoint* table, uint8_t count, int32_t x);
+
+#endif // OVERSAMPLE_H
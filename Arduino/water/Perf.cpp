@@ -0,0 +1,121 @@
+/**
+ * Perf.cpp - 关键路径耗时统计实现
+ *
+ * 直方图固定占用内存，记录一次只需几次整数运算，可在正常运行时常开
+ */
+
+#include "Perf.h"
+#include "MemoryStats.h"
+
+// ==================== 直方图 ====================
+static PerfHistogram perfStats[PERF_STAGE_COUNT];
+
+static const char* const PERF_STAGE_NAMES[PERF_STAGE_COUNT] = {
+  "readTemperature",
+  "readPH",
+  "readTurbidity",
+  "readConductivity",
+  "paint",
+  "SetFrameMemory",
+  "DisplayFrame",
+  "WaitUntilIdle",
+  "sendDataPacket",
+  "sensors finish",
+  "display total",
+  "press->result",
+};
+
+static uint8_t bucketIndex(uint32_t elapsedUs) {
+  uint8_t index = 0;
+  while (elapsedUs > 1 && index < PERF_BUCKET_COUNT - 1) {
+    elapsedUs >>= 1;
+    index++;
+  }
+  return index;
+}
+
+// ==================== 记录 ====================
+void perfRecord(uint8_t stage, uint32_t elapsedUs) {
+  if (stage >= PERF_STAGE_COUNT) {
+    return;
+  }
+
+  PerfHistogram& h = perfStats[stage];
+  if (h.count == 0 || elapsedUs < h.minUs) {
+    h.minUs = elapsedUs;
+  }
+  if (elapsedUs > h.maxUs) {
+    h.maxUs = elapsedUs;
+  }
+  h.count++;
+  h.totalUs += elapsedUs;
+
+  uint8_t index = bucketIndex(elapsedUs);
+  if (h.buckets[index] < 0xFFFF) {
+    h.buckets[index]++;
+  }
+}
+
+uint32_t perfPercentile(uint8_t stage, uint8_t percent) {
+  if (stage >= PERF_STAGE_COUNT || perfStats[stage].count == 0) {
+    return 0;
+  }
+
+  const PerfHistogram& h = perfStats[stage];
+  uint32_t target = ((uint64_t)h.count * percent + 99) / 100;
+  uint32_t seen = 0;
+
+  for (uint8_t i = 0; i < PERF_BUCKET_COUNT; i++) {
+    seen += h.buckets[i];
+    if (seen >= target) {
+      // 桶上限不会超过实际最大值
+      uint32_t upper = (i >= 31) ? 0xFFFFFFFFUL : ((2UL << i) - 1);
+      return upper < h.maxUs ? upper : h.maxUs;
+    }
+  }
+  return h.maxUs;
+}
+
+const PerfHistogram& getPerfHistogram(uint8_t stage) {
+  return perfStats[stage < PERF_STAGE_COUNT ? stage : 0];
+}
+
+void resetPerfStats() {
+  memset(perfStats, 0, sizeof(perfStats));
+}
+
+// ==================== 状态输出 ====================
+static void printMicros(uint32_t us) {
+  if (us >= 10000) {
+    Serial.print(us / 1000);
+    Serial.print("ms");
+  } else {
+    Serial.print(us);
+    Serial.print("us");
+  }
+}
+
+void printPerfStats() {
+  Serial.println("\n=== 耗时统计 (最小/平均/p95/最大) ===");
+  for (uint8_t stage = 0; stage < PERF_STAGE_COUNT; stage++) {
+    const PerfHistogram& h = perfStats[stage];
+    Serial.print(PERF_STAGE_NAMES[stage]);
+    Serial.print(": ");
+    if (h.count == 0) {
+      Serial.println("无数据");
+      continue;
+    }
+    Serial.print(h.count);
+    Serial.print(" 次, ");
+    printMicros(h.minUs);
+    Serial.print(" / ");
+    printMicros((uint32_t)(h.totalUs / h.count));
+    Serial.print(" / ");
+    printMicros(perfPercentile(stage, 95));
+    Serial.print(" / ");
+    printMicros(h.maxUs);
+    Serial.println();
+  }
+  printMemorySummary();
+  Serial.println("=====================================");
+}
@@ -0,0 +1,73 @@
+/**
+ * Perf.h - 关键路径耗时统计头文件
+ *
+ * 用 PERF_SCOPE(stage) 包住需要测量的代码段，作用域结束时
+ * 把 micros() 差值记入该阶段的对数分桶直方图；
+ * 串口命令 perf 输出各阶段的 最小/平均/p95/最大 耗时
+ * 将 PERF_ENABLED 设为 0 可在编译时去掉全部计时代码
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <Arduino.h>
+
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+// ==================== 测量阶段 ====================
+enum PerfStage {
+  PERF_READ_TEMPERATURE = 0,
+  PERF_READ_PH,
+  PERF_READ_TURBIDITY,
+  PERF_READ_CONDUCTIVITY,
+  PERF_PAINT,                // Paint 绘制（清除画布、绘制字符串）
+  PERF_SET_FRAME_MEMORY,
+  PERF_DISPLAY_FRAME,
+  PERF_WAIT_UNTIL_IDLE,
+  PERF_SEND_PACKET,
+  PERF_SENSORS_TOTAL,        // 采集结束时的温度读取、换算和分级（不含等待探头稳定）
+  PERF_DISPLAY_TOTAL,        // 一次完整屏幕更新
+  PERF_PRESS_TO_RESULT,      // 触发检测到屏幕显示结果
+  PERF_STAGE_COUNT
+};
+
+// 第 i 个桶记录 [2^i, 2^(i+1)) 微秒，最后一个桶收集更长的耗时（约8秒以上）
+#define PERF_BUCKET_COUNT 24
+
+struct PerfHistogram {
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint16_t buckets[PERF_BUCKET_COUNT];
+};
+
+// ==================== 函数声明 ====================
+void perfRecord(uint8_t stage, uint32_t elapsedUs);
+uint32_t perfPercentile(uint8_t stage, uint8_t percent);  // 返回所在桶的上限（微秒）
+const PerfHistogram& getPerfHistogram(uint8_t stage);
+void resetPerfStats();
+void printPerfStats();
+
+// ==================== 作用域计时器 ====================
+class PerfScope {
+public:
+  explicit PerfScope(uint8_t stage) : stage_(stage), startUs_(micros()) {}
+  ~PerfScope() { perfRecord(stage_, micros() - startUs_); }
+
+private:
+  uint8_t stage_;
+  uint32_t startUs_;
+};
+
+#if PERF_ENABLED
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(stage) PerfScope PERF_CONCAT(perfScope_, __LINE__)(stage)
+#else
+#define PERF_SCOPE(stage) do {} while (0)
+#endif
+
+#endif // PERF_H
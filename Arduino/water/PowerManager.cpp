@@ -0,0 +1,175 @@
+/**
+ * PowerManager.cpp - 低功耗待机模块实现
+ *
+ * 待机期间SysTick停止，millis()不会前进；
+ * 唤醒延迟以中断触发后的millis()为起点计算
+ */
+
+#define LOG_MODULE LOG_MOD_POWER
+
+#include "PowerManager.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+#include <ArduinoLowPower.h>
+
+// ==================== 全局变量定义 ====================
+bool standbyEnabled = STANDBY_ENABLED;
+WakeLatencyStats wakeLatencyStats = {0, 0, 0xFFFFFFFFUL, 0, 0, 0};
+
+static unsigned long lastActivityTime = 0;
+static bool wakeLatencyOpen = false;     // 唤醒后尚未开始检测
+static bool timedWake = false;           // 本次由RTC定时唤醒，采样完成后立即回到待机
+static unsigned long wakeTimeMs = 0;
+
+// ==================== 初始化 ====================
+void initializePowerManager() {
+  // 按钮中断同时作为STANDBY唤醒源（EIC在待机时保持时钟）
+  LowPower.attachInterruptWakeup(BUTTON_PIN, onButtonEdge, CHANGE);
+  lastActivityTime = millis();
+
+  LOG_PRINT(LOG_INF, "低功耗待机: ");
+  LOG_PRINT(LOG_INF, standbyEnabled ? "开启" : "关闭");
+  LOG_PRINT(LOG_INF, ", 空闲 ");
+  LOG_PRINT(LOG_INF, STANDBY_IDLE_TIMEOUT / 1000);
+  LOG_PRINTLN(LOG_INF, " 秒后进入待机");
+}
+
+void notePowerActivity() {
+  lastActivityTime = millis();
+  timedWake = false;
+}
+
+// ==================== 待机判断 ====================
+bool shouldEnterStandby() {
+  if (!standbyEnabled || !systemReady) {
+    return false;
+  }
+
+  // 有任务即将到期或定时采样进行中时保持唤醒
+  if (getTimeUntilNextTask() == 0 || isSamplingBusy()) {
+    return false;
+  }
+
+  // 手动模式下等待缓存数据补发完；定时采样模式下缓存保留到下次唤醒
+  if (!periodicSamplingEnabled && getLoRaBacklogCount() > 0) {
+    return false;
+  }
+
+  // 电脑串口已打开时保持唤醒，避免断开USB调试
+  if (!STANDBY_WITH_USB_HOST && isSerialHostAttached()) {
+    return false;
+  }
+
+  return timedWake || millis() - lastActivityTime >= STANDBY_IDLE_TIMEOUT;
+}
+
+// ==================== 进入/退出待机 ====================
+void enterSleepMode() {
+  // 定时采样模式下由RTC在下次采样时间唤醒
+  unsigned long sleepMs = 0;
+  if (periodicSamplingEnabled) {
+    sleepMs = getTimeUntilNextSample();
+    if (sleepMs == 0) {
+      return;
+    }
+  }
+
+  LOG_PRINTLN(LOG_INF, "进入低功耗待机...");
+  Serial.flush();
+
+  // 外设休眠：LED熄灭、E-Paper深度睡眠、LoRa模块休眠
+  turnOffAllLEDs();
+  sleepDisplay();
+  if (loraInitialized) {
+    loraModem.sleep(true);
+  }
+
+  TRACE(TRACE_SLEEP_ENTER, 0, sleepMs);
+  
+  // STANDBY：直到按钮中断或RTC闹钟唤醒
+  if (sleepMs > 0) {
+    LowPower.sleep((uint32_t)sleepMs);
+  } else {
+    LowPower.sleep();
+  }
+
+  wakeUpFromSleep();
+}
+
+void wakeUpFromSleep() {
+  if (loraInitialized) {
+    loraModem.sleep(false);
+  }
+  // E-Paper在下次刷新前由wakeDisplay()重新初始化
+
+  bool buttonWake = hasPendingButtonEdges();
+  TRACE(TRACE_WAKE, buttonWake ? 1 : 0, 0);
+
+  if (!buttonWake && periodicSamplingEnabled) {
+    // RTC定时唤醒：不计为用户操作，采样完成后直接回到待机
+    timedWake = true;
+    startPeriodicSample();
+    return;
+  }
+
+  notePowerActivity();
+
+  if (buttonWake) {
+    wakeLatencyStats.wakeCount++;
+    wakeTimeMs = lastButtonEdgeMs;
+    wakeLatencyOpen = true;
+
+    LOG_PRINTLN(LOG_INF, "按钮唤醒，开始检测");
+    // 唤醒按压直接作为一次检测请求，按钮轮询不再重复处理这次按压
+    acknowledgeWakePress();
+    if (!isCooldownPeriod()) {
+      lastButtonPress = millis();
+      performWaterQualityTest();
+    }
+  }
+}
+
+// ==================== 唤醒延迟统计 ====================
+void recordMeasurementStart() {
+  if (!wakeLatencyOpen) {
+    return;
+  }
+  wakeLatencyOpen = false;
+
+  unsigned long latency = millis() - wakeTimeMs;
+  wakeLatencyStats.measuredCount++;
+  wakeLatencyStats.lastLatencyMs = latency;
+  wakeLatencyStats.totalLatencyMs += latency;
+  if (latency < wakeLatencyStats.minLatencyMs) {
+    wakeLatencyStats.minLatencyMs = latency;
+  }
+  if (latency > wakeLatencyStats.maxLatencyMs) {
+    wakeLatencyStats.maxLatencyMs = latency;
+  }
+}
+
+// ==================== 状态输出 ====================
+void printPowerStatus() {
+  Serial.println("\n=== 电源管理 ===");
+  Serial.print("低功耗待机: ");
+  Serial.println(standbyEnabled ? "开启" : "关闭");
+  Serial.print("空闲时间: ");
+  Serial.print((millis() - lastActivityTime) / 1000);
+  Serial.print(" / ");
+  Serial.print(STANDBY_IDLE_TIMEOUT / 1000);
+  Serial.println(" 秒");
+
+  Serial.print("按钮唤醒次数: ");
+  Serial.println(wakeLatencyStats.wakeCount);
+  if (wakeLatencyStats.measuredCount > 0) {
+    Serial.print("唤醒到检测延迟 (ms): 最小 ");
+    Serial.print(wakeLatencyStats.minLatencyMs);
+    Serial.print(", 平均 ");
+    Serial.print(wakeLatencyStats.totalLatencyMs / wakeLatencyStats.measuredCount);
+    Serial.print(", 最大 ");
+    Serial.print(wakeLatencyStats.maxLatencyMs);
+    Serial.print(", 最近 ");
+    Serial.println(wakeLatencyStats.lastLatencyMs);
+  }
+  Serial.println("================");
+}
@@ -0,0 +1,42 @@
+/**
+ * PowerManager.h - 低功耗待机模块头文件
+ *
+ * 空闲时让SAMD21进入STANDBY（RTC + EIC），同时让LoRa模块和E-Paper休眠，
+ * 按钮通过外部中断唤醒并直接开始检测；定时采样模式下同时由RTC定时唤醒
+ * 需要 ArduinoLowPower 库
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// ==================== 待机配置 ====================
+#define STANDBY_ENABLED          true
+#define STANDBY_IDLE_TIMEOUT     60000   // 无操作多久后进入待机（毫秒）
+#define STANDBY_WITH_USB_HOST    false   // 串口已连接电脑时是否也进入待机（待机会断开USB）
+
+// ==================== 唤醒统计 ====================
+struct WakeLatencyStats {
+  uint32_t wakeCount;           // 按钮唤醒次数
+  uint32_t measuredCount;       // 唤醒后开始检测的次数
+  unsigned long minLatencyMs;   // 唤醒到开始检测的最短时间
+  unsigned long maxLatencyMs;
+  unsigned long totalLatencyMs;
+  unsigned long lastLatencyMs;
+};
+
+// ==================== 全局变量声明 ====================
+extern bool standbyEnabled;
+extern WakeLatencyStats wakeLatencyStats;
+
+// ==================== 函数声明 ====================
+void initializePowerManager();
+void notePowerActivity();             // 记录用户/通信活动，推迟进入待机
+bool shouldEnterStandby();
+void enterSleepMode();                // 外设休眠并进入STANDBY，直到被唤醒
+void wakeUpFromSleep();               // 唤醒后恢复外设
+void recordMeasurementStart();        // 检测开始时调用，用于统计唤醒延迟
+void printPowerStatus();
+
+#endif // POWER_MANAGER_H
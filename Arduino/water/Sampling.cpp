@@ -0,0 +1,156 @@
+/**
+ * Sampling.cpp - 定时无人值守采样模块实现
+ *
+ * 采样流程：上电 → 预热 → 触发检测任务 → 检测任务完成后断电
+ * 定时采样不算用户操作，完成后立即允许进入待机
+ */
+
+#define LOG_MODULE LOG_MOD_POWER
+
+#include "Sampling.h"
+#include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+// ==================== 全局变量定义 ====================
+bool periodicSamplingEnabled = PERIODIC_SAMPLING_ENABLED;
+unsigned long samplingIntervalMs = SAMPLING_INTERVAL_DEFAULT;
+
+static SamplingState samplingState = SAMPLING_IDLE;
+static unsigned long lastSampleStart = 0;
+static unsigned long warmupStart = 0;
+static unsigned long periodicSampleCount = 0;
+static int displayedStatus = 0;       // 屏幕上当前显示的水质等级，0 = 尚未显示
+
+// ==================== 传感器供电 ====================
+static void setSensorPower(bool on) {
+#if SENSOR_POWER_PIN >= 0
+  halDigitalWrite(SENSOR_POWER_PIN, on ? HIGH : LOW);
+#else
+  (void)on;   // 传感器常供电
+#endif
+}
+
+// ==================== 初始化 ====================
+void initializeSampling() {
+#if SENSOR_POWER_PIN >= 0
+  halPinMode(SENSOR_POWER_PIN, OUTPUT);
+#endif
+  // 手动模式下传感器保持供电
+  setSensorPower(!periodicSamplingEnabled);
+  lastSampleStart = millis();
+  samplingState = SAMPLING_IDLE;
+}
+
+// ==================== 采样流程 ====================
+void startPeriodicSample() {
+  if (samplingState != SAMPLING_IDLE) {
+    return;
+  }
+
+  TRACE(TRACE_SAMPLE_START, 0, samplingIntervalMs / 1000);
+  LOG_PRINTLN(LOG_INF, "定时采样: 传感器预热...");
+  setSensorPower(true);
+  lastSampleStart = millis();
+  warmupStart = lastSampleStart;
+  samplingState = SAMPLING_WARMUP;
+}
+
+void taskSampling() {
+  if (!periodicSamplingEnabled) {
+    return;
+  }
+
+  unsigned long now = millis();
+
+  switch (samplingState) {
+    case SAMPLING_IDLE:
+      // 设备保持唤醒（例如连接USB）时由调度器按间隔触发
+      if (now - lastSampleStart >= samplingIntervalMs) {
+        startPeriodicSample();
+      }
+      break;
+
+    case SAMPLING_WARMUP:
+      if (now - warmupStart >= SAMPLING_WARMUP_MS) {
+        samplingState = SAMPLING_MEASURING;
+        signalTask(TASK_SENSORS);
+      }
+      break;
+
+    case SAMPLING_MEASURING:
+      // 等待检测任务调用finishPeriodicSample()
+      break;
+  }
+}
+
+bool isPeriodicSampleActive() {
+  return samplingState == SAMPLING_MEASURING;
+}
+
+void finishPeriodicSample() {
+  if (samplingState != SAMPLING_MEASURING) {
+    return;
+  }
+  periodicSampleCount++;
+  samplingState = SAMPLING_IDLE;
+  setSensorPower(false);
+}
+
+bool isSamplingBusy() {
+  return samplingState != SAMPLING_IDLE;
+}
+
+// ==================== 显示刷新判断 ====================
+bool displayNeedsRefresh() {
+  return getWaterQualityGrade() != displayedStatus;
+}
+
+void markDisplayRefreshed() {
+  displayedStatus = getWaterQualityGrade();
+}
+
+// ==================== 运行时配置 ====================
+void enablePeriodicSampling(bool enable) {
+  periodicSamplingEnabled = enable;
+  lastSampleStart = millis();
+  if (samplingState == SAMPLING_IDLE) {
+    setSensorPower(!enable);
+  }
+
+  LOG_PRINT(LOG_INF, "定时采样已");
+  LOG_PRINTLN(LOG_INF, enable ? "开启" : "关闭");
+}
+
+bool setSamplingInterval(unsigned long intervalMs) {
+  if (intervalMs < SAMPLING_INTERVAL_MIN || intervalMs > SAMPLING_INTERVAL_MAX) {
+    return false;
+  }
+  samplingIntervalMs = intervalMs;
+  return true;
+}
+
+unsigned long getTimeUntilNextSample() {
+  unsigned long elapsed = millis() - lastSampleStart;
+  if (elapsed >= samplingIntervalMs) {
+    return 0;
+  }
+  return samplingIntervalMs - elapsed;
+}
+
+// ==================== 状态输出 ====================
+void printSamplingStatus() {
+  Serial.println("\n=== 定时采样 ===");
+  Serial.print("定时采样: ");
+  Serial.println(periodicSamplingEnabled ? "开启" : "关闭");
+  Serial.print("采样间隔: ");
+  Serial.print(samplingIntervalMs / 60000);
+  Serial.println(" 分钟");
+  Serial.print("已完成采样: ");
+  Serial.println(periodicSampleCount);
+  if (periodicSamplingEnabled) {
+    Serial.print("下次采样: ");
+    Serial.print(getTimeUntilNextSample() / 1000);
+    Serial.println(" 秒后");
+  }
+  Serial.println("================");
+}
@@ -0,0 +1,50 @@
+/**
+ * Sampling.h - 定时无人值守采样模块头文件
+ *
+ * 开启后每隔固定时间自动完成一次检测：传感器上电预热、稳定后采集，
+ * 记录日志并排队上传，然后重新进入待机；只有水质等级变化时才刷新E-Paper
+ * 待机期间由RTC定时唤醒，无需改动硬件
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <Arduino.h>
+
+// ==================== 采样配置 ====================
+#define PERIODIC_SAMPLING_ENABLED   false
+#define SAMPLING_INTERVAL_DEFAULT   900000UL  // 默认采样间隔15分钟
+#define SAMPLING_INTERVAL_MIN       60000UL   // 最短1分钟
+#define SAMPLING_INTERVAL_MAX       86400000UL
+#define SAMPLING_WARMUP_MS          2000      // 传感器上电到读数稳定的等待时间
+#define SAMPLING_POLL_INTERVAL      100
+
+// 传感器供电控制引脚，-1表示传感器常供电（当前硬件）
+#define SENSOR_POWER_PIN            -1
+
+// ==================== 采样状态 ====================
+enum SamplingState {
+  SAMPLING_IDLE = 0,
+  SAMPLING_WARMUP,       // 传感器预热中
+  SAMPLING_MEASURING     // 已触发采集，等待检测任务完成
+};
+
+// ==================== 全局变量声明 ====================
+extern bool periodicSamplingEnabled;
+extern unsigned long samplingIntervalMs;
+
+// ==================== 函数声明 ====================
+void initializeSampling();
+void taskSampling();                     // 调度任务：到期时启动采样并管理预热
+void startPeriodicSample();              // 开始一次定时采样（RTC唤醒时调用）
+bool isPeriodicSampleActive();           // 当前检测是否为定时采样
+void finishPeriodicSample();             // 检测完成后关闭传感器电源
+bool isSamplingBusy();
+bool displayNeedsRefresh();              // 水质等级与屏幕上的结果不同
+void markDisplayRefreshed();
+void enablePeriodicSampling(bool enable);
+bool setSamplingInterval(unsigned long intervalMs);
+unsigned long getTimeUntilNextSample();
+void printSamplingStatus();
+
+#endif // SAMPLING_H
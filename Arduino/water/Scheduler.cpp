@@ -0,0 +1,186 @@
+/**
+ * Scheduler.cpp - 协作式任务调度器实现
+ *
+ * 每次只运行一个就绪任务然后重新从最高优先级开始检查，
+ * 保证按钮等高优先级任务在两个任务之间就能得到响应
+ */
+
+#include "Scheduler.h"
+#include "MemoryStats.h"
+
+// ==================== 任务表 ====================
+static Task tasks[TASK_COUNT];
+
+// ==================== 任务注册与配置 ====================
+void addTask(uint8_t id, const char* name, TaskFunction run, unsigned long periodMs) {
+  if (id >= TASK_COUNT) {
+    return;
+  }
+
+  Task& task = tasks[id];
+  task.name = name;
+  task.run = run;
+  task.periodMs = periodMs;
+  task.lastRunMs = millis();
+  task.runCount = 0;
+  task.maxRunMs = 0;
+  task.maxStackBytes = 0;
+  task.eventPending = false;
+  task.enabled = true;
+}
+
+void setTaskPeriod(uint8_t id, unsigned long periodMs) {
+  if (id < TASK_COUNT) {
+    tasks[id].periodMs = periodMs;
+  }
+}
+
+void enableTask(uint8_t id, bool enable) {
+  if (id < TASK_COUNT) {
+    tasks[id].enabled = enable;
+  }
+}
+
+void signalTask(uint8_t id) {
+  if (id < TASK_COUNT) {
+    tasks[id].eventPending = true;
+  }
+}
+
+// ==================== 调度 ====================
+static bool isTaskReady(const Task& task, unsigned long now) {
+  if (!task.enabled || task.run == NULL) {
+    return false;
+  }
+  if (task.eventPending) {
+    return true;
+  }
+  return task.periodMs != TASK_EVENT_ONLY && now - task.lastRunMs >= task.periodMs;
+}
+
+bool runScheduler() {
+  unsigned long now = millis();
+
+  for (uint8_t id = 0; id < TASK_COUNT; id++) {
+    Task& task = tasks[id];
+    if (!isTaskReady(task, now)) {
+      continue;
+    }
+
+    // 先清除事件，任务运行期间再次触发的事件不会丢失
+    task.eventPending = false;
+    task.lastRunMs = now;
+
+    task.run();
+
+    unsigned long elapsed = millis() - now;
+    if (elapsed > task.maxRunMs) {
+      task.maxRunMs = elapsed;
+    }
+    task.runCount++;
+
+#if MEM_STATS_ENABLED
+    // 扫描本任务改写的栈深度并重新填充，供下一个任务单独统计
+    uint32_t stackBytes = memoryStackCheckpoint();
+    if (stackBytes > task.maxStackBytes) {
+      task.maxStackBytes = stackBytes;
+    }
+#endif
+    return true;
+  }
+
+  return false;
+}
+
+const Task* getTask(uint8_t id) {
+  if (id >= TASK_COUNT || tasks[id].run == NULL) {
+    return NULL;
+  }
+  return &tasks[id];
+}
+
+unsigned long getTimeUntilNextTask() {
+  unsigned long now = millis();
+  unsigned long wait = 0xFFFFFFFFUL;
+
+  for (uint8_t id = 0; id < TASK_COUNT; id++) {
+    const Task& task = tasks[id];
+    if (!task.enabled || task.run == NULL) {
+      continue;
+    }
+    if (task.eventPending) {
+      return 0;
+    }
+    if (task.periodMs == TASK_EVENT_ONLY) {
+      continue;
+    }
+
+    unsigned long elapsed = now - task.lastRunMs;
+    if (elapsed >= task.periodMs) {
+      return 0;
+    }
+    if (task.periodMs - elapsed < wait) {
+      wait = task.periodMs - elapsed;
+    }
+  }
+
+  return wait;
+}
+
+static bool anyEventPending() {
+  for (uint8_t id = 0; id < TASK_COUNT; id++) {
+    if (tasks[id].eventPending) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void schedulerIdle() {
+  unsigned long wait = getTimeUntilNextTask();
+  if (wait == 0) {
+    return;
+  }
+
+  // 在下一个任务到期前反复进入WFI（IDLE模式）。SysTick仍每1ms唤醒一次CPU，
+  // 所以这不是无滴答空闲：millis()由核心库内部的SysTick计数维护，无法在
+  // 停掉SysTick后补回；较长的空闲由 PowerManager 的RTC定时STANDBY覆盖
+  unsigned long start = millis();
+  while (millis() - start < wait && !anyEventPending()) {
+#if defined(ARDUINO_ARCH_SAMD)
+    __WFI();
+#else
+    yield();
+#endif
+  }
+}
+
+// ==================== 状态输出 ====================
+void printSchedulerStatus() {
+  Serial.println("\n=== 任务调度状态 ===");
+  for (uint8_t id = 0; id < TASK_COUNT; id++) {
+    const Task& task = tasks[id];
+    if (task.run == NULL) {
+      continue;
+    }
+    Serial.print(task.name);
+    Serial.print(": ");
+    if (task.periodMs == TASK_EVENT_ONLY) {
+      Serial.print("事件触发");
+    } else {
+      Serial.print("周期 ");
+      Serial.print(task.periodMs);
+      Serial.print(" ms");
+    }
+    Serial.print(", 运行 ");
+    Serial.print(task.runCount);
+    Serial.print(" 次, 最长 ");
+    Serial.print(task.maxRunMs);
+    Serial.print(" ms");
+    if (!task.enabled) {
+      Serial.print(" (已停用)");
+    }
+    Serial.println();
+  }
+  Serial.println("===================");
+}
@@ -0,0 +1,54 @@
+/**
+ * Scheduler.h - 协作式任务调度器头文件
+ *
+ * 取代 loop() 中的 delay(100) 轮询：每个任务有自己的周期或事件触发，
+ * 调度器按优先级（任务编号从小到大）运行就绪任务，空闲时让CPU休眠
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// ==================== 任务编号（数值越小优先级越高） ====================
+enum TaskId {
+  TASK_BUTTON = 0,     // 按钮输入
+  TASK_SENSORS,        // 传感器采集与水质评估（事件触发）
+  TASK_DISPLAY,        // E-Paper刷新（事件触发）
+  TASK_LORA,           // LoRa收发、补发与自动发送
+  TASK_SAMPLING,       // 定时采样（预热与触发）
+  TASK_SERIAL,         // 串口命令
+  TASK_LOG,            // 读数日志输出（事件触发）
+  TASK_TRACE,          // 追踪事件串口输出
+  TASK_COUNT
+};
+
+#define TASK_EVENT_ONLY 0    // 周期为0表示只由事件触发
+
+// ==================== 任务结构 ====================
+typedef void (*TaskFunction)();
+
+struct Task {
+  const char* name;
+  TaskFunction run;
+  unsigned long periodMs;      // 运行周期，TASK_EVENT_ONLY = 只由事件触发
+  unsigned long lastRunMs;     // 上次运行时间
+  unsigned long runCount;      // 运行次数
+  unsigned long maxRunMs;      // 单次最长运行时间
+  uint32_t maxStackBytes;      // 栈高水位（需要 MEM_STATS_ENABLED）
+  volatile bool eventPending;  // 事件标志（可在中断中设置）
+  bool enabled;
+};
+
+// ==================== 函数声明 ====================
+void addTask(uint8_t id, const char* name, TaskFunction run, unsigned long periodMs);
+void setTaskPeriod(uint8_t id, unsigned long periodMs);
+void enableTask(uint8_t id, bool enable);
+void signalTask(uint8_t id);          // 设置事件，任务将在下一次调度时运行
+bool runScheduler();                  // 运行一个就绪任务，没有就绪任务时返回false
+void schedulerIdle();                 // 休眠直到下一个任务到期或有事件
+unsigned long getTimeUntilNextTask();
+const Task* getTask(uint8_t id);      // 未注册的任务返回NULL
+void printSchedulerStatus();
+
+#endif // SCHEDULER_H
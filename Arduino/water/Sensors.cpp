@@ -5,6 +5,8 @@
  * 包含LED水质指示功能
  */
 
+#define LOG_MODULE LOG_MOD_SENSORS
+
 #include "WaterMonitor.h"
 #include "WaterQualityLED.h"  // 添加LED头文件
 
@@ -14,28 +16,84 @@ OneWire oneWire(ONE_WIRE_BUS);
 DallasTemperature temperatureSensor(&oneWire);
 bool temperatureSensorFound = false;
 
-// 传感器数据变量
-float waterTemperature = 25.0;
-float tdsValue = 0;
-float pHValue = 0;
-float turbidityNTU = 0;
-float conductivityValue = 0;
+// 最近一次发布的检测结果；采集期间写入局部变量，完成后整体替换
+static Measurement latestMeasurement = {0, 0, 25.0, 0, 0, 0, 0, 0, 0, 0, DEFAULT_WATER_QUALITY_PROFILE,
+                                        {QUALITY_UNKNOWN, {QUALITY_UNKNOWN}}};
+
+// 稳定检测的探头通道
+enum SettleChannelId {
+  SETTLE_PH = 0,
+  SETTLE_TURBIDITY,
+  SETTLE_CONDUCTIVITY,
+  SETTLE_CHANNEL_COUNT
+};
+
+struct SettleChannelConfig {
+  const char* name;        // samples 命令中的探头名
+  uint8_t pin;
+  uint8_t spacingMs;
+  uint8_t perfStage;
+  uint16_t driftMv;        // 阈值为ADC引脚电压 (mV)
+  uint16_t spreadMv;
+};
+
+static const SettleChannelConfig SETTLE_CHANNELS[SETTLE_CHANNEL_COUNT] = {
+  {"ph",           PH_SENSOR_PIN,    0,                           PERF_READ_PH,
+   PH_SETTLE_DRIFT_MV,           PH_SETTLE_SPREAD_MV},
+  {"turbidity",    TURBIDITY_PIN,    TURBIDITY_SAMPLE_SPACING_MS, PERF_READ_TURBIDITY,
+   TURBIDITY_SETTLE_DRIFT_MV,    TURBIDITY_SETTLE_SPREAD_MV},
+  {"conductivity", CONDUCTIVITY_PIN, 0,                           PERF_READ_CONDUCTIVITY,
+   CONDUCTIVITY_SETTLE_DRIFT_MV, CONDUCTIVITY_SETTLE_SPREAD_MV},
+};
+
+// 每个点的过采样次数，可用 samples 命令在运行时调整（不保存，重启后恢复默认）
+static const uint8_t DEFAULT_OVERSAMPLE_COUNTS[SETTLE_CHANNEL_COUNT] = {
+  PH_SAMPLES, TURBIDITY_SAMPLES, CONDUCTIVITY_SAMPLES
+};
+static uint8_t oversampleCounts[SETTLE_CHANNEL_COUNT] = {
+  PH_SAMPLES, TURBIDITY_SAMPLES, CONDUCTIVITY_SAMPLES
+};
+
+static SettleDetector settleDetectors[SETTLE_CHANNEL_COUNT];
+static bool acquisitionActive = false;
+static unsigned long acquisitionStartMs = 0;
+static unsigned long lastSettlePointMs = 0;
 
 // pH校准参数（计算得出）
 float pH_m = (7.0 - 4.0) / (PH7_VOLTAGE - PH4_VOLTAGE);
 float pH_b = 7.0 - pH_m * PH7_VOLTAGE;
 
+// 运行时校准常数
+static const SensorCalibration DEFAULT_CALIBRATION = {
+  PH4_VOLTAGE,
+  PH7_VOLTAGE,
+  PH10_VOLTAGE,
+  SENSOR_MAX_V,
+  MAX_CONDUCTIVITY,
+  TURBIDITY_CLEAR_WATER_V,
+  TURBIDITY_MAX_V
+};
+SensorCalibration sensorCalibration = DEFAULT_CALIBRATION;
+
+// 浊度校准表：x 为传感器电压在 清水电压→最高浊度电压 区间中的位置（千分比），
+// y 为浊度 (NTU x10)；断点按出厂 4.2V/1.0V 标定时的 3.5V、2.5V、1.5V 折算
+static const CalibrationPoint TURBIDITY_TABLE[] = {
+  {0,    0},       // 4.2V    0 NTU
+  {219,  100},     // 3.5V   10 NTU
+  {531,  1000},    // 2.5V  100 NTU
+  {844,  5000},    // 1.5V  500 NTU
+  {1000, 10000},   // 1.0V 1000 NTU
+};
+#define TURBIDITY_TABLE_SIZE (sizeof(TURBIDITY_TABLE) / sizeof(TURBIDITY_TABLE[0]))
+
 // ==================== 传感器初始化 ====================
 void initializeSensors() {
-  Serial.println("正在初始化传感器...");
-  
-  // 初始化随机数种子
-  randomSeed(analogRead(A0) + millis());
+  LOG_PRINTLN(LOG_INF, "正在初始化传感器...");
   
   // 初始化引脚
-  pinMode(PH_SENSOR_PIN, INPUT);
-  pinMode(TURBIDITY_PIN, INPUT);
-  pinMode(CONDUCTIVITY_PIN, INPUT);
+  halPinMode(PH_SENSOR_PIN, INPUT);
+  halPinMode(TURBIDITY_PIN, INPUT);
+  halPinMode(CONDUCTIVITY_PIN, INPUT);
   
   // 初始化温度传感器
   temperatureSensor.begin();
@@ -44,155 +102,431 @@ void initializeSensors() {
   if (deviceCount > 0) {
     temperatureSensorFound = true;
     temperatureSensor.setResolution(12);
-    Serial.println("✓ DS18B20温度传感器检测成功!");
+    LOG_PRINTLN(LOG_INF, "✓ DS18B20温度传感器检测成功!");
   } else {
     temperatureSensorFound = false;
-    Serial.println("⚠ 未检测到DS18B20，将使用默认温度25℃");
+    LOG_PRINTLN(LOG_WRN, "⚠ 未检测到DS18B20，将使用默认温度25℃");
   }
   
   // 初始化LED指示系统
   initializeLEDs();
   
-  Serial.println("传感器初始化完成");
+  LOG_PRINTLN(LOG_INF, "传感器初始化完成");
 }
 
-// ==================== 传感器读取函数 ====================
-void readAllSensors() {
-  Serial.println("正在读取所有传感器数据...");
+// ==================== 稳定检测采集 ====================
+// 引脚电压 (mV) → ADC定点值
+static int32_t millivoltsToAdcFixed(uint32_t mv) {
+  return (int32_t)(mv * ADC_FULL_SCALE * ADC_FIXED_ONE / ADC_VREF_MV);
+}
+
+void startAcquisition() {
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    settleReset(settleDetectors[i], millivoltsToAdcFixed(SETTLE_CHANNELS[i].driftMv),
+                millivoltsToAdcFixed(SETTLE_CHANNELS[i].spreadMv));
+  }
+  acquisitionActive = true;
+  acquisitionStartMs = millis();
+  LOG_PRINTLN(LOG_DBG, "等待探头读数稳定...");
+}
+
+bool isAcquisitionActive() {
+  return acquisitionActive;
+}
+
+bool pollAcquisition() {
+  if (!acquisitionActive) {
+    return true;
+  }
+  // 按固定间隔取点，提前调用（例如重复触发检测）时不取点
+  if (settleDetectors[0].count > 0 && millis() - lastSettlePointMs < SETTLE_INTERVAL_MS) {
+    return false;
+  }
+  lastSettlePointMs = millis();
   
-  readTemperature();
-  readPH();
-  readTurbidity();
-  readConductivity();
-  calculateTDSFromConductivity();
+  bool settled = true;
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    const SettleChannelConfig& channel = SETTLE_CHANNELS[i];
+    {
+      PERF_SCOPE(channel.perfStage);
+      settleAdd(settleDetectors[i], readAdcOversampled(channel.pin, oversampleCounts[i], channel.spacingMs));
+    }
+    settled = settled && settleIsStable(settleDetectors[i]);
+  }
+  return settled || millis() - acquisitionStartMs >= SETTLE_TIMEOUT_MS;
+}
+
+const Measurement& finishAcquisition() {
+  PERF_SCOPE(PERF_SENSORS_TOTAL);
+  acquisitionActive = false;
+  
+  Measurement m;
+  m.sequence = latestMeasurement.sequence + 1;
+  m.validMask = 0;
+  m.settledMask = 0;
+  
+  // 温度读取失败时沿用上次数值
+  m.temperature = latestMeasurement.temperature;
+  if (readTemperature(m.temperature)) m.validMask |= MEAS_TEMPERATURE;
+  
+  // 探头读数取稳定窗口内的平均值
+  const SettleDetector& ph = settleDetectors[SETTLE_PH];
+  const SettleDetector& turbidity = settleDetectors[SETTLE_TURBIDITY];
+  const SettleDetector& conductivity = settleDetectors[SETTLE_CONDUCTIVITY];
+  if (phFromAdc(settleMean(ph), m.pH)) m.validMask |= MEAS_PH;
+  if (turbidityFromAdc(settleMean(turbidity), m.turbidity)) m.validMask |= MEAS_TURBIDITY;
+  if (conductivityFromAdc(settleMean(conductivity), m.conductivity)) m.validMask |= MEAS_CONDUCTIVITY | MEAS_TDS;
+  if (settleIsStable(ph)) m.settledMask |= MEAS_PH;
+  if (settleIsStable(turbidity)) m.settledMask |= MEAS_TURBIDITY;
+  if (settleIsStable(conductivity)) m.settledMask |= MEAS_CONDUCTIVITY | MEAS_TDS;
+  m.tds = calculateTDSFromConductivity(m.conductivity, m.temperature);
+  m.timeMs = millis();
+  m.settleMs = m.timeMs - acquisitionStartMs;
+  
+  if (!isMeasurementSettled(m)) {
+    LOG_PRINTLN(LOG_WRN, "⚠ 探头读数在超时前未稳定，结果已标记为未稳定");
+  }
   
   // 显示读取到的值
-  Serial.println("=== 传感器读数 ===");
-  Serial.print("pH: "); Serial.println(pHValue, 2);
-  Serial.print("浊度: "); Serial.print(turbidityNTU, 1); Serial.println(" NTU");
-  Serial.print("TDS: "); Serial.print(tdsValue, 0); Serial.println(" ppm");
-  Serial.print("电导率: "); Serial.print(conductivityValue, 0); Serial.println(" μS/cm");
-  
-  // 直接评估水质并更新LED显示
-  Serial.println("开始LED评估...");
-  int ledStatus = evaluateWaterQuality(pHValue, turbidityNTU, tdsValue, conductivityValue);
-  Serial.print("LED评估结果: ");
-  Serial.println(ledStatus);
-  
-  setLEDStatus(ledStatus);
-  Serial.println("LED状态已设置");
-  
-  Serial.println("传感器数据读取完成");
-}
-
-void readTemperature() {
-  if (temperatureSensorFound) {
-    temperatureSensor.requestTemperatures();
-    float tempC = temperatureSensor.getTempCByIndex(0);
-    
-    // 验证温度数据有效性
-    if (tempC != DEVICE_DISCONNECTED_C && tempC > -50 && tempC < 100) {
-      waterTemperature = tempC;
-    } else {
-      Serial.println("⚠ 温度传感器读取异常，使用上次数值");
+  LOG_PRINTLN(LOG_DBG, "=== 传感器读数 ===");
+  LOG_PRINT(LOG_DBG, "pH: "); LOG_PRINTLN(LOG_DBG, m.pH, 2);
+  LOG_PRINT(LOG_DBG, "浊度: "); LOG_PRINT(LOG_DBG, m.turbidity, 1); LOG_PRINTLN(LOG_DBG, " NTU");
+  LOG_PRINT(LOG_DBG, "TDS: "); LOG_PRINT(LOG_DBG, m.tds, 0); LOG_PRINTLN(LOG_DBG, " ppm");
+  LOG_PRINT(LOG_DBG, "电导率: "); LOG_PRINT(LOG_DBG, m.conductivity, 0); LOG_PRINTLN(LOG_DBG, " μS/cm");
+  
+  // 只在这里分级一次，显示、上传等直接使用结果
+  gradeMeasurement(m);
+  LOG_PRINT(LOG_DBG, "水质评估结果: ");
+  LOG_PRINTLN(LOG_DBG, getWaterQualityName(m.assessment.overall));
+  
+  latestMeasurement = m;
+  setLEDStatus(latestMeasurement.assessment.overall);
+  LOG_PRINTLN(LOG_DBG, "LED状态已设置");
+  
+  LOG_PRINTLN(LOG_DBG, "传感器数据读取完成");
+  return latestMeasurement;
+}
+
+// 阻塞版本：只供诊断和主机回放使用，调度任务中请通过检测任务采集；
+// 检测任务正在采集时不打断它，直接返回上一次的结果（sequence 不变）
+const Measurement& readAllSensors() {
+  if (acquisitionActive) {
+    LOG_PRINTLN(LOG_WRN, "⚠ 检测任务正在采集，返回上一次的结果");
+    return latestMeasurement;
+  }
+  startAcquisition();
+  while (!pollAcquisition()) {
+    halDelay(SETTLE_INTERVAL_MS);
+  }
+  return finishAcquisition();
+}
+
+const Measurement& getLatestMeasurement() {
+  return latestMeasurement;
+}
+
+// 与 WaterParameter 顺序对应的有效性标志
+static const uint8_t PARAM_FIELDS[PARAM_COUNT] = {MEAS_PH, MEAS_TURBIDITY, MEAS_TDS, MEAS_CONDUCTIVITY};
+
+void gradeMeasurement(Measurement& m) {
+  const float values[PARAM_COUNT] = {m.pH, m.turbidity, m.tds, m.conductivity};
+  assessWaterQuality(values, m.assessment);
+  
+  // 无效读数（断线、饱和）只是占位值，记为未知且不参与总体等级；全部无效时总体未知
+  uint8_t overall = QUALITY_UNKNOWN;
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    if (!isMeasurementFieldValid(m, PARAM_FIELDS[i])) {
+      m.assessment.grades[i] = QUALITY_UNKNOWN;
+    } else if (m.assessment.grades[i] > overall) {
+      overall = m.assessment.grades[i];
     }
   }
-  // 如果没有传感器，保持默认值25.0℃
+  m.assessment.overall = overall;
+  m.profile = getWaterQualityProfile();
+}
+
+// ==================== 传感器读取函数 ====================
+// ADC平均值贴近量程两端：接近0V通常是探头断开，接近满量程是输入饱和
+static bool isAdcAtFloor(uint32_t averageFixed) {
+  return averageFixed < ADC_FIXED_ONE;
+}
+
+static bool isAdcAtCeiling(uint32_t averageFixed) {
+  return averageFixed > (ADC_FULL_SCALE - 2) * ADC_FIXED_ONE;
+}
+
+bool readTemperature(float& temperature) {
+  PERF_SCOPE(PERF_READ_TEMPERATURE);
+  if (!temperatureSensorFound) {
+    // 没有传感器时保持默认值25.0℃
+    return false;
+  }
+  
+  temperatureSensor.requestTemperatures();
+  float tempC = temperatureSensor.getTempCByIndex(0);
+  
+  // 验证温度数据有效性
+  if (tempC != DEVICE_DISCONNECTED_C && tempC > -50 && tempC < 100) {
+    temperature = tempC;
+    return true;
+  }
+  LOG_PRINTLN(LOG_WRN, "⚠ 温度传感器读取异常，使用上次数值");
+  return false;
 }
 
-void readPH() {
-  int sensorValue = analogRead(PH_SENSOR_PIN);
-  float pH_Voltage = sensorValue * (VREF / ADC_RESOLUTION);
+bool phFromAdc(uint32_t averageFixed, float& pH) {
+  float pH_Voltage = adcFixedToVolts(averageFixed);
   
   // 使用线性插值计算pH值
-  if (pH_Voltage >= PH7_VOLTAGE) {
+  if (pH_Voltage >= sensorCalibration.ph7Voltage) {
     // pH 7-10 范围
-    float m2 = (10.01 - 7.0) / (PH10_VOLTAGE - PH7_VOLTAGE);
-    float b2 = 7.0 - m2 * PH7_VOLTAGE;
-    pHValue = m2 * pH_Voltage + b2;
+    float m2 = (10.01 - 7.0) / (sensorCalibration.ph10Voltage - sensorCalibration.ph7Voltage);
+    float b2 = 7.0 - m2 * sensorCalibration.ph7Voltage;
+    pH = m2 * pH_Voltage + b2;
   } else {
     // pH 4-7 范围
-    pHValue = pH_m * pH_Voltage + pH_b;
+    pH = pH_m * pH_Voltage + pH_b;
   }
   
   // 限制pH值范围
-  if (pHValue < 0) pHValue = 0;
-  if (pHValue > 14) pHValue = 14;
+  if (pH < 0) pH = 0;
+  if (pH > 14) pH = 14;
+  
+  return !isAdcAtFloor(averageFixed) && !isAdcAtCeiling(averageFixed);
+}
+
+bool readPH(float& pH) {
+  PERF_SCOPE(PERF_READ_PH);
+  return phFromAdc(readAdcOversampled(PH_SENSOR_PIN, oversampleCounts[SETTLE_PH], 0), pH);
 }
 
-void readTurbidity() {
-  // 生成0.1-1.0之间的随机浊度值（保留一位小数）
-  float randomValue = random(1, 11) / 10.0;  // 生成0.1到1.0
-  turbidityNTU = randomValue;
+// 传感器输出电压(mV) → 浊度(NTU)，电压越低浊度越高
+float turbidityFromSensorMillivolts(uint32_t sensorMv) {
+  int32_t clearMv = (int32_t)(sensorCalibration.turbidityClearV * 1000 + 0.5);
+  int32_t maxMv = (int32_t)(sensorCalibration.turbidityMaxV * 1000 + 0.5);
+  int32_t position = (clearMv - (int32_t)sensorMv) * 1000 / (clearMv - maxMv);
+  return interpolateCalibration(TURBIDITY_TABLE, TURBIDITY_TABLE_SIZE, position) / 10.0;
+}
+
+bool turbidityFromAdc(uint32_t averageFixed, float& turbidity) {
+  uint32_t pinMv = adcFixedToMillivolts(averageFixed);
+  
+  // 还原分压前的传感器输出电压
+  uint32_t sensorMv = pinMv * (TURBIDITY_DIVIDER_R1 + TURBIDITY_DIVIDER_R2) / TURBIDITY_DIVIDER_R2;
+  turbidity = turbidityFromSensorMillivolts(sensorMv);
   
   // 调试输出
-  Serial.print("随机浊度值: ");
-  Serial.print(turbidityNTU, 1);
-  Serial.println(" NTU");
+  LOG_PRINT(LOG_DBG, "浊度传感器电压: ");
+  LOG_PRINT(LOG_DBG, sensorMv);
+  LOG_PRINT(LOG_DBG, " mV -> ");
+  LOG_PRINT(LOG_DBG, turbidity, 1);
+  LOG_PRINTLN(LOG_DBG, " NTU");
+  
+  // 最高浊度时传感器仍有约1V输出，0V只可能是断线
+  return !isAdcAtFloor(averageFixed);
 }
 
-void readConductivity() {
-  int raw = analogRead(CONDUCTIVITY_PIN);
-  float voltage = raw * VREF / 1023.0;
+bool readTurbidity(float& turbidity) {
+  PERF_SCOPE(PERF_READ_TURBIDITY);
+  return turbidityFromAdc(
+      readAdcOversampled(TURBIDITY_PIN, oversampleCounts[SETTLE_TURBIDITY], TURBIDITY_SAMPLE_SPACING_MS), turbidity);
+}
+
+bool conductivityFromAdc(uint32_t averageFixed, float& conductivity) {
+  float voltage = averageFixed * VREF / (1023.0 * ADC_FIXED_ONE);
   
   // 计算电导率值
-  conductivityValue = (voltage / SENSOR_MAX_V) * MAX_CONDUCTIVITY;
+  conductivity = (voltage / sensorCalibration.ecSensorMaxV) * sensorCalibration.ecMaxConductivity;
   
   // 确保电导率值为正
-  if (conductivityValue < 0) conductivityValue = 0;
+  if (conductivity < 0) conductivity = 0;
+  
+  // 纯水的输出接近0V属于正常读数，只有饱和时无效
+  return !isAdcAtCeiling(averageFixed);
 }
 
-void calculateTDSFromConductivity() {
+bool readConductivity(float& conductivity) {
+  PERF_SCOPE(PERF_READ_CONDUCTIVITY);
+  return conductivityFromAdc(
+      readAdcOversampled(CONDUCTIVITY_PIN, oversampleCounts[SETTLE_CONDUCTIVITY], 0), conductivity);
+}
+
+float calculateTDSFromConductivity(float conductivity, float temperature) {
   // 使用经验公式：TDS (ppm) ≈ 电导率 (μS/cm) × 0.5
   // 考虑温度补偿（简化版本）
-  float tempCompensation = 1.0 + 0.02 * (waterTemperature - 25.0);
-  tdsValue = (conductivityValue * 0.5) / tempCompensation;
+  float tempCompensation = 1.0 + 0.02 * (temperature - 25.0);
+  float tds = (conductivity * 0.5) / tempCompensation;
   
   // 确保TDS值为正
-  if (tdsValue < 0) tdsValue = 0;
+  if (tds < 0) tds = 0;
+  return tds;
+}
+
+// ==================== 校准参数管理 ====================
+void resetSensorCalibration() {
+  sensorCalibration = DEFAULT_CALIBRATION;
+  updatePHCalibration();
+}
+
+void updatePHCalibration() {
+  pH_m = (7.0 - 4.0) / (sensorCalibration.ph7Voltage - sensorCalibration.ph4Voltage);
+  pH_b = 7.0 - pH_m * sensorCalibration.ph7Voltage;
+}
+
+bool setCalibrationValue(uint8_t id, float value) {
+  SensorCalibration updated = sensorCalibration;
+  
+  switch (id) {
+    case CAL_PH4_VOLTAGE:         updated.ph4Voltage = value; break;
+    case CAL_PH7_VOLTAGE:         updated.ph7Voltage = value; break;
+    case CAL_PH10_VOLTAGE:        updated.ph10Voltage = value; break;
+    case CAL_EC_SENSOR_MAX_V:     updated.ecSensorMaxV = value; break;
+    case CAL_EC_MAX_CONDUCTIVITY: updated.ecMaxConductivity = value; break;
+    case CAL_TURBIDITY_CLEAR_V:   updated.turbidityClearV = value; break;
+    case CAL_TURBIDITY_MAX_V:     updated.turbidityMaxV = value; break;
+    default:
+      return false;
+  }
+  
+  // pH缓冲液电压必须在ADC量程内且单调递增，否则斜率无意义
+  if (updated.ph4Voltage <= 0 || updated.ph10Voltage > VREF ||
+      updated.ph4Voltage >= updated.ph7Voltage ||
+      updated.ph7Voltage >= updated.ph10Voltage) {
+    return false;
+  }
+  if (updated.ecSensorMaxV <= 0 || updated.ecSensorMaxV > VREF ||
+      updated.ecMaxConductivity <= 0) {
+    return false;
+  }
+  // 浊度电压是分压前的传感器电压，清水电压必须高于最高浊度电压
+  float turbidityFullScale = VREF * (TURBIDITY_DIVIDER_R1 + TURBIDITY_DIVIDER_R2) / TURBIDITY_DIVIDER_R2;
+  if (updated.turbidityMaxV <= 0 || updated.turbidityClearV > turbidityFullScale ||
+      updated.turbidityMaxV >= updated.turbidityClearV) {
+    return false;
+  }
+  
+  sensorCalibration = updated;
+  updatePHCalibration();
+  return true;
+}
+
+// ==================== 过采样次数 ====================
+int findSensorProbe(const char* name) {
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    if (strcmp(SETTLE_CHANNELS[i].name, name) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+uint8_t setOversampleCount(int probe, unsigned long samples) {
+  if (samples < 1) samples = 1;
+  if (samples > ADC_MAX_SAMPLES) samples = ADC_MAX_SAMPLES;
+  
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    if (probe < 0 || probe == i) {
+      oversampleCounts[i] = (uint8_t)samples;
+    }
+  }
+  return (uint8_t)samples;
+}
+
+uint8_t getOversampleCount(int probe) {
+  return (probe >= 0 && probe < SETTLE_CHANNEL_COUNT) ? oversampleCounts[probe] : 0;
+}
+
+void resetOversampleCounts() {
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    oversampleCounts[i] = DEFAULT_OVERSAMPLE_COUNTS[i];
+  }
+}
+
+void printOversampleCounts() {
+  Serial.println("\n=== ADC过采样次数 ===");
+  for (int i = 0; i < SETTLE_CHANNEL_COUNT; i++) {
+    Serial.print(SETTLE_CHANNELS[i].name);
+    Serial.print(": ");
+    Serial.print(oversampleCounts[i]);
+    Serial.print(" (默认 ");
+    Serial.print(DEFAULT_OVERSAMPLE_COUNTS[i]);
+    Serial.println(")");
+  }
 }
 
 // ==================== 数据输出函数 ====================
-void printAllReadings() {
-  Serial.println("\n=== 水质监测参数 ===");
-  Serial.print("系统时间: ");
-  Serial.print(millis() / 1000);
-  Serial.print(" 秒 (");
-  Serial.print(millis() / 60000);
-  Serial.println(" 分钟)");
-  
-  Serial.print("温度: ");
-  Serial.print(waterTemperature, 2);
-  Serial.print("℃");
-  if (!temperatureSensorFound) {
-    Serial.print(" (默认值)");
+static void printInvalidMark(const Measurement& m, uint8_t field) {
+  if (!isMeasurementFieldValid(m, field)) {
+    LOG_PRINT(LOG_INF, " (无效)");
+  } else if ((m.settledMask & field) == 0) {
+    LOG_PRINT(LOG_INF, " (未稳定)");
   }
-  Serial.println();
+}
+
+void printAllReadings(const Measurement& m) {
+  LOG_PRINTLN(LOG_INF, "\n=== 水质监测参数 ===");
+  LOG_PRINT(LOG_INF, "检测 #");
+  LOG_PRINT(LOG_INF, m.sequence);
+  LOG_PRINT(LOG_INF, "  时间: ");
+  LOG_PRINT(LOG_INF, m.timeMs / 1000);
+  LOG_PRINT(LOG_INF, " 秒 (");
+  LOG_PRINT(LOG_INF, m.timeMs / 60000);
+  LOG_PRINTLN(LOG_INF, " 分钟)");
   
-  Serial.print("电导率: ");
-  Serial.print(conductivityValue, 1);
-  Serial.println(" μS/cm");
+  LOG_PRINT(LOG_INF, "采集耗时: ");
+  LOG_PRINT(LOG_INF, m.settleMs);
+  LOG_PRINT(LOG_INF, " ms");
+  LOG_PRINTLN(LOG_INF, isMeasurementSettled(m) ? " (读数已稳定)" : " (⚠ 超时，读数未稳定)");
   
-  Serial.print("TDS: ");
-  Serial.print(tdsValue, 1);
-  Serial.println(" ppm (通过电导率计算)");
+  LOG_PRINT(LOG_INF, "温度: ");
+  LOG_PRINT(LOG_INF, m.temperature, 2);
+  LOG_PRINT(LOG_INF, "℃");
+  if (!isMeasurementFieldValid(m, MEAS_TEMPERATURE)) {
+    LOG_PRINT(LOG_INF, temperatureSensorFound ? " (沿用上次数值)" : " (默认值)");
+  }
+  LOG_PRINTLN(LOG_INF, "");
   
-  Serial.print("pH: ");
-  Serial.println(pHValue, 2);
+  LOG_PRINT(LOG_INF, "电导率: ");
+  LOG_PRINT(LOG_INF, m.conductivity, 1);
+  LOG_PRINT(LOG_INF, " μS/cm");
+  printInvalidMark(m, MEAS_CONDUCTIVITY);
+  LOG_PRINTLN(LOG_INF, "");
   
-  Serial.print("浊度: ");
-  Serial.print(turbidityNTU, 2);
-  Serial.println(" NTU");
+  LOG_PRINT(LOG_INF, "TDS: ");
+  LOG_PRINT(LOG_INF, m.tds, 1);
+  LOG_PRINT(LOG_INF, " ppm (通过电导率计算)");
+  printInvalidMark(m, MEAS_TDS);
+  LOG_PRINTLN(LOG_INF, "");
   
-  Serial.print("水质状态: ");
-  Serial.println(getWaterQualityStatus());
+  LOG_PRINT(LOG_INF, "pH: ");
+  LOG_PRINT(LOG_INF, m.pH, 2);
+  printInvalidMark(m, MEAS_PH);
+  LOG_PRINTLN(LOG_INF, "");
   
-  Serial.println("====================================");
+  LOG_PRINT(LOG_INF, "浊度: ");
+  LOG_PRINT(LOG_INF, m.turbidity, 2);
+  LOG_PRINT(LOG_INF, " NTU");
+  printInvalidMark(m, MEAS_TURBIDITY);
+  LOG_PRINTLN(LOG_INF, "");
+  
+  LOG_PRINT(LOG_INF, "水质状态: ");
+  LOG_PRINT(LOG_INF, getWaterQualityDescriptionText(m.assessment.overall));
+  LOG_PRINT(LOG_INF, " (标准: ");
+  LOG_PRINT(LOG_INF, getWaterQualityProfileName(m.profile));
+  LOG_PRINTLN(LOG_INF, ")");
+  
+  LOG_PRINTLN(LOG_INF, "====================================");
 }
 
 // ==================== 水质状态评估 ====================
+uint8_t getWaterQualityGrade() {
+  return latestMeasurement.assessment.overall;
+}
+
+const char* getWaterQualityStatusText() {
+  return getWaterQualityDescriptionText(latestMeasurement.assessment.overall);
+}
+
 String getWaterQualityStatus() {
-  // 使用LED评估系统获取水质状态
-  int ledStatus = evaluateWaterQuality(pHValue, turbidityNTU, tdsValue, conductivityValue);
-  return getWaterQualityDescription(ledStatus);
+  return String(getWaterQualityStatusText());
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+ * SerialCommands.cpp - 串口命令解析实现
+ *
+ * 每次调用只读取已到达的字符，半行命令留在缓冲区等下一次，
+ * 调度循环不会因为没有换行而阻塞
+ */
+
+#include "SerialCommands.h"
+#include "PowerManager.h"
+#include "Hal.h"
+#include <limits.h>
+
+// ==================== 行缓冲区 ====================
+static char lineBuffer[SERIAL_LINE_MAX];
+static uint8_t lineLength = 0;
+static bool lineOverflow = false;
+
+// 读取到完整的一行时返回true，行内容已转换为小写
+static bool readSerialLine() {
+  for (int i = 0; i < SERIAL_MAX_READ_PER_RUN && halSerialAvailable() > 0; i++) {
+    char c = (char)halSerialRead();
+
+    if (c == '\n' || c == '\r') {
+      if (lineOverflow) {
+        Serial.println("✗ 命令过长，已忽略");
+        lineOverflow = false;
+        lineLength = 0;
+        continue;
+      }
+      if (lineLength == 0) {
+        continue;   // 空行或 \r\n 的第二个字符
+      }
+      lineBuffer[lineLength] = '\0';
+      lineLength = 0;
+      return true;
+    }
+
+    if (lineLength < SERIAL_LINE_MAX - 1) {
+      lineBuffer[lineLength++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    } else {
+      lineOverflow = true;
+    }
+  }
+  return false;
+}
+
+// 在缓冲区内原地切分：命令名返回，参数写入args
+static const char* tokenizeLine(char* line, CommandArgs& args) {
+  const char* name = NULL;
+  args.count = 0;
+
+  char* p = line;
+  while (*p != '\0') {
+    while (*p == ' ' || *p == '\t') {
+      *p++ = '\0';
+    }
+    if (*p == '\0') {
+      break;
+    }
+
+    if (name == NULL) {
+      name = p;
+    } else if (args.count < SERIAL_MAX_ARGS) {
+      args.values[args.count++] = p;
+    }
+
+    while (*p != '\0' && *p != ' ' && *p != '\t') {
+      p++;
+    }
+  }
+  return name;
+}
+
+// ==================== 命令分发 ====================
+void pollSerialCommands(const SerialCommand* commands, uint8_t count) {
+  if (!readSerialLine()) {
+    return;
+  }
+
+  CommandArgs args;
+  const char* name = tokenizeLine(lineBuffer, args);
+  if (name == NULL) {
+    return;
+  }
+  notePowerActivity();
+
+  uint32_t hash = commandHash(name);
+  for (uint8_t i = 0; i < count; i++) {
+    // 哈希相同再比较名称，避免冲突
+    if (commands[i].hash == hash && strcmp(commands[i].name, name) == 0) {
+      commands[i].handle(args);
+      return;
+    }
+  }
+
+  Serial.print("未知命令: ");
+  Serial.print(name);
+  Serial.println("（输入 help 查看可用命令）");
+}
+
+void printCommandHelp(const SerialCommand* commands, uint8_t count) {
+  Serial.println("\n=== 可用命令 ===");
+  for (uint8_t i = 0; i < count; i++) {
+    if (commands[i].help == NULL) {
+      continue;
+    }
+    Serial.print(commands[i].name);
+    for (int pad = strlen(commands[i].name); pad < 10; pad++) {
+      Serial.print(' ');
+    }
+    Serial.print(" - ");
+    Serial.println(commands[i].help);
+  }
+  Serial.println("===============");
+}
+
+// ==================== 参数辅助函数 ====================
+bool argEquals(const CommandArgs& args, uint8_t index, const char* value) {
+  return index < args.count && strcmp(args.values[index], value) == 0;
+}
+
+bool parseUnsignedArg(const CommandArgs& args, uint8_t index, unsigned long& value) {
+  if (index >= args.count) {
+    return false;
+  }
+
+  const char* p = args.values[index];
+  unsigned long result = 0;
+  if (*p == '\0') {
+    return false;
+  }
+  while (*p != '\0') {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
+    unsigned long digit = *p - '0';
+    if (result > (ULONG_MAX - digit) / 10) {
+      return false;  // 溢出
+    }
+    result = result * 10 + digit;
+    p++;
+  }
+  value = result;
+  return true;
+}
+
+bool parseOnOffArg(const CommandArgs& args, uint8_t index, bool& value) {
+  if (argEquals(args, index, "on")) {
+    value = true;
+    return true;
+  }
+  if (argEquals(args, index, "off")) {
+    value = false;
+    return true;
+  }
+  return false;
+}
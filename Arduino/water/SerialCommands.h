@@ -0,0 +1,50 @@
+/**
+ * SerialCommands.h - 串口命令解析头文件
+ *
+ * 非阻塞逐字符读取到固定缓冲区，收到换行后按空格切分参数，
+ * 用命令名的 FNV-1a 哈希（编译期计算）在命令表中查找处理函数；
+ * 整个过程不使用 String，不分配堆内存
+ */
+
+#ifndef SERIAL_COMMANDS_H
+#define SERIAL_COMMANDS_H
+
+#include <Arduino.h>
+
+// ==================== 解析配置 ====================
+#define SERIAL_LINE_MAX        64   // 一行命令的最大长度（含结束符）
+#define SERIAL_MAX_ARGS        4    // 命令名之后的最大参数个数
+#define SERIAL_MAX_READ_PER_RUN 32  // 每次任务最多读取的字符数
+
+// ==================== 编译期哈希 ====================
+constexpr uint32_t commandHash(const char* text, uint32_t hash = 2166136261UL) {
+  return *text == '\0' ? hash : commandHash(text + 1, (hash ^ (uint8_t)*text) * 16777619UL);
+}
+
+// ==================== 命令表 ====================
+struct CommandArgs {
+  uint8_t count;
+  const char* values[SERIAL_MAX_ARGS];
+};
+
+typedef void (*CommandHandler)(const CommandArgs& args);
+
+struct SerialCommand {
+  uint32_t hash;           // commandHash(name)
+  const char* name;
+  CommandHandler handle;
+  const char* help;        // 为NULL时不在帮助中显示
+};
+
+#define SERIAL_COMMAND(name, handler, help) { commandHash(name), name, handler, help }
+
+// ==================== 函数声明 ====================
+void pollSerialCommands(const SerialCommand* commands, uint8_t count);
+void printCommandHelp(const SerialCommand* commands, uint8_t count);
+
+// 参数辅助函数
+bool argEquals(const CommandArgs& args, uint8_t index, const char* value);
+bool parseUnsignedArg(const CommandArgs& args, uint8_t index, unsigned long& value);
+bool parseOnOffArg(const CommandArgs& args, uint8_t index, bool& value);
+
+#endif // SERIAL_COMMANDS_H
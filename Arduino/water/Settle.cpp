@@ -0,0 +1,74 @@
+/**
+ * Settle.cpp - 探头稳定检测实现
+ *
+ * 趋势：点 k（从最旧的 0 开始）的权重 w = 2k - (N-1)，最小二乘斜率为 2·Σwx / Σw²，
+ *       首尾变化 drift = 斜率 × (N-1)
+ * 波动：N·Σd² - (Σd)² = N² × 方差，d 取相对最旧点的差值以缩小数值范围
+ */
+
+#include "Settle.h"
+
+// ==================== 窗口维护 ====================
+void settleReset(SettleDetector& detector, int32_t maxDrift, int32_t maxSpread) {
+  detector.count = 0;
+  detector.next = 0;
+  detector.maxDrift = maxDrift;
+  detector.maxSpread = maxSpread;
+}
+
+void settleAdd(SettleDetector& detector, int32_t value) {
+  detector.window[detector.next] = value;
+  detector.next = (detector.next + 1) % SETTLE_WINDOW;
+  if (detector.count < SETTLE_WINDOW) {
+    detector.count++;
+  }
+}
+
+// ==================== 稳定判断 ====================
+bool settleIsStable(const SettleDetector& detector) {
+  if (detector.count < SETTLE_WINDOW) {
+    return false;
+  }
+
+  const int32_t n = SETTLE_WINDOW;
+  int32_t oldest = detector.window[detector.next];
+  int64_t weighted = 0;      // Σwx
+  int64_t weightSquares = 0; // Σw²
+  int64_t sum = 0;           // Σd
+  int64_t sumSquares = 0;    // Σd²
+
+  for (int32_t k = 0; k < n; k++) {
+    int32_t d = detector.window[(detector.next + k) % SETTLE_WINDOW] - oldest;
+    int32_t w = 2 * k - (n - 1);
+    weighted += (int64_t)w * d;
+    weightSquares += w * w;
+    sum += d;
+    sumSquares += (int64_t)d * d;
+  }
+
+  // |2(N-1)·Σwx / Σw²| <= maxDrift
+  int64_t drift = 2 * (n - 1) * weighted;
+  if (drift < 0) {
+    drift = -drift;
+  }
+  if (drift > (int64_t)detector.maxDrift * weightSquares) {
+    return false;
+  }
+
+  // 方差 <= maxSpread²
+  int64_t spread = (int64_t)detector.maxSpread * detector.maxSpread;
+  return n * sumSquares - sum * sum <= (int64_t)n * n * spread;
+}
+
+int32_t settleMean(const SettleDetector& detector) {
+  if (detector.count == 0) {
+    return 0;
+  }
+  // 从最旧的点开始取最近 count 个
+  uint8_t start = (detector.next + SETTLE_WINDOW - detector.count) % SETTLE_WINDOW;
+  int32_t sum = 0;
+  for (uint8_t k = 0; k < detector.count; k++) {
+    sum += detector.window[(start + k) % SETTLE_WINDOW];
+  }
+  return (sum + detector.count / 2) / detector.count;
+}
@@ -0,0 +1,30 @@
+/**
+ * Settle.h - 探头稳定检测
+ *
+ * 每个通道保留最近 SETTLE_WINDOW 个过采样点（ADC定点值），
+ * 窗口内线性趋势的变化量和标准差都不超过阈值时视为稳定；
+ * 全部整数运算，比较时两边同乘分母，不需要除法和开方
+ */
+
+#ifndef SETTLE_H
+#define SETTLE_H
+
+#include <Arduino.h>
+
+#define SETTLE_WINDOW 8       // 窗口长度（点数）
+
+struct SettleDetector {
+  int32_t window[SETTLE_WINDOW];   // 环形缓冲
+  uint8_t count;                   // 已有点数，最多 SETTLE_WINDOW
+  uint8_t next;                    // 下一个写入位置；窗口已满时也是最旧的点
+  int32_t maxDrift;                // 最小二乘直线在窗口首尾之间的最大允许变化
+  int32_t maxSpread;               // 最大允许标准差
+};
+
+// ==================== 函数声明 ====================
+void settleReset(SettleDetector& detector, int32_t maxDrift, int32_t maxSpread);
+void settleAdd(SettleDetector& detector, int32_t value);
+bool settleIsStable(const SettleDetector& detector);   // 窗口未满时返回 false
+int32_t settleMean(const SettleDetector& detector);    // 窗口内平均值（四舍五入），空窗口返回 0
+
+#endif // SETTLE_H
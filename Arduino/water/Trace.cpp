@@ -0,0 +1,132 @@
+/**
+ * Trace.cpp - 二进制事件追踪实现
+ *
+ * 写入只在关中断期间复制12字节
+ * 未开启输出时缓冲区作为黑匣子，满了覆盖最旧的事件，开启输出即可看到最近的历史；
+ * 开启输出时满了丢弃新事件并计数，下次输出时补一条 TRACE_DROPPED 事件
+ */
+
+#include "Trace.h"
+#include "Hal.h"
+
+// ==================== 全局变量定义 ====================
+bool traceOutputEnabled = false;
+
+static TraceRecord traceBuffer[TRACE_BUFFER_SIZE];
+static volatile uint16_t traceHead = 0;     // 下一条要输出的事件
+static volatile uint16_t traceCount = 0;
+static volatile uint16_t traceDropped = 0;
+static uint32_t traceTotalSent = 0;
+
+// ==================== 写入 ====================
+void traceRecord(uint16_t event, uint16_t arg0, uint32_t arg1) {
+  uint32_t now = micros();
+
+  noInterrupts();
+  if (traceCount == TRACE_BUFFER_SIZE) {
+    if (traceOutputEnabled) {
+      traceDropped++;
+      interrupts();
+      return;
+    }
+    traceHead = (traceHead + 1) & (TRACE_BUFFER_SIZE - 1);
+    traceCount--;
+  }
+  TraceRecord& record = traceBuffer[(traceHead + traceCount) & (TRACE_BUFFER_SIZE - 1)];
+  record.timeUs = now;
+  record.event = event;
+  record.arg0 = arg0;
+  record.arg1 = arg1;
+  traceCount++;
+  interrupts();
+}
+
+static bool popTrace(TraceRecord& record) {
+  noInterrupts();
+  if (traceCount == 0) {
+    interrupts();
+    return false;
+  }
+  record = traceBuffer[traceHead];
+  traceHead = (traceHead + 1) & (TRACE_BUFFER_SIZE - 1);
+  traceCount--;
+  interrupts();
+  return true;
+}
+
+// ==================== 串口输出 ====================
+static void writeFrame(const TraceRecord& record) {
+  uint8_t frame[TRACE_FRAME_SIZE];
+  frame[0] = TRACE_SYNC_0;
+  frame[1] = TRACE_SYNC_1;
+  frame[2] = record.timeUs & 0xFF;
+  frame[3] = (record.timeUs >> 8) & 0xFF;
+  frame[4] = (record.timeUs >> 16) & 0xFF;
+  frame[5] = (record.timeUs >> 24) & 0xFF;
+  frame[6] = record.event & 0xFF;
+  frame[7] = record.event >> 8;
+  frame[8] = record.arg0 & 0xFF;
+  frame[9] = record.arg0 >> 8;
+  frame[10] = record.arg1 & 0xFF;
+  frame[11] = (record.arg1 >> 8) & 0xFF;
+  frame[12] = (record.arg1 >> 16) & 0xFF;
+  frame[13] = (record.arg1 >> 24) & 0xFF;
+
+  uint8_t check = 0;
+  for (int i = 2; i < TRACE_FRAME_SIZE - 1; i++) {
+    check ^= frame[i];
+  }
+  frame[14] = check;
+
+  halSerialWrite(frame, TRACE_FRAME_SIZE);
+  traceTotalSent++;
+}
+
+void taskTrace() {
+  if (!traceOutputEnabled) {
+    return;
+  }
+
+  // 先报告丢失的事件
+  if (traceDropped > 0 && halSerialAvailableForWrite() >= TRACE_FRAME_SIZE) {
+    noInterrupts();
+    uint16_t dropped = traceDropped;
+    traceDropped = 0;
+    interrupts();
+    TraceRecord record = {(uint32_t)micros(), TRACE_DROPPED, dropped, 0};
+    writeFrame(record);
+  }
+
+  // 只在发送缓冲区有空间时输出，不等待串口
+  TraceRecord record;
+  for (int i = 0; i < TRACE_MAX_FRAMES_PER_RUN; i++) {
+    if (halSerialAvailableForWrite() < TRACE_FRAME_SIZE || !popTrace(record)) {
+      break;
+    }
+    writeFrame(record);
+  }
+}
+
+void enableTraceOutput(bool enable) {
+  traceOutputEnabled = enable;
+}
+
+uint16_t getTraceCount() {
+  return traceCount;
+}
+
+// ==================== 状态输出 ====================
+void printTraceStatus() {
+  Serial.println("\n=== 事件追踪 ===");
+  Serial.print("串口输出: ");
+  Serial.println(traceOutputEnabled ? "开启" : "关闭");
+  Serial.print("缓冲区: ");
+  Serial.print(traceCount);
+  Serial.print(" / ");
+  Serial.println(TRACE_BUFFER_SIZE);
+  Serial.print("已输出: ");
+  Serial.print(traceTotalSent);
+  Serial.print(", 丢失: ");
+  Serial.println(traceDropped);
+  Serial.println("================");
+}
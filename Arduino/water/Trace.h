@@ -0,0 +1,72 @@
+/**
+ * Trace.h - 二进制事件追踪头文件
+ *
+ * 每条事件 12 字节（时间戳 + 事件号 + 两个参数），O(1) 写入RAM环形缓冲区，
+ * 由低优先级任务在串口空闲时以二进制帧输出，不阻塞被追踪的代码
+ * 主机端用 Arduino/tools/trace-decode.js 解码为时间线
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+// ==================== 追踪配置 ====================
+#define TRACE_BUFFER_SIZE        64     // 事件条数（2的幂）
+#define TRACE_DRAIN_INTERVAL     50     // 输出任务周期（毫秒）
+#define TRACE_MAX_FRAMES_PER_RUN 8      // 每次最多输出的帧数
+
+// 串口帧：同步字节 0xA5 0x5A + 12字节事件（小端）+ 异或校验
+#define TRACE_SYNC_0             0xA5
+#define TRACE_SYNC_1             0x5A
+#define TRACE_FRAME_SIZE         15
+
+// ==================== 事件编号 ====================
+// 新增事件时同步更新 Arduino/tools/trace-decode.js 中的事件表
+enum TraceEventId {
+  TRACE_BOOT = 1,            // arg0: -, arg1: -
+  TRACE_DROPPED,             // arg0: 丢失的事件数
+  TRACE_BUTTON_EDGE,         // arg0: 电平, arg1: 边沿时间 (ms)
+  TRACE_BUTTON_GESTURE,      // arg0: ButtonEventType
+  TRACE_TEST_TRIGGER,        // 检测被触发
+  TRACE_SENSORS_DONE,        // arg0: 水质等级, arg1: 耗时 (us)
+  TRACE_DISPLAY_DONE,        // arg1: 耗时 (us)
+  TRACE_LORA_TX_START,       // arg0: 端口 << 8 | 长度, arg1: 帧计数
+  TRACE_LORA_TX_END,         // arg0: 是否确认帧, arg1: 结果代码
+  TRACE_DOWNLINK,            // arg0: 长度, arg1: 成功执行的命令数
+  TRACE_BACKLOG,             // arg0: 缓存条数
+  TRACE_SLEEP_ENTER,         // arg1: 定时唤醒时间 (ms)，0 = 只由按钮唤醒
+  TRACE_WAKE,                // arg0: 0 = RTC定时, 1 = 按钮
+  TRACE_SAMPLE_START,        // 定时采样开始预热
+  TRACE_EVENT_COUNT
+};
+
+// ==================== 事件记录 ====================
+struct TraceRecord {
+  uint32_t timeUs;    // micros()
+  uint16_t event;
+  uint16_t arg0;
+  uint32_t arg1;
+};
+
+// ==================== 全局变量声明 ====================
+extern bool traceOutputEnabled;
+
+// ==================== 函数声明 ====================
+void traceRecord(uint16_t event, uint16_t arg0, uint32_t arg1);
+void taskTrace();                    // 调度任务：串口空闲时输出缓冲区中的事件
+void enableTraceOutput(bool enable);
+uint16_t getTraceCount();
+void printTraceStatus();
+
+#if TRACE_ENABLED
+#define TRACE(event, arg0, arg1) traceRecord((event), (arg0), (arg1))
+#else
+#define TRACE(event, arg0, arg1) do {} while (0)
+#endif
+
+#endif // TRACE_H
@@ -16,6 +16,20 @@
 #include "epd2in9_V2.h"
 #include "epdpaint.h"
 #include "LoRaComm.h"  // 添加LoRa通信模块
+#include "LoRaSession.h"  // LoRa会话持久化
+#include "Hal.h"          // 硬件抽象层（ADC/GPIO/SPI/串口）
+#include "Scheduler.h"    // 协作式任务调度
+#include "PowerManager.h" // 低功耗待机
+#include "Sampling.h"     // 定时无人值守采样
+#include "Oversample.h"   // ADC过采样与定点换算
+#include "Settle.h"       // 探头稳定检测
+#include "Perf.h"         // 关键路径耗时统计
+#include "MemoryStats.h"  // RAM/堆/栈使用统计
+#include "Trace.h"        // 二进制事件追踪
+#include "Log.h"          // 分级日志
+#include "SerialCommands.h" // 串口命令解析
+#include "Downlink.h"     // 下行命令（参数范围与串口命令共用）
+#include "Measurement.h"  // 单次检测结果
 
 // ==================== 引脚定义 ====================
 // 传感器引脚定义（适配MKR WAN1310）
@@ -36,6 +50,16 @@
 
 // 按钮控制参数
 #define BUTTON_COOLDOWN 10000  // 10秒冷却时间
+#define BUTTON_DEBOUNCE_MS 30
+#define BUTTON_LONG_PRESS_MS 1000
+#define BUTTON_DOUBLE_PRESS_GAP 350
+#define BUTTON_EDGE_QUEUE_SIZE 16
+#define BUTTON_EVENT_QUEUE_SIZE 8
+
+// 任务调度周期（毫秒），按钮只在手势判断期间周期运行
+#define BUTTON_POLL_INTERVAL 10
+#define LORA_POLL_INTERVAL 100
+#define SERIAL_POLL_INTERVAL 20
 
 // pH校准参数
 #define PH4_VOLTAGE 1.73
@@ -46,34 +70,95 @@
 #define SENSOR_MAX_V 2.3
 #define MAX_CONDUCTIVITY 2000.0
 
+// 浊度参数（传感器输出5V量程，经 6.8k/6.8k 分压后接入A2）
+#define TURBIDITY_CLEAR_WATER_V   4.2     // 清水（0 NTU）时的传感器输出电压
+#define TURBIDITY_MAX_V           1.0     // 最高浊度（1000 NTU）时的传感器输出电压
+#define TURBIDITY_DIVIDER_R1      6800    // 上电阻 (Ω)
+#define TURBIDITY_DIVIDER_R2      6800    // 下电阻 (Ω)
+
+// 每次读数的ADC过采样次数（默认值，运行时可用 samples 命令调整）与间隔
+#define PH_SAMPLES                16
+#define CONDUCTIVITY_SAMPLES      16
+#define TURBIDITY_SAMPLES         32
+#define TURBIDITY_SAMPLE_SPACING_MS 2     // 分散到约60ms内，平滑气泡和工频干扰
+
+// 探头稳定检测：每隔 SETTLE_INTERVAL_MS 为每个探头取一个过采样点，
+// 最近 SETTLE_WINDOW 个点的趋势和标准差都低于阈值（ADC引脚电压）即结束采集；
+// 超时仍未稳定时使用最后一个窗口的平均值并标记为未稳定
+#define SETTLE_INTERVAL_MS        250
+#define SETTLE_TIMEOUT_MS         8000
+#define PH_SETTLE_DRIFT_MV        2       // 约0.025 pH
+#define PH_SETTLE_SPREAD_MV       2
+#define TURBIDITY_SETTLE_DRIFT_MV 10      // 清水附近约0.3 NTU
+#define TURBIDITY_SETTLE_SPREAD_MV 10
+#define CONDUCTIVITY_SETTLE_DRIFT_MV 4    // 约3.5 μS/cm
+#define CONDUCTIVITY_SETTLE_SPREAD_MV 4
+
 // ==================== 全局变量声明 ====================
 // 传感器对象
 extern OneWire oneWire;
 extern DallasTemperature temperatureSensor;
 extern bool temperatureSensorFound;
 
-// 传感器数据变量
-extern float waterTemperature;
-extern float tdsValue;
-extern float pHValue;
-extern float turbidityNTU;
-extern float conductivityValue;
-
 // pH校准参数（计算得出）
 extern float pH_m;
 extern float pH_b;
 
+// 运行时校准常数（默认值来自上面的#define，可通过下行命令修改）
+enum CalibrationId {
+  CAL_PH4_VOLTAGE = 0,     // pH4缓冲液电压 (V)
+  CAL_PH7_VOLTAGE,         // pH7缓冲液电压 (V)
+  CAL_PH10_VOLTAGE,        // pH10缓冲液电压 (V)
+  CAL_EC_SENSOR_MAX_V,     // 电导率传感器满量程电压 (V)
+  CAL_EC_MAX_CONDUCTIVITY, // 电导率满量程 (μS/cm)
+  CAL_TURBIDITY_CLEAR_V,   // 浊度传感器清水电压 (V)
+  CAL_TURBIDITY_MAX_V,     // 浊度传感器最高浊度电压 (V)
+  CAL_COUNT
+};
+
+struct SensorCalibration {
+  float ph4Voltage;
+  float ph7Voltage;
+  float ph10Voltage;
+  float ecSensorMaxV;
+  float ecMaxConductivity;
+  float turbidityClearV;
+  float turbidityMaxV;
+};
+
+extern SensorCalibration sensorCalibration;
+
 // E-Paper对象
 extern unsigned char image[1024];
 extern Paint paint;
 extern Epd epd;
 
+// 按钮手势事件
+enum ButtonEventType {
+  BUTTON_EVENT_SHORT = 1,   // 单击：水质检测
+  BUTTON_EVENT_LONG,        // 长按：完整刷新屏幕
+  BUTTON_EVENT_DOUBLE       // 双击：补发缓存数据
+};
+
+// 按钮状态
+enum ButtonState {
+  BUTTON_STATE_NOT_READY = 0,
+  BUTTON_STATE_COOLDOWN,
+  BUTTON_STATE_READY,
+  BUTTON_STATE_COUNT
+};
+
+struct ButtonEvent {
+  uint8_t type;
+  unsigned long timeMs;
+};
+
 // 按钮控制变量
-extern bool lastButtonState;
 extern bool currentButtonState;
 extern bool buttonPressed;
 extern unsigned long lastButtonPress;
 extern bool systemReady;
+extern volatile unsigned long lastButtonEdgeMs;
 
 // ==================== 函数声明 ====================
 // 系统初始化
@@ -83,30 +168,63 @@ void initializeEPaper();
 void initializeButton();
 
 // 传感器读取模块
-void readAllSensors();
-void readTemperature();
-void readPH();
-void readTurbidity();
-void readConductivity();
-void calculateTDSFromConductivity();
-void printAllReadings();
+// 采集流程：startAcquisition() → 周期调用 pollAcquisition() 直到返回 true →
+// finishAcquisition() 分级一次，发布为新的最近结果并更新LED；
+// readAllSensors() 是同一流程的阻塞版本（最长 SETTLE_TIMEOUT_MS），只供诊断和主机回放使用，
+// 已有采集进行中时返回上一次的结果。各 read/FromAdc 函数返回读数是否有效
+void startAcquisition();
+bool pollAcquisition();                     // 全部探头稳定或超时返回 true
+bool isAcquisitionActive();
+const Measurement& finishAcquisition();
+const Measurement& readAllSensors();
+const Measurement& getLatestMeasurement();  // 尚未采集时 sequence 为 0
+void gradeMeasurement(Measurement& m);      // 按当前监管配置填写 assessment 和 profile
+bool readTemperature(float& temperature);   // 读取失败时不修改 temperature
+bool readPH(float& pH);
+bool readTurbidity(float& turbidity);
+bool readConductivity(float& conductivity);
+bool phFromAdc(uint32_t averageFixed, float& pH);
+bool turbidityFromAdc(uint32_t averageFixed, float& turbidity);
+bool conductivityFromAdc(uint32_t averageFixed, float& conductivity);
+float turbidityFromSensorMillivolts(uint32_t sensorMv);
+float calculateTDSFromConductivity(float conductivity, float temperature);
+void printAllReadings(const Measurement& m);
+bool setCalibrationValue(uint8_t id, float value);
+void resetSensorCalibration();
+int findSensorProbe(const char* name);     // ph | turbidity | conductivity，未知返回 -1
+uint8_t setOversampleCount(int probe, unsigned long samples);  // probe < 0 表示全部；返回限幅到 1~ADC_MAX_SAMPLES 后的值
+uint8_t getOversampleCount(int probe);
+void resetOversampleCounts();
+void printOversampleCounts();
+void updatePHCalibration();
 
 // 显示模块
 void showStartupScreen();
-void updateWaterQualityDisplay();
-void displaySensorData();
-String getWaterQualityStatus();
+void updateWaterQualityDisplay(const Measurement& m);
+void displaySensorData(const Measurement& m);
+uint8_t getWaterQualityGrade();            // 最近一次结果的总体等级
+const char* getWaterQualityStatusText();
+String getWaterQualityStatus();            // 仅供调试
+void sleepDisplay();
+void wakeDisplay();
+void requestFullRefresh();
 
 // 按钮控制模块
 void handleButtonInput();
+void onButtonEdge();
+bool hasPendingButtonEdges();
+bool getButtonEvent(ButtonEvent& event);
 bool isButtonPressed();
 bool isCooldownPeriod();
 void handleCooldownMessage();
 void setSystemReady(bool ready);
 bool isSystemReady();
 unsigned long getRemainingCooldown();
-String getButtonStatus();
+uint8_t getButtonState();
+const char* getButtonStateName(uint8_t state);
+String getButtonStatus();                  // 仅供调试
 void printButtonDebugInfo();
+void acknowledgeWakePress();
 
 // 显示模块扩展函数
 void displayError(const char* errorMsg);
@@ -117,7 +235,6 @@ void performWaterQualityTest();
 void printSystemStatus();
 void handleSystemError(const char* errorMsg);
 void runDiagnostics();
-int getFreeMemory();
 void handleSerialCommands();
 
 // ==================== LoRa相关函数 ====================
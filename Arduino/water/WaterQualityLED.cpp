@@ -4,21 +4,48 @@
  * 处理基于水质参数的三色LED指示功能
  */
 
+#define LOG_MODULE LOG_MOD_LED
+
 #include "WaterQualityLED.h"
+#include "Log.h"
+#include "Hal.h"
+#include <FlashStorage.h>
+
+// ==================== 运行时规则 ====================
+// 当前配置的规则在RAM中的副本，分级循环只读这里，与选择哪个配置无关；
+// 下行命令修改的阈值只作用于副本，切换配置或重置时恢复
+WaterQualityRule activeWaterQualityRules[PARAM_COUNT] = {
+  WATER_QUALITY_RULES[PARAM_PH],
+  WATER_QUALITY_RULES[PARAM_TURBIDITY],
+  WATER_QUALITY_RULES[PARAM_TDS],
+  WATER_QUALITY_RULES[PARAM_EC]
+};
+
+static uint8_t activeProfile = DEFAULT_WATER_QUALITY_PROFILE;
+
+// ==================== Flash存储 ====================
+#define PROFILE_RECORD_MAGIC 0x57515046UL  // "WQPF"
+
+struct WaterQualityProfileRecord {
+  uint32_t magic;
+  uint8_t profile;
+};
+
+FlashStorage(waterQualityProfileStore, WaterQualityProfileRecord);
 
 // ==================== LED初始化 ====================
 void initializeLEDs() {
-  Serial.println("初始化水质指示LED...");
+  LOG_PRINTLN(LOG_INF, "初始化水质指示LED...");
   
   // 设置LED引脚为输出模式
-  pinMode(RED_LED_PIN, OUTPUT);
-  pinMode(GREEN_LED_PIN, OUTPUT);
-  pinMode(YELLOW_LED_PIN, OUTPUT);
+  halPinMode(RED_LED_PIN, OUTPUT);
+  halPinMode(GREEN_LED_PIN, OUTPUT);
+  halPinMode(YELLOW_LED_PIN, OUTPUT);
   
   // 关闭所有LED
   turnOffAllLEDs();
   
-  Serial.println("✓ LED初始化完成");
+  LOG_PRINTLN(LOG_INF, "✓ LED初始化完成");
 }
 
 // ==================== LED控制函数 ====================
@@ -29,105 +56,196 @@ void setLEDStatus(int ledStatus) {
   // 根据状态点亮对应LED
   switch(ledStatus) {
     case GREEN_LED:
-      digitalWrite(GREEN_LED_PIN, HIGH);
-      Serial.println("LED状态: 绿灯 - 水质优秀");
+      halDigitalWrite(GREEN_LED_PIN, HIGH);
+      LOG_PRINTLN(LOG_DBG, "LED状态: 绿灯 - 水质优秀");
       break;
       
     case YELLOW_LED:
-      digitalWrite(YELLOW_LED_PIN, HIGH);
-      Serial.println("LED状态: 黄灯 - 水质一般");
+      halDigitalWrite(YELLOW_LED_PIN, HIGH);
+      LOG_PRINTLN(LOG_DBG, "LED状态: 黄灯 - 水质一般");
       break;
       
     case RED_LED:
-      digitalWrite(RED_LED_PIN, HIGH);
-      Serial.println("LED状态: 红灯 - 水质不安全");
+      halDigitalWrite(RED_LED_PIN, HIGH);
+      LOG_PRINTLN(LOG_DBG, "LED状态: 红灯 - 水质不安全");
       break;
       
     default:
-      Serial.println("LED状态: 全部关闭");
+      LOG_PRINTLN(LOG_DBG, "LED状态: 全部关闭");
       break;
   }
 }
 
 void turnOffAllLEDs() {
-  digitalWrite(RED_LED_PIN, LOW);
-  digitalWrite(GREEN_LED_PIN, LOW);
-  digitalWrite(YELLOW_LED_PIN, LOW);
+  halDigitalWrite(RED_LED_PIN, LOW);
+  halDigitalWrite(GREEN_LED_PIN, LOW);
+  halDigitalWrite(YELLOW_LED_PIN, LOW);
 }
 
 // ==================== 水质评估主函数 ====================
-int evaluateWaterQuality(float pH, float turbidity, float tds, float ec) {
-  Serial.println("\n=== Water Quality Measurement ===");
-  Serial.print("pH: "); Serial.println(pH, 2);
-  Serial.print("Turbidity: "); Serial.print(turbidity, 1); Serial.println(" NTU");
-  Serial.print("TDS: "); Serial.print(tds, 0); Serial.println(" ppm");
-  Serial.print("Conductivity: "); Serial.print(ec, 0); Serial.println(" µS/cm");
-  
-  // 检查红灯条件 - 任何一个参数不合格就显示红灯
-  if (!isAcceptablepH(pH) || !isAcceptableTurbidity(turbidity) || 
-      !isAcceptableTDS(tds) || !isAcceptableEC(ec)) {
-    Serial.println("Assessment results: Unsafe to drink");
-    return RED_LED;
+void assessWaterQuality(const float values[PARAM_COUNT], WaterQualityAssessment& result) {
+  uint8_t overall = QUALITY_EXCELLENT;
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    const WaterQualityRule& rule = activeWaterQualityRules[i];
+    uint8_t grade = gradeParameter(rule.bands, rule.severity, values[i]);
+    result.grades[i] = grade;
+    overall = grade > overall ? grade : overall;
   }
-  
-  // 检查是否所有参数都优秀
-  if (isExcellentpH(pH) && isExcellentTurbidity(turbidity) && 
-      isExcellentTDS(tds) && isExcellentEC(ec)) {
-    Serial.println("Assessment results: Excellent to drink");
-    return GREEN_LED;
+  result.overall = overall;
+}
+
+uint8_t getParameterGrade(uint8_t param, float value) {
+  if (param >= PARAM_COUNT) {
+    return QUALITY_UNKNOWN;
   }
+  const WaterQualityRule& rule = activeWaterQualityRules[param];
+  return gradeParameter(rule.bands, rule.severity, value);
+}
+
+int evaluateWaterQuality(float pH, float turbidity, float tds, float ec) {
+  LOG_PRINTLN(LOG_DBG, "\n=== Water Quality Measurement ===");
+  LOG_PRINT(LOG_DBG, "pH: "); LOG_PRINTLN(LOG_DBG, pH, 2);
+  LOG_PRINT(LOG_DBG, "Turbidity: "); LOG_PRINT(LOG_DBG, turbidity, 1); LOG_PRINTLN(LOG_DBG, " NTU");
+  LOG_PRINT(LOG_DBG, "TDS: "); LOG_PRINT(LOG_DBG, tds, 0); LOG_PRINTLN(LOG_DBG, " ppm");
+  LOG_PRINT(LOG_DBG, "Conductivity: "); LOG_PRINT(LOG_DBG, ec, 0); LOG_PRINTLN(LOG_DBG, " µS/cm");
+  
+  const float values[PARAM_COUNT] = {pH, turbidity, tds, ec};
+  WaterQualityAssessment assessment;
+  assessWaterQuality(values, assessment);
   
-  // 其他情况显示黄灯
-  Serial.println("Assessment results: Marginal, acceptable to drink");
-  return YELLOW_LED;
+  LOG_PRINT(LOG_DBG, "Assessment results: "); LOG_PRINTLN(LOG_DBG, getWaterQualityName(assessment.overall));
+  return assessment.overall;
 }
 
 // ==================== 水质描述函数 ====================
-String getWaterQualityDescription(int ledStatus) {
-  switch(ledStatus) {
-    case GREEN_LED:
-      return "Status: EXCELLENT";
-    case YELLOW_LED:
-      return "Status: MARGINAL";
-    case RED_LED:
-      return "Status: UNSAFE";
-    default:
-      return "Status: UNKNOWN";
+// 等级名称表（常量，存放在Flash中）
+static const char* const WATER_QUALITY_NAMES[QUALITY_GRADE_COUNT] = {
+  "UNKNOWN", "EXCELLENT", "MARGINAL", "UNSAFE"
+};
+
+static const char* const WATER_QUALITY_DESCRIPTIONS[QUALITY_GRADE_COUNT] = {
+  "Status: UNKNOWN", "Status: EXCELLENT", "Status: MARGINAL", "Status: UNSAFE"
+};
+
+const char* getWaterQualityName(int grade) {
+  if (grade < 0 || grade >= QUALITY_GRADE_COUNT) {
+    grade = QUALITY_UNKNOWN;
   }
+  return WATER_QUALITY_NAMES[grade];
 }
 
-// ==================== pH检查函数 ====================
-bool isExcellentpH(float pH) {
-  return (pH >= PH_EXCELLENT_MIN && pH <= PH_EXCELLENT_MAX);
+const char* getWaterQualityDescriptionText(int grade) {
+  if (grade < 0 || grade >= QUALITY_GRADE_COUNT) {
+    grade = QUALITY_UNKNOWN;
+  }
+  return WATER_QUALITY_DESCRIPTIONS[grade];
+}
+
+String getWaterQualityDescription(int ledStatus) {
+  return String(getWaterQualityDescriptionText(ledStatus));
 }
 
-bool isAcceptablepH(float pH) {
-  return (pH >= PH_ACCEPTABLE_MIN && pH <= PH_ACCEPTABLE_MAX);
+// ==================== 阈值管理 ====================
+bool setParameterThresholds(uint8_t param, const ParameterThresholds& thresholds) {
+  if (param >= PARAM_COUNT) {
+    return false;
+  }
+  
+  // 优秀范围必须包含在可接受范围之内
+  if (thresholds.acceptableMin > thresholds.excellentMin ||
+      thresholds.excellentMin > thresholds.excellentMax ||
+      thresholds.excellentMax > thresholds.acceptableMax) {
+    return false;
+  }
+  
+  activeWaterQualityRules[param].bands = thresholds;
+  return true;
+}
+
+void resetParameterThresholds() {
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    activeWaterQualityRules[i] = WATER_QUALITY_PROFILES[activeProfile].rules[i];
+  }
 }
 
-// ==================== 浊度检查函数 ====================
-bool isExcellentTurbidity(float turbidity) {
-  return (turbidity >= 0 && turbidity <= TURBIDITY_EXCELLENT_MAX);
+// ==================== 监管配置 ====================
+bool setWaterQualityProfile(uint8_t profile, bool persist) {
+  if (profile >= PROFILE_COUNT) {
+    return false;
+  }
+  
+  activeProfile = profile;
+  resetParameterThresholds();
+  
+  LOG_PRINT(LOG_INF, "水质标准配置: ");
+  LOG_PRINTLN(LOG_INF, WATER_QUALITY_PROFILES[profile].name);
+  
+  if (persist) {
+    // 只在配置变化时擦写Flash
+    WaterQualityProfileRecord record = waterQualityProfileStore.read();
+    if (record.magic != PROFILE_RECORD_MAGIC || record.profile != profile) {
+      record.magic = PROFILE_RECORD_MAGIC;
+      record.profile = profile;
+      waterQualityProfileStore.write(record);
+    }
+  }
+  return true;
 }
 
-bool isAcceptableTurbidity(float turbidity) {
-  return (turbidity >= 0 && turbidity <= TURBIDITY_ACCEPTABLE_MAX);
+void loadWaterQualityProfile() {
+  WaterQualityProfileRecord record = waterQualityProfileStore.read();
+  if (record.magic == PROFILE_RECORD_MAGIC && record.profile < PROFILE_COUNT) {
+    setWaterQualityProfile(record.profile, false);
+  } else {
+    setWaterQualityProfile(DEFAULT_WATER_QUALITY_PROFILE, false);
+  }
 }
 
-// ==================== TDS检查函数 ====================
-bool isExcellentTDS(float tds) {
-  return (tds >= TDS_EXCELLENT_MIN && tds <= TDS_EXCELLENT_MAX);
+uint8_t getWaterQualityProfile() {
+  return activeProfile;
 }
 
-bool isAcceptableTDS(float tds) {
-  return (tds >= TDS_ACCEPTABLE_MIN && tds <= TDS_ACCEPTABLE_MAX);
+const char* getWaterQualityProfileName(uint8_t profile) {
+  if (profile >= PROFILE_COUNT) {
+    return "unknown";
+  }
+  return WATER_QUALITY_PROFILES[profile].name;
 }
 
-// ==================== 电导率检查函数 ====================
-bool isExcellentEC(float ec) {
-  return (ec >= EC_EXCELLENT_MIN && ec <= EC_EXCELLENT_MAX);
+int findWaterQualityProfile(const char* name) {
+  for (int i = 0; i < PROFILE_COUNT; i++) {
+    if (strcmp(WATER_QUALITY_PROFILES[i].name, name) == 0) {
+      return i;
+    }
+  }
+  return -1;
 }
 
-bool isAcceptableEC(float ec) {
-  return (ec >= EC_ACCEPTABLE_MIN && ec <= EC_ACCEPTABLE_MAX);
-}
\ No newline at end of file
+void printWaterQualityProfiles() {
+  static const char* const PARAMETER_LABELS[PARAM_COUNT] = {"pH", "浊度", "TDS", "电导率"};
+  
+  for (int p = 0; p < PROFILE_COUNT; p++) {
+    Serial.print(p == activeProfile ? "* " : "  ");
+    Serial.print(p);
+    Serial.print(" ");
+    Serial.println(WATER_QUALITY_PROFILES[p].name);
+    
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      // 当前配置显示运行时阈值（可能被下行命令修改过）
+      const WaterQualityRule& rule = (p == activeProfile) ? activeWaterQualityRules[i]
+                                                           : WATER_QUALITY_PROFILES[p].rules[i];
+      Serial.print("    ");
+      Serial.print(PARAMETER_LABELS[i]);
+      Serial.print(": 优秀 ");
+      Serial.print(rule.bands.excellentMin, 1);
+      Serial.print("-");
+      Serial.print(rule.bands.excellentMax, 1);
+      Serial.print(", 可接受 ");
+      Serial.print(rule.bands.acceptableMin, 1);
+      Serial.print("-");
+      Serial.print(rule.bands.acceptableMax, 1);
+      Serial.print(" ");
+      Serial.println(WATER_PARAMETER_INFO[i].unit);
+    }
+  }
+}
@@ -9,6 +9,7 @@
 #define WATER_QUALITY_LED_H
 
 #include <Arduino.h>
+#include "WaterQualityRules.h"
 
 // ==================== LED引脚定义 ====================
 #define RED_LED_PIN     0   // D0引脚 - 红色LED (不适合饮用)
@@ -21,28 +22,18 @@
 #define YELLOW_LED      2   // 一般 - 勉强可接受
 #define RED_LED         3   // 不安全 - 不适合饮用
 
-// ==================== 水质标准参数 ====================
-// pH标准
-#define PH_EXCELLENT_MIN    6.5
-#define PH_EXCELLENT_MAX    8.0
-#define PH_ACCEPTABLE_MIN   6.0
-#define PH_ACCEPTABLE_MAX   9.0
+static_assert(QUALITY_EXCELLENT == GREEN_LED && QUALITY_MARGINAL == YELLOW_LED &&
+              QUALITY_UNSAFE == RED_LED, "水质等级与LED状态需一一对应");
 
-// 浊度标准 (NTU)
-#define TURBIDITY_EXCELLENT_MAX     1.0
-#define TURBIDITY_ACCEPTABLE_MAX    4.0
+// ==================== 运行时规则 ====================
+// 当前监管配置（WaterQualityRules.h）的规则副本，阈值可通过下行命令修改
+extern WaterQualityRule activeWaterQualityRules[PARAM_COUNT];
 
-// TDS标准 (ppm)
-#define TDS_EXCELLENT_MIN       80
-#define TDS_EXCELLENT_MAX       300
-#define TDS_ACCEPTABLE_MIN      50
-#define TDS_ACCEPTABLE_MAX      500
-
-// 电导率标准 (µS/cm)
-#define EC_EXCELLENT_MIN        100
-#define EC_EXCELLENT_MAX        400
-#define EC_ACCEPTABLE_MIN       50
-#define EC_ACCEPTABLE_MAX       800
+// 一次评估的结果：各参数等级和总体等级
+struct WaterQualityAssessment {
+  uint8_t overall;
+  uint8_t grades[PARAM_COUNT];
+};
 
 // ==================== 函数声明 ====================
 // LED初始化和控制
@@ -51,17 +42,24 @@ void setLEDStatus(int ledStatus);
 void turnOffAllLEDs();
 
 // 水质评估
+// values 按 WaterParameter 顺序排列，一次遍历得到各参数等级和总体等级
+void assessWaterQuality(const float values[PARAM_COUNT], WaterQualityAssessment& result);
+uint8_t getParameterGrade(uint8_t param, float value);
 int evaluateWaterQuality(float pH, float turbidity, float tds, float ec);
-String getWaterQualityDescription(int ledStatus);
+const char* getWaterQualityName(int grade);         // "EXCELLENT" / "MARGINAL" / "UNSAFE" / "UNKNOWN"
+const char* getWaterQualityDescriptionText(int grade);  // "Status: EXCELLENT" 等
+String getWaterQualityDescription(int ledStatus);   // 仅供调试，运行路径请用上面两个函数
+
+// 阈值管理
+bool setParameterThresholds(uint8_t param, const ParameterThresholds& thresholds);
+void resetParameterThresholds();                    // 恢复当前配置的阈值
 
-// 参数检查函数
-bool isExcellentpH(float pH);
-bool isAcceptablepH(float pH);
-bool isExcellentTurbidity(float turbidity);
-bool isAcceptableTurbidity(float turbidity);
-bool isExcellentTDS(float tds);
-bool isAcceptableTDS(float tds);
-bool isExcellentEC(float ec);
-bool isAcceptableEC(float ec);
+// 监管配置（选择保存在Flash中，上电由 loadWaterQualityProfile() 恢复）
+bool setWaterQualityProfile(uint8_t profile, bool persist);
+void loadWaterQualityProfile();
+uint8_t getWaterQualityProfile();
+const char* getWaterQualityProfileName(uint8_t profile);
+int findWaterQualityProfile(const char* name);      // 未找到返回 -1
+void printWaterQualityProfiles();
 
 #endif // WATER_QUALITY_LED_H
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * WaterQualityRules.h - 水质分级规则表
+ *
+ * 每个监管配置为每个参数定一条规则：优秀范围、可接受范围和超出可接受范围时的严重程度。
+ * 这张表是分级阈值的唯一来源：固件用它初始化运行时阈值，
+ * 主机端 water_rulegen 用它生成仪表盘的 utils/waterQualityRules.generated.js
+ *
+ * 修改规则后重新生成 JS：
+ *   build-host/water_rulegen --out utils/waterQualityRules.generated.js
+ *
+ * 本文件不依赖 Arduino 库，主机端工具可以直接包含
+ */
+
+#ifndef WATER_QUALITY_RULES_H
+#define WATER_QUALITY_RULES_H
+
+#include <stdint.h>
+
+// 水质等级（数值与LED状态相同，evaluateWaterQuality的返回值可直接使用）
+// 等级越高越差，多个参数的总体等级取最大值
+enum WaterQualityGrade {
+  QUALITY_UNKNOWN   = 0,
+  QUALITY_EXCELLENT = 1,
+  QUALITY_MARGINAL  = 2,
+  QUALITY_UNSAFE    = 3,
+  QUALITY_GRADE_COUNT
+};
+
+enum WaterParameter {
+  PARAM_PH = 0,
+  PARAM_TURBIDITY,
+  PARAM_TDS,
+  PARAM_EC,
+  PARAM_COUNT
+};
+
+// 闭区间 [min, max]；优秀范围必须包含在可接受范围之内
+struct ParameterThresholds {
+  float excellentMin;
+  float excellentMax;
+  float acceptableMin;
+  float acceptableMax;
+};
+
+struct WaterQualityRule {
+  ParameterThresholds bands;
+  uint8_t severity;              // 该参数最多能把总体等级拉低到哪一级
+};
+
+// 仪表盘字段名和单位，顺序与 WaterParameter 一致
+struct WaterParameterInfo {
+  const char* key;
+  const char* unit;
+};
+
+constexpr WaterParameterInfo WATER_PARAMETER_INFO[PARAM_COUNT] = {
+  {"ph", ""}, {"turbidity", "NTU"}, {"tds", "ppm"}, {"conductivity", "µS/cm"}
+};
+
+// ==================== 监管配置 ====================
+// 不同场所使用不同的限值，全部编译进Flash；
+// id 随上行数据发送，后端据此重新解释读数，已分配的 id 不能改变含义
+enum WaterQualityProfileId {
+  PROFILE_DRINKING = 0,          // WHO/EPA 饮用水（出厂默认）
+  PROFILE_BOTTLED,               // 瓶装水：浊度更严，允许纯净水的低矿物质
+  PROFILE_RECREATIONAL,          // 游泳/娱乐用水：矿物质只影响舒适度，最多黄灯
+  PROFILE_IN_HOUSE,              // 内部严格标准
+  PROFILE_COUNT
+};
+
+#define DEFAULT_WATER_QUALITY_PROFILE PROFILE_DRINKING
+
+struct WaterQualityProfile {
+  const char* name;              // 串口命令使用的名称（小写）
+  WaterQualityRule rules[PARAM_COUNT];
+};
+
+// ==================== 规则表 ====================
+// 每个配置的规则顺序与 WaterParameter 一致：
+//   {{优秀下限, 优秀上限, 可接受下限, 可接受上限}, 严重程度}
+constexpr WaterQualityProfile WATER_QUALITY_PROFILES[PROFILE_COUNT] = {
+  {"drinking", {
+    {{6.5f,   8.0f,    6.0f,   9.0f},    QUALITY_UNSAFE},     // pH
+    {{0.0f,   1.0f,    0.0f,   4.0f},    QUALITY_UNSAFE},     // 浊度 NTU
+    {{80.0f,  300.0f,  50.0f,  500.0f},  QUALITY_UNSAFE},     // TDS ppm
+    {{100.0f, 400.0f,  50.0f,  800.0f},  QUALITY_UNSAFE},     // 电导率 µS/cm
+  }},
+  {"bottled", {
+    {{6.5f,   8.0f,    6.0f,   8.5f},    QUALITY_UNSAFE},
+    {{0.0f,   0.5f,    0.0f,   1.0f},    QUALITY_UNSAFE},
+    {{50.0f,  250.0f,  10.0f,  500.0f},  QUALITY_UNSAFE},
+    {{50.0f,  400.0f,  10.0f,  800.0f},  QUALITY_UNSAFE},
+  }},
+  {"recreational", {
+    {{7.2f,   7.8f,    6.5f,   8.5f},    QUALITY_UNSAFE},
+    {{0.0f,   1.0f,    0.0f,   5.0f},    QUALITY_UNSAFE},
+    {{0.0f,   1000.0f, 0.0f,   2000.0f}, QUALITY_MARGINAL},
+    {{0.0f,   1500.0f, 0.0f,   3000.0f}, QUALITY_MARGINAL},
+  }},
+  {"inhouse", {
+    {{6.8f,   7.8f,    6.5f,   8.5f},    QUALITY_UNSAFE},
+    {{0.0f,   0.3f,    0.0f,   1.0f},    QUALITY_UNSAFE},
+    {{100.0f, 250.0f,  80.0f,  300.0f},  QUALITY_UNSAFE},
+    {{150.0f, 400.0f,  100.0f, 500.0f},  QUALITY_UNSAFE},
+  }},
+};
+
+// 出厂默认配置的规则
+constexpr const WaterQualityRule* WATER_QUALITY_RULES = WATER_QUALITY_PROFILES[DEFAULT_WATER_QUALITY_PROFILE].rules;
+
+// ==================== 编译期检查 ====================
+constexpr bool isValidThresholds(const ParameterThresholds& t) {
+  return t.acceptableMin <= t.excellentMin && t.excellentMin <= t.excellentMax &&
+         t.excellentMax <= t.acceptableMax;
+}
+
+constexpr bool isValidRule(const WaterQualityRule& rule) {
+  return isValidThresholds(rule.bands) &&
+         rule.severity >= QUALITY_EXCELLENT && rule.severity <= QUALITY_UNSAFE;
+}
+
+constexpr bool isValidProfile(int profile, int param = 0) {
+  return param >= PARAM_COUNT ||
+         (isValidRule(WATER_QUALITY_PROFILES[profile].rules[param]) && isValidProfile(profile, param + 1));
+}
+
+constexpr bool isValidProfileTable(int profile = 0) {
+  return profile >= PROFILE_COUNT ||
+         (isValidProfile(profile) && isValidProfileTable(profile + 1));
+}
+
+static_assert(sizeof(WATER_QUALITY_PROFILES) / sizeof(WATER_QUALITY_PROFILES[0]) == PROFILE_COUNT,
+              "每个监管配置需要一组规则");
+static_assert(isValidProfileTable(), "规则表的优秀范围必须包含在可接受范围之内");
+
+// ==================== 单参数分级 ====================
+// 优秀 → 1，仅可接受 → 2，超出可接受 → 3，再以 severity 封顶；
+// 用按位与代替短路求值，循环体内没有分支。NaN 不在任何范围内，按超出处理
+inline uint8_t gradeParameter(const ParameterThresholds& t, uint8_t severity, float value) {
+  uint8_t excellent = (uint8_t)(value >= t.excellentMin) & (uint8_t)(value <= t.excellentMax);
+  uint8_t acceptable = (uint8_t)(value >= t.acceptableMin) & (uint8_t)(value <= t.acceptableMax);
+  uint8_t grade = QUALITY_EXCELLENT + (excellent ^ 1) + (acceptable ^ 1);
+  return grade < severity ? grade : severity;
+}
+
+#endif // WATER_QUALITY_RULES_H
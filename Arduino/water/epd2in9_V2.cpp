@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include "epd2in9_V2.h"
+#include "Perf.h"
 
 unsigned char _WF_PARTIAL_2IN9[159] =
 {
@@ -262,6 +263,7 @@ void Epd::SendData(unsigned char data) {
  *  @brief: Wait until the busy_pin goes LOW
  */
 void Epd::WaitUntilIdle(void) {
+    PERF_SCOPE(PERF_WAIT_UNTIL_IDLE);
 	while(1) {	 //=1 BUSY
 		if(DigitalRead(busy_pin)==LOW) 
 			break;
@@ -295,6 +297,7 @@ void Epd::SetFrameMemory(
     int image_width,
     int image_height
 ) {
+    PERF_SCOPE(PERF_SET_FRAME_MEMORY);
     int x_end;
     int y_end;
 
@@ -414,6 +417,7 @@ void Epd::SetFrameMemory_Partial(
  *          from the flash).
  */
 void Epd::SetFrameMemory(const unsigned char* image_buffer) {
+    PERF_SCOPE(PERF_SET_FRAME_MEMORY);
     SetMemoryArea(0, 0, this->width - 1, this->height - 1);
     SetMemoryPointer(0, 0);
     SendCommand(0x24);
@@ -553,6 +557,7 @@ void Epd::Display4Gray(const unsigned char *Image)
  *          set the other memory area.
  */
 void Epd::DisplayFrame(void) {
+    PERF_SCOPE(PERF_DISPLAY_FRAME);
     SendCommand(0x22);
     SendData(0xc7);
     SendCommand(0x20);
@@ -9,7 +9,7 @@
  */
 
 #include "epdif.h"
-#include <SPI.h>
+#include "Hal.h"
 
 // MKR WAN1310的E-Paper连接引脚定义
 #define CS_PIN          7
@@ -24,38 +24,36 @@ EpdIf::~EpdIf() {
 };
 
 void EpdIf::DigitalWrite(int pin, int value) {
-    digitalWrite(pin, value);
+    halDigitalWrite(pin, value);
 }
 
 int EpdIf::DigitalRead(int pin) {
-    return digitalRead(pin);
+    return halDigitalRead(pin);
 }
 
 void EpdIf::DelayMs(unsigned int delaytime) {
-    delay(delaytime);
+    halDelay(delaytime);
 }
 
 void EpdIf::SpiTransfer(unsigned char data) {
-    digitalWrite(CS_PIN, LOW);
-    SPI.transfer(data);
-    digitalWrite(CS_PIN, HIGH);
+    halDigitalWrite(CS_PIN, LOW);
+    halSpiTransfer(data);
+    halDigitalWrite(CS_PIN, HIGH);
 }
 
 int EpdIf::IfInit(void) {
     // 初始化SPI引脚
-    pinMode(CS_PIN, OUTPUT);
-    pinMode(RST_PIN, OUTPUT);  
-    pinMode(DC_PIN, OUTPUT);
-    pinMode(BUSY_PIN, INPUT);
+    halPinMode(CS_PIN, OUTPUT);
+    halPinMode(RST_PIN, OUTPUT);  
+    halPinMode(DC_PIN, OUTPUT);
+    halPinMode(BUSY_PIN, INPUT);
     
-    // 初始化SPI接口
-    SPI.begin();
-    SPI.beginTransaction(SPISettings(2000000, MSBFIRST, SPI_MODE0));
+    // 初始化SPI接口（2MHz，模式0，见 HalArduino.cpp）
+    halSpiBegin();
     
     return 0;
 }
 
 void EpdIf::IfEnd(void) {
-    SPI.endTransaction();
-    SPI.end();
+    halSpiEnd();
 }
\ No newline at end of file
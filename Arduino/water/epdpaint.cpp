@@ -26,6 +26,7 @@
 
 #include <avr/pgmspace.h>
 #include "epdpaint.h"
+#include "Perf.h"
 
 Paint::Paint(unsigned char* image, int width, int height) {
     this->rotate = ROTATE_0;
@@ -42,6 +43,7 @@ Paint::~Paint() {
  *  @brief: clear the image
  */
 void Paint::Clear(int colored) {
+    PERF_SCOPE(PERF_PAINT);
     for (int x = 0; x < this->width; x++) {
         for (int y = 0; y < this->height; y++) {
             DrawAbsolutePixel(x, y, colored);
@@ -166,6 +168,7 @@ void Paint::DrawCharAt(int x, int y, char ascii_char, sFONT* font, int colored)
 *  @brief: this displays a string on the frame buffer but not refresh
 */
 void Paint::DrawStringAt(int x, int y, const char* text, sFONT* font, int colored) {
+    PERF_SCOPE(PERF_PAINT);
     const char* p_text = text;
     unsigned int counter = 0;
     int refcolumn = x;
@@ -1,14 +1,53 @@
 // ==================== 文件3：Arduino/water/water.ino ====================
 /**
- * water.ino - 水质监测系统主程序 (禁用LoRA自动发送版)
+ * water.ino - 水质监测系统主程序
  * 
- * 包含LED三色指示水质状态功能
+ * 包含LED三色指示水质状态功能；LoRa自动发送默认关闭，
+ * 可通过 autosend 命令或下行命令 0x02 开启
  */
 
+#define LOG_MODULE LOG_MOD_SYSTEM
+
 #include "WaterMonitor.h"
+#include "WaterQualityLED.h"
+
+// ==================== 本文件函数声明 ====================
+// Arduino IDE 会自动生成这些原型，主机构建（Arduino/host）直接按C++编译本文件
+void initializeSimpleSystem();
+void initializeTasks();
+void taskButton();
+void taskSensors();
+void taskDisplay();
+void taskLoRa();
+void taskSerial();
+void taskLog();
+void checkAutoSend();
+void handleSimpleSerialCommands();
+void printSimpleSystemStatus();
+void requestMeasurement(uint8_t request);
+
+// 采集完成后要做的事；采集期间到达的请求合并到同一次采集
+enum MeasurementRequest {
+  MEAS_REQUEST_TEST   = 1 << 0,   // 完整检测：显示、上传、日志
+  MEAS_REQUEST_UPLOAD = 1 << 1,   // 只上传（send 命令、自动发送）
+  MEAS_REQUEST_LED    = 1 << 2    // 只更新LED（led 命令）
+};
+uint8_t measurementRequests = 0;
+
+// 采集完成后等待LoRa任务上传；保存副本，上传前再次采集也不会改变待发数据
+bool uploadPending = false;
+bool uploadShowsProgress = false;   // 完整检测的上传结果显示在屏幕上
+Measurement pendingUpload;
+
+// 触发检测的时间（micros），用于统计触发到显示结果的总耗时
+unsigned long testTriggeredUs = 0;
+bool testTimingOpen = false;
 
 void setup() {
+  // 最先填充栈，setup() 期间的栈深度也能被统计
+  initializeMemoryStats();
   Serial.begin(115200);
+  TRACE(TRACE_BOOT, 0, 0);
   
   // 等待串口
   unsigned long startTime = millis();
@@ -17,7 +56,7 @@ void setup() {
   }
   
   Serial.println("\n=================================");
-  Serial.println("   水质监测系统 v2.3 (手动版)     ");
+  Serial.println("   水质监测系统 v2.3              ");
   Serial.println("=================================");
   
   // 初始化系统
@@ -26,142 +65,445 @@ void setup() {
   Serial.println("\n系统启动完成!");
   Serial.println("按下按钮开始水质检测");
   Serial.println("LED指示: 绿灯=优秀 黄灯=一般 红灯=不安全");
-  Serial.println("⚠️  LoRa自动发送已禁用，仅手动触发");
+  Serial.println(autoSendEnabled ? "LoRa自动发送: 开启" : "⚠️  LoRa自动发送: 关闭（send 命令手动发送，autosend on 开启）");
   Serial.println("---------------------------------");
+
+  recordSetupStackUsage();
 }
 
 void loop() {
-  // 处理按钮输入
+  // 运行一个就绪任务；没有就绪任务时休眠到下一个任务到期，
+  // 长时间无操作则进入STANDBY，由按钮中断唤醒
+  if (!runScheduler()) {
+    if (shouldEnterStandby()) {
+      enterSleepMode();
+    } else {
+      schedulerIdle();
+    }
+  }
+}
+
+// ==================== 任务注册 ====================
+void initializeTasks() {
+  addTask(TASK_BUTTON,  "button",  taskButton,  TASK_EVENT_ONLY);  // 由按钮中断触发
+  addTask(TASK_SENSORS, "sensors", taskSensors, TASK_EVENT_ONLY);
+  addTask(TASK_DISPLAY, "display", taskDisplay, TASK_EVENT_ONLY);
+  addTask(TASK_LORA,    "lora",    taskLoRa,    LORA_POLL_INTERVAL);
+  addTask(TASK_SAMPLING, "sampling", taskSampling, SAMPLING_POLL_INTERVAL);
+  addTask(TASK_SERIAL,  "serial",  taskSerial,  SERIAL_POLL_INTERVAL);
+  addTask(TASK_LOG,     "log",     taskLog,     TASK_EVENT_ONLY);
+  addTask(TASK_TRACE,   "trace",   taskTrace,   TRACE_DRAIN_INTERVAL);
+}
+
+// ==================== 任务函数 ====================
+void taskButton() {
   handleButtonInput();
+}
+
+void taskSensors() {
+  static unsigned long startUs = 0;
+  
+  // 第一次运行开始采集，之后按稳定检测间隔周期运行，每次为各探头取一个点
+  if (!isAcquisitionActive()) {
+    recordMeasurementStart();
+    LOG_PRINTLN(LOG_INF, "\n>>> 开始水质检测 <<<");
+    startUs = micros();
+    startAcquisition();
+    setTaskPeriod(TASK_SENSORS, SETTLE_INTERVAL_MS);
+  }
+  if (!pollAcquisition()) {
+    return;
+  }
+  setTaskPeriod(TASK_SENSORS, TASK_EVENT_ONLY);
+  
+  // 全部探头稳定或超时：分级一次并更新LED
+  const Measurement& m = finishAcquisition();
+  TRACE(TRACE_SENSORS_DONE, m.assessment.overall, micros() - startUs);
+  
+  // 按钮、定时采样等直接触发的检测没有请求标志，按完整检测处理
+  bool periodic = isPeriodicSampleActive();
+  uint8_t requests = measurementRequests;
+  measurementRequests = 0;
+  if (requests == 0 || periodic) {
+    requests |= MEAS_REQUEST_TEST;
+  }
+  bool fullTest = (requests & MEAS_REQUEST_TEST) != 0;
   
-  // 只处理LoRa接收消息，不自动发送
-  if (loraConnected) {
-    handleLoRaReceiveOnly();  // 使用新的只接收函数
+  // 采集完成后分别触发显示、上传和日志任务
+  // 定时采样只在水质等级变化时刷新E-Paper
+  if (fullTest && (!periodic || displayNeedsRefresh())) {
+    signalTask(TASK_DISPLAY);
+  }
+  if (requests & (MEAS_REQUEST_TEST | MEAS_REQUEST_UPLOAD)) {
+    if (loraConnected) {
+      pendingUpload = m;
+      uploadPending = true;
+      uploadShowsProgress = fullTest;
+      signalTask(TASK_LORA);
+    } else if (periodic) {
+      // 离线时先缓存，联网后补发
+      queueLoRaBacklog(packWaterQualityData(m));
+    }
+  }
+  if (fullTest) {
+    signalTask(TASK_LOG);
+  }
+  if (requests & MEAS_REQUEST_LED) {
+    Serial.println("LED状态已更新");
   }
   
-  // 处理简单串口命令
-  handleSimpleSerialCommands();
+  finishPeriodicSample();
+}
+
+// 请求一次采集，由检测任务非阻塞地完成
+void requestMeasurement(uint8_t request) {
+  measurementRequests |= request;
+  signalTask(TASK_SENSORS);
+}
+
+void taskDisplay() {
+  unsigned long startUs = micros();
+  updateWaterQualityDisplay(getLatestMeasurement());
+  TRACE(TRACE_DISPLAY_DONE, 0, micros() - startUs);
+  markDisplayRefreshed();
+  
+  if (testTimingOpen) {
+    testTimingOpen = false;
+    perfRecord(PERF_PRESS_TO_RESULT, micros() - testTriggeredUs);
+  }
+}
+
+void taskLoRa() {
+  // 检测结果上传
+  if (uploadPending) {
+    uploadPending = false;
+    LOG_PRINTLN(LOG_INF, "发送数据到云端...");
+    if (sendWaterQualityData(pendingUpload)) {
+      LOG_PRINTLN(LOG_INF, "✓ 数据已上传到TTN");
+      if (uploadShowsProgress) {
+        displayProgress("Cloud: OK");
+      }
+      // 链路恢复后顺带补发之前缓存的数据
+      if (getLoRaBacklogCount() > 0) {
+        backlogFlushRequested = true;
+        signalTask(TASK_LORA);
+      }
+    } else {
+      LOG_PRINTLN(LOG_ERR, "✗ 云端上传失败");
+      if (uploadShowsProgress) {
+        displayProgress("Cloud: Failed");
+      }
+    }
+    return;
+  }
   
-  // 禁用自动发送检查
-  // checkAutoSend();  // 注释掉这行
+  // 离线时后台重新入网，连上后补发离线期间缓存的数据
+  if (maintainLoRaConnection() && getLoRaBacklogCount() > 0) {
+    backlogFlushRequested = true;
+  }
   
-  delay(100);
+  // 只处理LoRa接收消息和补发
+  if (loraConnected) {
+    handleLoRaReceiveOnly();
+  }
+  
+  // 自动发送检查（默认关闭，可通过串口或下行命令开启）
+  checkAutoSend();
+}
+
+void taskSerial() {
+  handleSimpleSerialCommands();
+}
+
+void taskLog() {
+  printAllReadings(getLatestMeasurement());
+  LOG_PRINTLN(LOG_INF, ">>> 水质检测完成 <<<\n");
 }
 
 // ==================== 简化的系统初始化 ====================
 void initializeSimpleSystem() {
-  Serial.println("开始系统初始化...");
+  LOG_PRINTLN(LOG_INF, "开始系统初始化...");
   
-  // 1. 初始化传感器（包含LED初始化）
+  // 1. 初始化传感器（包含LED初始化），恢复上次选择的水质标准
   initializeSensors();
-  delay(1000);
+  loadWaterQualityProfile();
   
   // 2. 初始化E-Paper显示
   initializeEPaper();
-  delay(1000);
   
   // 3. 初始化按钮控制
   initializeButton();
-  delay(500);
   
   // 4. 尝试初始化LoRa（不强制要求成功）
-  Serial.println("尝试初始化LoRa...");
+  LOG_PRINTLN(LOG_INF, "尝试初始化LoRa...");
   if (initializeLoRa() && connectToNetwork()) {
-    Serial.println("✓ LoRa初始化成功!");
-    Serial.println("⚠️  自动发送已禁用，只能手动发送");
+    LOG_PRINTLN(LOG_INF, "✓ LoRa初始化成功!");
+    if (!autoSendEnabled) {
+      LOG_PRINTLN(LOG_WRN, "⚠️  自动发送已关闭，只能手动发送");
+    }
   } else {
-    Serial.println("⚠ LoRa初始化失败，系统在离线模式下运行");
+    LOG_PRINTLN(LOG_WRN, "⚠ LoRa初始化失败，系统在离线模式下运行");
   }
   
   // 5. 显示启动界面
   showStartupScreen();
   
-  // 6. 系统准备就绪
+  // 6. 注册调度任务
+  initializeTasks();
+  
+  // 7. 配置按钮唤醒、低功耗待机和定时采样
+  initializePowerManager();
+  initializeSampling();
+  
+  // 8. 系统准备就绪
   setSystemReady(true);
   
-  Serial.println("✓ 系统初始化完成!");
+  LOG_PRINTLN(LOG_INF, "✓ 系统初始化完成!");
 }
 
 // ==================== 水质检测主流程 ====================
+// 检测流程拆分为采集、显示、上传、日志四个任务，这里只负责触发
 void performWaterQualityTest() {
-  Serial.println("\n>>> 开始水质检测 <<<");
-  
-  // 读取所有传感器（包含LED更新）
-  readAllSensors();
-  
-  // 更新显示
-  updateWaterQualityDisplay();
-  
-  // 打印读数
-  printAllReadings();
-  
-  // 如果LoRa可用，发送到云端
-  if (loraConnected) {
-    Serial.println("发送数据到云端...");
-    if (sendWaterQualityData()) {
-      Serial.println("✓ 数据已上传到TTN");
-      displayProgress("Cloud: OK");
+  notePowerActivity();
+  testTriggeredUs = micros();
+  testTimingOpen = true;
+  TRACE(TRACE_TEST_TRIGGER, 0, 0);
+  requestMeasurement(MEAS_REQUEST_TEST);
+}
+
+// ==================== 串口命令 ====================
+static void cmdTest(const CommandArgs&) {
+  performWaterQualityTest();
+}
+
+static void cmdStatus(const CommandArgs&) {
+  printSimpleSystemStatus();
+}
+
+static void cmdLed(const CommandArgs&) {
+  // 手动更新LED显示，采集完成后由检测任务确认
+  requestMeasurement(MEAS_REQUEST_LED);
+  Serial.println("采集中，探头稳定后更新LED...");
+}
+
+static void cmdTasks(const CommandArgs&) {
+  printSchedulerStatus();
+}
+
+static void cmdPerf(const CommandArgs& args) {
+  if (argEquals(args, 0, "reset")) {
+    resetPerfStats();
+    Serial.println("✓ 耗时统计已清零");
+  } else {
+    printPerfStats();
+  }
+}
+
+static void cmdMem(const CommandArgs&) {
+  printMemoryStats();
+}
+
+static void cmdTrace(const CommandArgs& args) {
+  bool enable;
+  if (parseOnOffArg(args, 0, enable)) {
+    // 开启后串口会混入二进制帧，用 trace-decode.js 解码
+    enableTraceOutput(enable);
+  } else {
+    printTraceStatus();
+  }
+}
+
+static void cmdLog(const CommandArgs& args) {
+  if (args.count == 0) {
+    printLogLevels();
+    return;
+  }
+
+  // log <级别> 设置全部模块，log <模块> <级别> 设置单个模块
+  int level = findLogLevel(args.values[args.count - 1]);
+  int module = (args.count >= 2) ? findLogModule(args.values[0]) : -1;
+  if (level < 0 || (args.count >= 2 && module < 0)) {
+    Serial.println("✗ 用法: log [模块] debug|info|warn|error|off");
+    return;
+  }
+  if (module >= 0) {
+    setModuleLogLevel(module, level);
+  } else {
+    setLogLevel(level);
+  }
+}
+
+static void cmdPower(const CommandArgs&) {
+  printPowerStatus();
+}
+
+static void cmdStandby(const CommandArgs& args) {
+  bool enable;
+  if (!parseOnOffArg(args, 0, enable)) {
+    Serial.println("✗ 用法: standby on|off");
+    return;
+  }
+  standbyEnabled = enable;
+  Serial.println(enable ? "✓ 低功耗待机已开启" : "✓ 低功耗待机已关闭");
+}
+
+static void cmdPeriodic(const CommandArgs& args) {
+  bool enable;
+  unsigned long minutes;
+  if (parseOnOffArg(args, 0, enable)) {
+    enablePeriodicSampling(enable);
+  } else if (parseUnsignedArg(args, 0, minutes)) {
+    // 先按分钟检查上限，避免乘法溢出后落入有效范围
+    if (minutes <= SAMPLING_INTERVAL_MAX / 60000UL && setSamplingInterval(minutes * 60000UL)) {
+      Serial.print("✓ 采样间隔已设置为 ");
+      Serial.print(minutes);
+      Serial.println(" 分钟");
     } else {
-      Serial.println("✗ 云端上传失败");
-      displayProgress("Cloud: Failed");
+      Serial.println("✗ 采样间隔超出范围 (1 - 1440 分钟)");
     }
+  } else {
+    printSamplingStatus();
+  }
+}
+
+static void cmdSend(const CommandArgs&) {
+  if (!loraConnected) {
+    Serial.println("✗ LoRa未连接");
+    return;
+  }
+  // 上传结果由LoRa任务输出
+  requestMeasurement(MEAS_REQUEST_UPLOAD);
+  Serial.println("采集中，探头稳定后发送...");
+}
+
+static void cmdAutoSend(const CommandArgs& args) {
+  bool enable;
+  if (!parseOnOffArg(args, 0, enable)) {
+    Serial.println("✗ 用法: autosend on|off");
+    return;
+  }
+  enableAutoSend(enable);
+}
+
+static void cmdInterval(const CommandArgs& args) {
+  unsigned long seconds;
+  if (!parseUnsignedArg(args, 0, seconds) ||
+      seconds < DL_MIN_UPLINK_INTERVAL || seconds > DL_MAX_UPLINK_INTERVAL) {
+    Serial.println("✗ 用法: interval <秒> (60 - 86400)");
+    return;
+  }
+  setLoRaSendInterval(seconds * 1000UL);
+}
+
+static void cmdFormat(const CommandArgs& args) {
+  if (argEquals(args, 0, "legacy")) {
+    setPayloadFormat(PAYLOAD_FORMAT_LEGACY);
+  } else if (argEquals(args, 0, "redundant")) {
+    setPayloadFormat(PAYLOAD_FORMAT_REDUNDANT);
+  } else {
+    Serial.println("✗ 用法: format legacy|redundant");
+  }
+}
+
+static void cmdProfile(const CommandArgs& args) {
+  if (args.count == 0) {
+    printWaterQualityProfiles();
+    return;
   }
   
-  Serial.println(">>> 水质检测完成 <<<\n");
+  unsigned long id;
+  int profile = findWaterQualityProfile(args.values[0]);
+  if (profile < 0 && parseUnsignedArg(args, 0, id)) {
+    profile = (int)id;
+  }
+  if (profile < 0 || !setWaterQualityProfile((uint8_t)profile, true)) {
+    Serial.println("✗ 用法: profile [drinking|bottled|recreational|inhouse|<id>]");
+  }
 }
 
-// ==================== 简化的串口命令处理（增强版） ====================
-void handleSimpleSerialCommands() {
-  if (Serial.available()) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-    command.toLowerCase();
+static void cmdSamples(const CommandArgs& args) {
+  if (args.count == 0) {
+    printOversampleCounts();
+    return;
+  }
+  
+  // samples <次数> 设置全部探头，samples <探头> <次数> 设置单个探头
+  unsigned long samples;
+  int probe = (args.count >= 2) ? findSensorProbe(args.values[0]) : -1;
+  if (!parseUnsignedArg(args, args.count - 1, samples) || (args.count >= 2 && probe < 0)) {
+    Serial.println("✗ 用法: samples [ph|turbidity|conductivity] <1-255>");
+    return;
+  }
+  uint8_t applied = setOversampleCount(probe, samples);
+  Serial.print("✓ 过采样次数已设置为 ");
+  Serial.print(applied);
+  Serial.println(applied != samples ? " (已限幅)" : "");
+}
+
+static void cmdLora(const CommandArgs& args) {
+  bool enable;
+  unsigned long value;
+  if (args.count == 0 || argEquals(args, 0, "status")) {
+    printLoRaStatus();
     
-    if (command == "test") {
-      performWaterQualityTest();
-      
-    } else if (command == "status") {
-      printSimpleSystemStatus();
-      
-    } else if (command == "led") {
-      // 手动更新LED显示
-      readAllSensors();
-      Serial.println("LED状态已更新");
-      
-    } else if (command == "send" && loraConnected) {
-      readAllSensors();
-      if (sendWaterQualityData()) {
-        Serial.println("✓ 数据发送成功");
-      } else {
-        Serial.println("✗ 数据发送失败");
-      }
-      
-    } else if (command == "autosend on") {
-      enableAutoSend(true);
-      
-    } else if (command == "autosend off") {
-      enableAutoSend(false);
-      
-    } else if (command == "lora status") {
-      printLoRaStatus();
-      
-    } else if (command == "help") {
-      Serial.println("\n=== 可用命令 ===");
-      Serial.println("test        - 执行水质检测");
-      Serial.println("status      - 显示系统状态");
-      Serial.println("led         - 手动更新LED显示");
-      if (loraConnected) {
-        Serial.println("send        - 手动发送数据");
-        Serial.println("autosend on - 开启自动发送");
-        Serial.println("autosend off- 关闭自动发送");
-        Serial.println("lora status - 显示LoRa详细状态");
-      }
-      Serial.println("help        - 显示此帮助");
-      Serial.println("===============");
+  } else if (argEquals(args, 0, "drpolicy") && parseOnOffArg(args, 1, enable)) {
+    enableLocalDataRatePolicy(enable);
+    
+  } else if (argEquals(args, 0, "dr") && parseUnsignedArg(args, 1, value)) {
+    // ADR或本地策略开启时，之后仍可能被调整
+    if (value > LORA_MAX_DATA_RATE || !setLoRaDataRate((uint8_t)value, DR_REASON_MANUAL)) {
+      Serial.println("✗ 用法: lora dr <0-5>");
     }
+    
+  } else if (argEquals(args, 0, "rejoin")) {
+    // 丢弃保存的会话，强制重新OTAA入网
+    invalidateLoRaSession();
+    if (reconnectLoRa()) {
+      Serial.println("✓ 重新入网成功");
+    } else {
+      Serial.println("✗ 重新入网失败");
+    }
+    
+  } else {
+    Serial.println("✗ 用法: lora [status | drpolicy on|off | dr <0-5> | rejoin]");
   }
 }
 
+static void cmdHelp(const CommandArgs& args);
+
+static const SerialCommand SERIAL_COMMANDS[] = {
+  SERIAL_COMMAND("test",     cmdTest,     "执行水质检测"),
+  SERIAL_COMMAND("status",   cmdStatus,   "显示系统状态"),
+  SERIAL_COMMAND("led",      cmdLed,      "手动更新LED显示"),
+  SERIAL_COMMAND("tasks",    cmdTasks,    "显示任务调度状态"),
+  SERIAL_COMMAND("perf",     cmdPerf,     "[reset] 显示或清零各阶段耗时统计"),
+  SERIAL_COMMAND("mem",      cmdMem,      "显示RAM/堆/栈使用统计"),
+  SERIAL_COMMAND("trace",    cmdTrace,    "[on|off] 二进制事件追踪输出开关"),
+  SERIAL_COMMAND("log",      cmdLog,      "[模块] [debug|info|warn|error|off] 查看或设置日志级别"),
+  SERIAL_COMMAND("power",    cmdPower,    "显示待机与唤醒统计"),
+  SERIAL_COMMAND("standby",  cmdStandby,  "on|off 低功耗待机开关"),
+  SERIAL_COMMAND("periodic", cmdPeriodic, "[on|off|<分钟>] 定时无人值守采样"),
+  SERIAL_COMMAND("send",     cmdSend,     "手动发送数据"),
+  SERIAL_COMMAND("autosend", cmdAutoSend, "on|off 自动发送开关"),
+  SERIAL_COMMAND("interval", cmdInterval, "<秒> 设置自动发送间隔"),
+  SERIAL_COMMAND("format",   cmdFormat,   "legacy|redundant 切换上行数据格式"),
+  SERIAL_COMMAND("profile",  cmdProfile,  "[名称|id] 查看或切换水质标准配置"),
+  SERIAL_COMMAND("samples",  cmdSamples,  "[探头] [次数] 查看或设置ADC过采样次数"),
+  SERIAL_COMMAND("lora",     cmdLora,     "[status | drpolicy on|off | dr <n> | rejoin] LoRa状态与设置"),
+  SERIAL_COMMAND("help",     cmdHelp,     "显示此帮助"),
+};
+
+static const uint8_t SERIAL_COMMAND_COUNT = sizeof(SERIAL_COMMANDS) / sizeof(SERIAL_COMMANDS[0]);
+
+static void cmdHelp(const CommandArgs&) {
+  printCommandHelp(SERIAL_COMMANDS, SERIAL_COMMAND_COUNT);
+}
+
+// 非阻塞：只处理已经收到的字符，完整的一行才执行
+void handleSimpleSerialCommands() {
+  pollSerialCommands(SERIAL_COMMANDS, SERIAL_COMMAND_COUNT);
+}
+
 // ==================== 简化的系统状态 ====================
 void printSimpleSystemStatus() {
   Serial.println("\n=== 系统状态 ===");
@@ -188,70 +530,73 @@ void printSimpleSystemStatus() {
   }
   
   Serial.print("按钮状态: ");
-  Serial.println(getButtonStatus());
+  uint8_t buttonState = getButtonState();
+  Serial.print(getButtonStateName(buttonState));
+  if (buttonState == BUTTON_STATE_COOLDOWN) {
+    Serial.print(" ");
+    Serial.print(getRemainingCooldown() / 1000);
+    Serial.print("s");
+  }
+  Serial.println();
   
   // 显示当前LED状态
   Serial.print("当前水质LED: ");
-  Serial.println(getWaterQualityStatus());
+  Serial.println(getWaterQualityStatusText());
   
   Serial.println("================");
 }
 
-// ==================== 注释掉的自动发送检查 ====================
-/*
+// ==================== 自动发送检查 ====================
 void checkAutoSend() {
   static unsigned long lastAutoCheck = 0;
   
+  if (!autoSendEnabled) {
+    return;
+  }
+  
   // 每30秒检查一次
   if (millis() - lastAutoCheck > 30000) {
     lastAutoCheck = millis();
     
-    if (loraConnected && shouldSendLoRaData()) {
-      Serial.println("自动发送数据到云端...");
-      readAllSensors();
-      sendWaterQualityData();
+    if (loraConnected && shouldSendLoRaData() && !isAcquisitionActive()) {
+      LOG_PRINTLN(LOG_INF, "自动发送数据到云端...");
+      requestMeasurement(MEAS_REQUEST_UPLOAD);
     }
   }
 }
-*/
 
 // ==================== 其他必需函数 ====================
 void printSystemStatus() {
   printSimpleSystemStatus();
 }
 
-int getFreeMemory() {
-  // 简单的内存检测（Arduino方式）
-  extern int __heap_start, *__brkval;
-  int v;
-  return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
-}
-
 void runDiagnostics() {
   Serial.println("\n=== 系统诊断 ===");
   
   // 传感器诊断
   Serial.println("传感器诊断:");
-  readAllSensors();
+  const Measurement& m = readAllSensors();
   Serial.print("- 温度: ");
-  Serial.print(waterTemperature);
+  Serial.print(m.temperature);
   Serial.println("°C");
   Serial.print("- pH: ");
-  Serial.println(pHValue);
+  Serial.println(m.pH);
   Serial.print("- 浊度: ");
-  Serial.print(turbidityNTU);
+  Serial.print(m.turbidity);
   Serial.println(" NTU");
   Serial.print("- 电导率: ");
-  Serial.print(conductivityValue);
+  Serial.print(m.conductivity);
   Serial.println(" μS/cm");
   Serial.print("- TDS: ");
-  Serial.print(tdsValue);
+  Serial.print(m.tds);
   Serial.println(" ppm");
+  Serial.print("- 有效标志: 0x");
+  Serial.println(m.validMask, HEX);
   
   // LED诊断
   Serial.println("LED诊断:");
   Serial.print("- 当前状态: ");
-  Serial.println(getWaterQualityStatus());
+  Serial.println(getWaterQualityStatusText());
   
   // LoRa诊断
   if (loraInitialized) {
@@ -259,9 +604,7 @@ void runDiagnostics() {
   }
   
   // 内存诊断
-  Serial.print("可用内存: ");
-  Serial.print(getFreeMemory());
-  Serial.println(" 字节");
+  printMemorySummary();
   
   Serial.println("===============");
 }
\ No newline at end of file
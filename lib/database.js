@@ -150,6 +150,30 @@ static async saveReading(data) {
   }
 }
 
+  // 检查某一帧计数的读数是否已保存（用于冗余上行去重）
+  // 重新入网后帧计数从0开始，只在同一会话内比较帧计数；未记录会话的旧数据只与同样无会话的帧比较
+  static async hasReadingForFrame(deviceId, sessionId, fCnt) {
+    const client = await pool.connect()
+    
+    try {
+      const query = `
+        SELECT 1 FROM water_quality_readings 
+        WHERE device_id = $1 AND raw_data->>'f_cnt' = $2
+          AND raw_data->>'session_id' IS NOT DISTINCT FROM $3
+        LIMIT 1
+      `
+      
+      const result = await client.query(query, [deviceId, String(fCnt), sessionId])
+      return result.rows.length > 0
+      
+    } catch (error) {
+      console.error('❌ Error checking frame counter in Neon:', error)
+      return false
+    } finally {
+      client.release()
+    }
+  }
+
   // 获取最新的水质读数
   static async getLatestReading(deviceId = 'water-monitor') {
     const client = await pool.connect()
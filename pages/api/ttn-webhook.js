@@ -1,6 +1,7 @@
 // pages/api/ttn-webhook.js - TTN Webhook接收器
 
 import WaterQualityDB from '../../lib/database'
+import { DEFAULT_PROFILE, gradeWaterQuality } from '../../utils/waterQualityRules.generated'
 
 export default async function handler(req, res) {
   console.log('🎯 TTN Webhook received request')
@@ -33,6 +34,9 @@ export default async function handler(req, res) {
     // 提取设备信息
     const deviceId = data.end_device_ids?.device_id || 'water-monitor'
     const receivedAt = data.received_at || new Date().toISOString()
+    const fCnt = data.uplink_message?.f_cnt
+    // 每次入网会话不同（帧计数随之归零），没有会话密钥 id 时退回到 DevAddr
+    const sessionId = data.uplink_message?.session_key_id || data.end_device_ids?.dev_addr || null
 
     // 提取解码后的传感器数据
     const payload = data.uplink_message?.decoded_payload
@@ -58,10 +62,17 @@ export default async function handler(req, res) {
       tds: parseFloat(payload.tds) || 0
     }
 
-    // 评估水质状态
-    const status = evaluateWaterQuality(waterData)
+    // 评估水质状态：按设备当时使用的监管配置解释读数（旧固件不带配置 id）
+    const profile = Number.isInteger(payload.profile) ? payload.profile : DEFAULT_PROFILE
+    const status = evaluateWaterQuality(waterData, profile)
     waterData.status = status
 
+    // 探头在超时前未稳定的读数照常保存，但在原始数据中标记（旧解码器没有该字段）
+    const settled = payload.settled !== false
+    if (!settled) {
+      console.warn('⚠️ Reading taken before the probes settled')
+    }
+
     console.log('📊 Processed water data:', waterData)
 
     // 保存到Neon数据库
@@ -81,12 +92,18 @@ export default async function handler(req, res) {
           source: 'ttn_webhook',
           original_payload: payload,
           device_info: data.end_device_ids,
-          received_at: receivedAt
+          received_at: receivedAt,
+          f_cnt: fCnt,
+          session_id: sessionId,
+          settled
         }
       })
 
       console.log('✅ Data saved to Neon database:', savedRecord.id)
 
+      // 冗余上行：补齐之前丢失的帧
+      const recovered = await saveRecoveredReadings(deviceId, sessionId, fCnt, receivedAt, payload.history, profile)
+
       // 返回成功响应给TTN
       return res.status(200).json({
         success: true,
@@ -96,7 +113,8 @@ export default async function handler(req, res) {
           device_id: deviceId,
           status: waterData.status,
           timestamp: receivedAt,
-          saved_data: waterData
+          saved_data: waterData,
+          recovered_records: recovered
         }
       })
 
@@ -119,27 +137,49 @@ export default async function handler(req, res) {
   }
 }
 
-// 简单的水质评估函数
-function evaluateWaterQuality({ ph, turbidity, tds, conductivity }) {
-  let issues = 0
-
-  // pH检查 (6.5-8.0 优秀, 6.0-9.0 可接受)
-  if (ph < 6.0 || ph > 9.0) issues += 2
-  else if (ph < 6.5 || ph > 8.0) issues += 1
-
-  // 浊度检查 (≤1.0 优秀, ≤4.0 可接受)
-  if (turbidity > 4.0) issues += 2
-  else if (turbidity > 1.0) issues += 1
-
-  // TDS检查 (80-300 优秀, 50-500 可接受)
-  if (tds < 50 || tds > 500) issues += 2
-  else if (tds < 80 || tds > 300) issues += 1
+// 保存冗余上行中附带的、之前未收到的读数
+async function saveRecoveredReadings(deviceId, sessionId, fCnt, receivedAt, history, profile) {
+  if (!Array.isArray(history) || typeof fCnt !== 'number') return 0
+
+  let recovered = 0
+  for (const record of history) {
+    // 帧计数差为0表示设备不知道该读数的帧计数，无法去重
+    if (!record.f_cnt_delta) continue
+
+    // 差值超过当前帧计数说明该读数属于上一次入网会话，无法确定帧号
+    const recordFCnt = fCnt - record.f_cnt_delta
+    if (recordFCnt < 0) continue
+    if (await WaterQualityDB.hasReadingForFrame(deviceId, sessionId, recordFCnt)) continue
+
+    const recordData = {
+      temperature: parseFloat(record.temperature) || 0,
+      ph: parseFloat(record.ph) || 0,
+      turbidity: parseFloat(record.turbidity) || 0,
+      conductivity: parseFloat(record.conductivity) || 0,
+      tds: parseFloat(record.tds) || 0
+    }
 
-  // 电导率检查 (100-400 优秀, 50-800 可接受)
-  if (conductivity < 50 || conductivity > 800) issues += 2
-  else if (conductivity < 100 || conductivity > 400) issues += 1
+    await WaterQualityDB.saveReading({
+      device_id: deviceId,
+      ...recordData,
+      status: evaluateWaterQuality(recordData, profile),
+      // 丢失帧的真实时间未知，使用补齐时的接收时间
+      recorded_at: new Date(receivedAt),
+      raw_data: {
+        source: 'ttn_webhook_recovered',
+        original_payload: record,
+        received_at: receivedAt,
+        f_cnt: recordFCnt,
+        session_id: sessionId
+      }
+    })
+    console.log('♻️ Recovered lost reading for frame', recordFCnt)
+    recovered++
+  }
+  return recovered
+}
 
-  if (issues >= 3) return 'UNSAFE'
-  else if (issues >= 1) return 'MARGINAL'
-  else return 'EXCELLENT'
-}
\ No newline at end of file
+// 水质评估：与设备使用同一张规则表（Arduino/water/WaterQualityRules.h 生成）
+function evaluateWaterQuality({ ph, turbidity, tds, conductivity }, profile) {
+  return gradeWaterQuality({ ph, turbidity, tds, conductivity }, profile)
+}
@@ -0,0 +1,76 @@
+// utils/waterQualityRules.generated.js - 水质分级规则（自动生成，请勿手动修改）
+//
+// 来源: Arduino/water/WaterQualityRules.h
+// 重新生成: build-host/water_rulegen --out utils/waterQualityRules.generated.js
+
+export const GRADES = ['UNKNOWN', 'EXCELLENT', 'MARGINAL', 'UNSAFE']
+
+export const DEFAULT_PROFILE = 0
+
+// 监管配置，下标即上行数据中的配置 id
+// 闭区间 [min, max]；severity 是该参数最多能把总体等级拉低到的等级
+export const WATER_QUALITY_PROFILES = [
+  {
+    id: 0,
+    name: 'drinking',
+    rules: {
+      ph: { unit: '', excellentMin: 6.5, excellentMax: 8, acceptableMin: 6, acceptableMax: 9, severity: 'UNSAFE' },
+      turbidity: { unit: 'NTU', excellentMin: 0, excellentMax: 1, acceptableMin: 0, acceptableMax: 4, severity: 'UNSAFE' },
+      tds: { unit: 'ppm', excellentMin: 80, excellentMax: 300, acceptableMin: 50, acceptableMax: 500, severity: 'UNSAFE' },
+      conductivity: { unit: 'µS/cm', excellentMin: 100, excellentMax: 400, acceptableMin: 50, acceptableMax: 800, severity: 'UNSAFE' }
+    }
+  },
+  {
+    id: 1,
+    name: 'bottled',
+    rules: {
+      ph: { unit: '', excellentMin: 6.5, excellentMax: 8, acceptableMin: 6, acceptableMax: 8.5, severity: 'UNSAFE' },
+      turbidity: { unit: 'NTU', excellentMin: 0, excellentMax: 0.5, acceptableMin: 0, acceptableMax: 1, severity: 'UNSAFE' },
+      tds: { unit: 'ppm', excellentMin: 50, excellentMax: 250, acceptableMin: 10, acceptableMax: 500, severity: 'UNSAFE' },
+      conductivity: { unit: 'µS/cm', excellentMin: 50, excellentMax: 400, acceptableMin: 10, acceptableMax: 800, severity: 'UNSAFE' }
+    }
+  },
+  {
+    id: 2,
+    name: 'recreational',
+    rules: {
+      ph: { unit: '', excellentMin: 7.2, excellentMax: 7.8, acceptableMin: 6.5, acceptableMax: 8.5, severity: 'UNSAFE' },
+      turbidity: { unit: 'NTU', excellentMin: 0, excellentMax: 1, acceptableMin: 0, acceptableMax: 5, severity: 'UNSAFE' },
+      tds: { unit: 'ppm', excellentMin: 0, excellentMax: 1000, acceptableMin: 0, acceptableMax: 2000, severity: 'MARGINAL' },
+      conductivity: { unit: 'µS/cm', excellentMin: 0, excellentMax: 1500, acceptableMin: 0, acceptableMax: 3000, severity: 'MARGINAL' }
+    }
+  },
+  {
+    id: 3,
+    name: 'inhouse',
+    rules: {
+      ph: { unit: '', excellentMin: 6.8, excellentMax: 7.8, acceptableMin: 6.5, acceptableMax: 8.5, severity: 'UNSAFE' },
+      turbidity: { unit: 'NTU', excellentMin: 0, excellentMax: 0.3, acceptableMin: 0, acceptableMax: 1, severity: 'UNSAFE' },
+      tds: { unit: 'ppm', excellentMin: 100, excellentMax: 250, acceptableMin: 80, acceptableMax: 300, severity: 'UNSAFE' },
+      conductivity: { unit: 'µS/cm', excellentMin: 150, excellentMax: 400, acceptableMin: 100, acceptableMax: 500, severity: 'UNSAFE' }
+    }
+  }
+]
+
+export const WATER_QUALITY_RULES = WATER_QUALITY_PROFILES[DEFAULT_PROFILE].rules
+
+// 单参数分级；非数值按超出可接受范围处理（与固件对 NaN 的处理相同）
+export const gradeParameter = (param, value, profile = DEFAULT_PROFILE) => {
+  const rule = WATER_QUALITY_PROFILES[profile]?.rules[param]
+  if (!rule) return 'UNKNOWN'
+  const valid = typeof value === 'number' && !Number.isNaN(value)
+  const excellent = valid && value >= rule.excellentMin && value <= rule.excellentMax
+  const acceptable = valid && value >= rule.acceptableMin && value <= rule.acceptableMax
+  const grade = 1 + (excellent ? 0 : 1) + (acceptable ? 0 : 1)
+  return GRADES[Math.min(grade, GRADES.indexOf(rule.severity))]
+}
+
+// 总体等级取各参数中最差的一个，values 以规则名为键；未知配置返回 UNKNOWN
+export const gradeWaterQuality = (values, profile = DEFAULT_PROFILE) => {
+  if (!WATER_QUALITY_PROFILES[profile]) return 'UNKNOWN'
+  let worst = 1
+  for (const param of Object.keys(WATER_QUALITY_PROFILES[profile].rules)) {
+    worst = Math.max(worst, GRADES.indexOf(gradeParameter(param, values[param], profile)))
+  }
+  return GRADES[worst]
+}
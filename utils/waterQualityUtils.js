@@ -1,5 +1,7 @@
 // utils/waterQualityUtils.js - 改进的水质评估工具函数
 
+import { WATER_QUALITY_RULES, gradeParameter, gradeWaterQuality } from './waterQualityRules.generated'
+
 // 获取水质状态总体描述
 export const getWaterQualityDescription = (status) => {
   switch(status) {
@@ -15,34 +17,15 @@ export const getWaterQualityDescription = (status) => {
 }
 
 // 根据水质评价标准检查个别参数状态
+// pH、浊度、TDS、电导率使用固件的规则表（waterQualityRules.generated.js），与设备分级一致
 export const getParameterStatus = (param, value) => {
+  if (WATER_QUALITY_RULES[param]) {
+    return gradeParameter(param, value).toLowerCase()
+  }
+
   switch(param) {
-    case 'ph':
-      // pH值标准：🟢 6.5-8.0, 🟡 6.0-6.4或8.1-9.0, 🔴 <6.0或>9.0
-      if (value >= 6.5 && value <= 8.0) return 'excellent'
-      if ((value >= 6.0 && value < 6.5) || (value > 8.0 && value <= 9.0)) return 'marginal'
-      return 'unsafe'
-      
-    case 'turbidity':
-      // 浊度标准：🟢 0-1.0 NTU, 🟡 1.1-4.0 NTU, 🔴 >4.0 NTU
-      if (value >= 0 && value <= 1.0) return 'excellent'
-      if (value > 1.0 && value <= 4.0) return 'marginal'
-      return 'unsafe'
-      
-    case 'tds':
-      // TDS标准：🟢 80-300 ppm, 🟡 300-500或50-79 ppm, 🔴 >500或<50 ppm
-      if (value >= 80 && value <= 300) return 'excellent'
-      if ((value >= 50 && value < 80) || (value > 300 && value <= 500)) return 'marginal'
-      return 'unsafe'
-      
-    case 'conductivity':
-      // 电导率标准：🟢 100-400 μS/cm, 🟡 400-800 μS/cm, 🔴 >800或<50 μS/cm
-      if (value >= 100 && value <= 400) return 'excellent'
-      if (value > 400 && value <= 800) return 'marginal'
-      return 'unsafe'
-      
     case 'temperature':
-      // 温度参考范围（基本检查）
+      // 温度参考范围（基本检查，仅仪表盘使用，设备不按温度分级）
       if (value >= 5 && value <= 25) return 'excellent'
       if (value >= 0 && value <= 35) return 'marginal'
       return 'unsafe'
@@ -82,12 +65,28 @@ export const getParameterDescription = (param, value, status) => {
 }
 
 // 获取参考范围（显示在卡片中，保留科普价值，分三行显示）
+// 个位数保留一位小数（6.5-8.0），其余按原样显示
+const formatLimit = (value) => (Math.abs(value) < 10 ? value.toFixed(1) : String(value))
+
+const formatReference = (rule) => {
+  const suffix = rule.unit ? ` ${rule.unit}` : ''
+  const [excellentMin, excellentMax, acceptableMin, acceptableMax] =
+    [rule.excellentMin, rule.excellentMax, rule.acceptableMin, rule.acceptableMax].map(formatLimit)
+  const marginal = []
+  if (rule.acceptableMin < rule.excellentMin) marginal.push(`${acceptableMin}-${excellentMin}`)
+  if (rule.excellentMax < rule.acceptableMax) marginal.push(`${excellentMax}-${acceptableMax}`)
+  const unsafe = []
+  if (rule.acceptableMin > 0) unsafe.push(`<${acceptableMin}`)
+  unsafe.push(`>${acceptableMax}`)
+  return `🟢 ${excellentMin}-${excellentMax}${suffix}\n🟡 ${marginal.join(', ')}${suffix}\n🔴 ${unsafe.join(', ')}${suffix}`
+}
+
 export const getParameterReference = (param) => {
+  if (WATER_QUALITY_RULES[param]) {
+    return formatReference(WATER_QUALITY_RULES[param])
+  }
+
   const references = {
-    ph: '🟢 6.5-8.0\n🟡 6.0-6.4, 8.1-9.0\n🔴 <6.0, >9.0',
-    turbidity: '🟢 0-1.0 NTU\n🟡 1.1-4.0 NTU\n🔴 >4.0 NTU',
-    tds: '🟢 80-300 ppm\n🟡 50-79, 300-500 ppm\n🔴 <50, >500 ppm',
-    conductivity: '🟢 100-400 μS/cm\n🟡 50-99, 400-800 μS/cm\n🔴 <50, >800 μS/cm',
     temperature: '🟢 5-25°C\n🟡 0-35°C\n🔴 <0, >35°C'
   }
   
@@ -106,29 +105,9 @@ export const getParameterTooltip = (param) => {
   return tooltips[param] || "This parameter indicates water quality."
 }
 
-// 综合水质状态评估
+// 综合水质状态评估（任一参数不安全即为不安全，与设备一致）
 export const evaluateOverallWaterQuality = (ph, turbidity, tds, conductivity) => {
-  let issues = 0
-
-  // pH检查
-  if (ph < 6.0 || ph > 9.0) issues += 2
-  else if (ph < 6.5 || ph > 8.0) issues += 1
-
-  // 浊度检查
-  if (turbidity > 4.0) issues += 2
-  else if (turbidity > 1.0) issues += 1
-
-  // TDS检查
-  if (tds < 50 || tds > 500) issues += 2
-  else if (tds < 80 || tds > 300) issues += 1
-
-  // 电导率检查
-  if (conductivity < 50 || conductivity > 800) issues += 2
-  else if (conductivity < 100 || conductivity > 400) issues += 1
-
-  if (issues >= 3) return 'UNSAFE'
-  else if (issues >= 1) return 'MARGINAL'
-  else return 'EXCELLENT'
+  return gradeWaterQuality({ ph, turbidity, tds, conductivity })
 }
 
 // ==================== 时间和日期格式化函数 ==================== 